@@ -0,0 +1,74 @@
+#include <javm/javm_VM.hpp>
+#include <javm/rt/rt_JavaArchiveSource.hpp>
+#include <javm/extras/extras_PthreadThread.hpp>
+#include <javm/extras/extras_CppSync.hpp>
+#include <javm/extras/extras_DlfcnLibrary.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace javm;
+
+// Measures what the cycle collector adds to every allocation: registering it in the heap (see RegisterHeapObject), plus the collections it triggers
+// Registered allocations are the ones the VM makes (NEW, NEWARRAY...), unregistered ones are plain reference-counted objects, like before the collector
+
+using Clock = std::chrono::steady_clock;
+
+// Kept alive objects, so that collections have a populated heap to go through
+constexpr size_t RetainedCount = 0x10000;
+
+template<typename Fn>
+double MeasureNsPerAllocation(const u32 iterations, const bool retain, Fn alloc_fn) {
+    std::vector<Ptr<vm::Variable>> retained(retain ? RetainedCount : 0);
+    const auto start = Clock::now();
+    for(u32 i = 0; i < iterations; i++) {
+        auto var = alloc_fn();
+        if(retain) {
+            retained[i % RetainedCount] = var;
+        }
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+}
+
+void BenchAllocation(const char *name, const u32 iterations, const bool retain, Ptr<vm::ClassType> obj_type) {
+    const auto unregistered_ns = MeasureNsPerAllocation(iterations, retain, [&]() {
+        return ptr::New<vm::Variable>(ptr::New<vm::type::ClassInstance>(obj_type));
+    });
+    const auto registered_ns = MeasureNsPerAllocation(iterations, retain, [&]() {
+        return vm::NewClassVariable(obj_type);
+    });
+    const auto unregistered_arr_ns = MeasureNsPerAllocation(iterations, retain, [&]() {
+        return ptr::New<vm::Variable>(ptr::New<vm::type::Array>(obj_type, 4));
+    });
+    const auto registered_arr_ns = MeasureNsPerAllocation(iterations, retain, [&]() {
+        return vm::NewArrayVariable(4, obj_type);
+    });
+
+    printf("%s:\n", name);
+    printf("  Object:    %7.1f ns unregistered, %7.1f ns registered (+%.1f%%)\n", unregistered_ns, registered_ns, (registered_ns / unregistered_ns - 1.0) * 100.0);
+    printf("  Object[4]: %7.1f ns unregistered, %7.1f ns registered (+%.1f%%)\n", unregistered_arr_ns, registered_arr_ns, (registered_arr_ns / unregistered_arr_ns - 1.0) * 100.0);
+}
+
+int main(int argc, char **argv) {
+    if(argc < 2) {
+        printf("Expected usage: heap-bench <rt-jar-path> [<iterations>]\n");
+        return 0;
+    }
+    const u32 iterations = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+
+    rt::CreateAddClassSource<rt::JavaArchiveSource>(argv[1]);
+    rt::InitializeVM({});
+
+    auto obj_type = rt::LocateClassType(u"java/lang/Object");
+    if(!obj_type) {
+        printf("Unable to find java.lang.Object...\n");
+        return 0;
+    }
+
+    printf("Allocation cost (%u iterations)\n", iterations);
+    BenchAllocation("Short-lived", iterations, false, obj_type);
+    BenchAllocation("Retained", iterations, true, obj_type);
+
+    auto &heap = rt::GetCurrentInstance().heap;
+    printf("Collections: %lu\n", static_cast<unsigned long>(heap.GetCollectionCount()));
+    return 0;
+}
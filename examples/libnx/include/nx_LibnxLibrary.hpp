@@ -0,0 +1,20 @@
+#pragma once
+#include <javm/native/native_NativeLibrary.hpp>
+
+// Native library implementation - dynamic libraries aren't available, so JNI libraries are never found
+
+namespace javm::native {
+
+    String MapLibraryName(const String &name) {
+        return u"lib" + name + u".nro";
+    }
+
+    LibraryHandle OpenLibrary(const String &path) {
+        return nullptr;
+    }
+
+    void *FindLibrarySymbol(LibraryHandle handle, const std::string &symbol_name) {
+        return nullptr;
+    }
+
+}
@@ -2,6 +2,7 @@
 #pragma once
 #include <javm/native/native_NativeSync.hpp>
 #include <switch.h>
+#include <ctime>
 
 // Sync implementation
 
@@ -61,6 +62,49 @@ namespace nx {
             }
     };
 
+    class LibnxParker : public native::Parker {
+        private:
+            Mutex nx_mutex;
+            CondVar nx_cv;
+            bool permit;
+
+        public:
+            LibnxParker() : permit(false) {
+                mutexInit(&this->nx_mutex);
+                condvarInit(&this->nx_cv);
+            }
+
+            virtual void Park(const bool is_absolute, const vm::type::Long time) override {
+                mutexLock(&this->nx_mutex);
+                if(!this->permit) {
+                    if(is_absolute) {
+                        struct timespec now = {};
+                        clock_gettime(CLOCK_REALTIME, &now);
+                        const auto now_ns = static_cast<s64>(now.tv_sec) * 1000000000 + now.tv_nsec;
+                        const auto remaining_ns = time * 1000000 - now_ns;
+                        if(remaining_ns > 0) {
+                            condvarWaitTimeout(&this->nx_cv, &this->nx_mutex, remaining_ns);
+                        }
+                    }
+                    else if(time > 0) {
+                        condvarWaitTimeout(&this->nx_cv, &this->nx_mutex, time);
+                    }
+                    else {
+                        condvarWait(&this->nx_cv, &this->nx_mutex);
+                    }
+                }
+                this->permit = false;
+                mutexUnlock(&this->nx_mutex);
+            }
+
+            virtual void Unpark() override {
+                mutexLock(&this->nx_mutex);
+                this->permit = true;
+                condvarWakeOne(&this->nx_cv);
+                mutexUnlock(&this->nx_mutex);
+            }
+    };
+
 }
 
 namespace javm::native {
@@ -73,4 +117,8 @@ namespace javm::native {
         return ptr::New<nx::LibnxConditionVariable>();
     }
 
-}
\ No newline at end of file
+    Ptr<Parker> CreateParker() {
+        return ptr::New<nx::LibnxParker>();
+    }
+
+}
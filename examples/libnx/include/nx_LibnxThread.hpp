@@ -53,6 +53,14 @@ namespace nx {
                 const auto rc = svcGetThreadPriority(&tmp_prio, this->thread.handle);
                 return R_SUCCEEDED(rc);
             }
+
+            virtual void Join() override {
+                if(existing) {
+                    return;
+                }
+                R_TRY(threadWaitForExit(&this->thread));
+                R_TRY(threadClose(&this->thread));
+            }
     };
 
 }
@@ -63,6 +71,10 @@ namespace javm::native {
         return static_cast<ThreadHandle>(threadGetCurHandle());
     }
 
+    void YieldCurrentThread() {
+        svcSleepThread(YieldType_ToAnyThread);
+    }
+
     Ptr<Thread> CreateThread() {
         return ptr::New<nx::LibnxThread>();
     }
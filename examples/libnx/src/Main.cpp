@@ -11,6 +11,9 @@ using namespace javm;
 #include <nx_LibnxThread.hpp>
 #include <nx_LibnxSync.hpp>
 
+// No dynamic libraries on libnx, so no JNI libraries either
+#include <nx_LibnxLibrary.hpp>
+
 PadState g_hid_pad;
 
 void DoExit()  {
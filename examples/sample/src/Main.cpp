@@ -12,6 +12,9 @@ using namespace javm;
 // Use default sync implementation (std C++)
 #include <javm/extras/extras_CppSync.hpp>
 
+// Use default native library implementation (dlopen), for JNI libraries
+#include <javm/extras/extras_DlfcnLibrary.hpp>
+
 void CheckHandleException(const vm::ExecutionResult res) {
     if(res.Is<vm::ExecutionStatus::Thrown>()) {
         // After retrieving the thrown throwable (the thread is less relevant), the "thrown" state in the VM gets reset so executions are available again
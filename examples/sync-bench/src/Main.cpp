@@ -0,0 +1,107 @@
+#include <javm/javm_VM.hpp>
+#include <thread>
+#include <chrono>
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+using namespace javm;
+
+// Compare sync implementations under contention (see Makefile, one binary per implementation)
+
+#if defined(SYNC_BENCH_FUTEX)
+#include <javm/extras/extras_FutexSync.hpp>
+constexpr auto ImplName = "futex";
+#else
+#include <javm/extras/extras_CppSync.hpp>
+constexpr auto ImplName = "std C++";
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Fn>
+double MeasureThreads(const u32 thread_count, Fn fn) {
+    std::vector<std::thread> threads;
+    const auto start = Clock::now();
+    for(u32 i = 0; i < thread_count; i++) {
+        threads.emplace_back(fn, i);
+    }
+    for(auto &thread: threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Every thread increments a counter inside a synchronized block on the same object
+double BenchContendedLock(const u32 thread_count, const u32 iterations) {
+    vm::ObjectLock obj_lock;
+    u64 counter = 0;
+    const auto ms = MeasureThreads(thread_count, [&](const u32) {
+        for(u32 i = 0; i < iterations; i++) {
+            obj_lock.Enter();
+            counter++;
+            obj_lock.Leave();
+        }
+    });
+    if(counter != static_cast<u64>(thread_count) * iterations) {
+        printf("Contended lock: invalid counter value!\n");
+        exit(1);
+    }
+    return ms;
+}
+
+// Bounded queue where producers and consumers use wait()/notifyAll(), like typical Java producer-consumer code
+double BenchProducerConsumer(const u32 pair_count, const u32 items) {
+    constexpr size_t Capacity = 16;
+    vm::ObjectLock obj_lock;
+    std::deque<u32> queue;
+    u64 consumed = 0;
+    const auto ms = MeasureThreads(pair_count * 2, [&](const u32 idx) {
+        const bool is_producer = (idx % 2) == 0;
+        for(u32 i = 0; i < items; i++) {
+            obj_lock.Enter();
+            if(is_producer) {
+                while(queue.size() >= Capacity) {
+                    obj_lock.Wait(0);
+                }
+                queue.push_back(i);
+            }
+            else {
+                while(queue.empty()) {
+                    obj_lock.Wait(0);
+                }
+                queue.pop_front();
+                consumed++;
+            }
+            obj_lock.NotifyAll();
+            obj_lock.Leave();
+        }
+    });
+    if(consumed != static_cast<u64>(pair_count) * items) {
+        printf("Producer-consumer: invalid consumed count!\n");
+        exit(1);
+    }
+    return ms;
+}
+
+// Plain native monitor, as used for the VM's internal locks
+double BenchNativeMonitor(const u32 thread_count, const u32 iterations) {
+    vm::Monitor monitor;
+    u64 counter = 0;
+    return MeasureThreads(thread_count, [&](const u32) {
+        for(u32 i = 0; i < iterations; i++) {
+            vm::ScopedMonitorLock lk(monitor);
+            counter++;
+        }
+    });
+}
+
+int main(int argc, char **argv) {
+    const u32 thread_count = (argc > 1) ? std::atoi(argv[1]) : std::thread::hardware_concurrency();
+    const u32 iterations = (argc > 2) ? std::atoi(argv[2]) : 200000;
+
+    printf("Sync implementation: %s (%u threads, %u iterations)\n", ImplName, thread_count, iterations);
+    printf("Contended object lock: %.2f ms\n", BenchContendedLock(thread_count, iterations));
+    printf("Native monitor:        %.2f ms\n", BenchNativeMonitor(thread_count, iterations));
+    printf("Producer-consumer:     %.2f ms\n", BenchProducerConsumer((thread_count + 1) / 2, iterations / 4));
+    return 0;
+}
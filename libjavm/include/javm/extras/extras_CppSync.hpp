@@ -3,6 +3,8 @@
 #include <javm/native/native_NativeSync.hpp>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <chrono>
 
 // Sync implementation - standard C++
 
@@ -54,6 +56,49 @@ namespace javm::extras {
             }
     };
 
+    class CppParker : public native::Parker {
+        private:
+            std::mutex cpp_mutex;
+            std::condition_variable cpp_cv;
+            std::atomic<bool> permit;
+
+        public:
+            CppParker() : permit(false) {}
+
+            virtual void Park(const bool is_absolute, const vm::type::Long time) override {
+                // Fast path: the permit is already there
+                if(this->permit.exchange(false, std::memory_order_acquire)) {
+                    return;
+                }
+                if(is_absolute && (time <= 0)) {
+                    return;
+                }
+
+                std::unique_lock<std::mutex> lk(this->cpp_mutex);
+                if(!this->permit.load(std::memory_order_relaxed)) {
+                    if(is_absolute) {
+                        const auto deadline = std::chrono::system_clock::time_point(std::chrono::milliseconds(time));
+                        this->cpp_cv.wait_until(lk, deadline);
+                    }
+                    else if(time > 0) {
+                        this->cpp_cv.wait_for(lk, std::chrono::nanoseconds(time));
+                    }
+                    else {
+                        this->cpp_cv.wait(lk);
+                    }
+                }
+                this->permit.store(false, std::memory_order_relaxed);
+            }
+
+            virtual void Unpark() override {
+                {
+                    std::lock_guard<std::mutex> lk(this->cpp_mutex);
+                    this->permit.store(true, std::memory_order_release);
+                }
+                this->cpp_cv.notify_one();
+            }
+    };
+
 }
 
 namespace javm::native {
@@ -66,4 +111,8 @@ namespace javm::native {
         return ptr::New<extras::CppConditionVariable>();
     }
 
-}
\ No newline at end of file
+    Ptr<Parker> CreateParker() {
+        return ptr::New<extras::CppParker>();
+    }
+
+}
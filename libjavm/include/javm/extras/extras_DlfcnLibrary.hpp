@@ -0,0 +1,25 @@
+#pragma once
+#include <javm/native/native_NativeLibrary.hpp>
+#include <dlfcn.h>
+
+// Native library implementation - dlfcn
+
+namespace javm::native {
+
+    String MapLibraryName(const String &name) {
+        #ifdef __APPLE__
+        return u"lib" + name + u".dylib";
+        #else
+        return u"lib" + name + u".so";
+        #endif
+    }
+
+    LibraryHandle OpenLibrary(const String &path) {
+        return dlopen(str::ToUtf8(path).c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+
+    void *FindLibrarySymbol(LibraryHandle handle, const std::string &symbol_name) {
+        return dlsym(handle, symbol_name.c_str());
+    }
+
+}
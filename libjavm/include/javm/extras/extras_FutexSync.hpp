@@ -0,0 +1,254 @@
+#pragma once
+#include <javm/native/native_NativeSync.hpp>
+#include <atomic>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Sync implementation - Linux futexes
+
+namespace javm::extras {
+
+    namespace futex {
+
+        inline long Wait(std::atomic<u32> &word, const u32 expected, const struct timespec *timeout = nullptr) {
+            return syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+        }
+
+        inline long WaitUntilRealtime(std::atomic<u32> &word, const u32 expected, const struct timespec *deadline) {
+            return syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAIT_BITSET_PRIVATE | FUTEX_CLOCK_REALTIME, expected, deadline, nullptr, FUTEX_BITSET_MATCH_ANY);
+        }
+
+        inline long Wake(std::atomic<u32> &word, const int count) {
+            return syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        }
+
+        inline long Requeue(std::atomic<u32> &word, const int wake_count, std::atomic<u32> &target_word, const u32 expected) {
+            return syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_CMP_REQUEUE_PRIVATE, wake_count, reinterpret_cast<void*>(static_cast<uintptr_t>(INT_MAX)), reinterpret_cast<u32*>(&target_word), expected);
+        }
+
+        inline u32 GetCurrentThreadId() {
+            static thread_local u32 cur_tid = 0;
+            if(cur_tid == 0) {
+                cur_tid = static_cast<u32>(syscall(SYS_gettid));
+            }
+            return cur_tid;
+        }
+
+    }
+
+    class FutexRecursiveMutex : public native::RecursiveMutex {
+        private:
+            // 0: unlocked, 1: locked, 2: locked and maybe contended
+            std::atomic<u32> state;
+            std::atomic<u32> owner_tid;
+            u32 recursion_count;
+
+            inline void LockContended() {
+                auto cur_state = this->state.exchange(2, std::memory_order_acquire);
+                while(cur_state != 0) {
+                    futex::Wait(this->state, 2);
+                    cur_state = this->state.exchange(2, std::memory_order_acquire);
+                }
+            }
+
+            inline void LockSlow() {
+                u32 expected = 0;
+                if(!this->state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    this->LockContended();
+                }
+            }
+
+            inline void UnlockSlow() {
+                if(this->state.exchange(0, std::memory_order_release) == 2) {
+                    futex::Wake(this->state, 1);
+                }
+            }
+
+        public:
+            FutexRecursiveMutex() : state(0), owner_tid(0), recursion_count(0) {}
+
+            virtual void Lock() override {
+                const auto self_tid = futex::GetCurrentThreadId();
+                if(this->owner_tid.load(std::memory_order_relaxed) == self_tid) {
+                    this->recursion_count++;
+                    return;
+                }
+                this->LockSlow();
+                this->owner_tid.store(self_tid, std::memory_order_relaxed);
+                this->recursion_count = 1;
+            }
+
+            virtual bool TryLock() override {
+                const auto self_tid = futex::GetCurrentThreadId();
+                if(this->owner_tid.load(std::memory_order_relaxed) == self_tid) {
+                    this->recursion_count++;
+                    return true;
+                }
+                u32 expected = 0;
+                if(!this->state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return false;
+                }
+                this->owner_tid.store(self_tid, std::memory_order_relaxed);
+                this->recursion_count = 1;
+                return true;
+            }
+
+            virtual void Unlock() override {
+                this->recursion_count--;
+                if(this->recursion_count == 0) {
+                    this->owner_tid.store(0, std::memory_order_relaxed);
+                    this->UnlockSlow();
+                }
+            }
+
+            // Used by the condition variable: fully release the lock and return the recursion count to restore
+
+            inline u32 ReleaseForWait() {
+                const auto saved_count = this->recursion_count;
+                this->recursion_count = 0;
+                this->owner_tid.store(0, std::memory_order_relaxed);
+                this->UnlockSlow();
+                return saved_count;
+            }
+
+            inline void ReacquireAfterWait(const u32 saved_count) {
+                // Requeued waiters sleep on the state word, so always mark it as contended
+                this->LockContended();
+                this->owner_tid.store(futex::GetCurrentThreadId(), std::memory_order_relaxed);
+                this->recursion_count = saved_count;
+            }
+
+            inline std::atomic<u32> &GetStateWord() {
+                return this->state;
+            }
+    };
+
+    class FutexConditionVariable : public native::ConditionVariable {
+        private:
+            std::atomic<u32> sequence;
+            std::atomic<u32> waiter_count;
+            std::atomic<FutexRecursiveMutex*> waiting_mutex;
+
+            inline void DoWait(Ptr<native::RecursiveMutex> &lock, const struct timespec *timeout) {
+                // Every lock passed here was created by CreateRecursiveMutex() below, so no need for a dynamic cast
+                auto futex_lock = static_cast<FutexRecursiveMutex*>(lock.get());
+                this->waiting_mutex.store(futex_lock, std::memory_order_relaxed);
+                const auto cur_seq = this->sequence.load(std::memory_order_relaxed);
+                this->waiter_count.fetch_add(1, std::memory_order_relaxed);
+                const auto saved_count = futex_lock->ReleaseForWait();
+                futex::Wait(this->sequence, cur_seq, timeout);
+                futex_lock->ReacquireAfterWait(saved_count);
+                this->waiter_count.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+        public:
+            FutexConditionVariable() : sequence(0), waiter_count(0), waiting_mutex(nullptr) {}
+
+            virtual void Wait(Ptr<native::RecursiveMutex> lock) override {
+                this->DoWait(lock, nullptr);
+            }
+
+            virtual void WaitFor(Ptr<native::RecursiveMutex> lock, const vm::type::Long ms) override {
+                const struct timespec timeout = {
+                    .tv_sec = static_cast<time_t>(ms / 1000),
+                    .tv_nsec = static_cast<long>((ms % 1000) * 1000000)
+                };
+                this->DoWait(lock, &timeout);
+            }
+
+            // Waiters register themselves while holding the mutex, so (as long as notifiers hold it too) no syscall is needed when nobody is waiting
+
+            virtual void Notify() override {
+                this->sequence.fetch_add(1, std::memory_order_relaxed);
+                if(this->waiter_count.load(std::memory_order_relaxed) > 0) {
+                    futex::Wake(this->sequence, 1);
+                }
+            }
+
+            virtual void NotifyAll() override {
+                if(this->waiter_count.load(std::memory_order_relaxed) == 0) {
+                    this->sequence.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                const auto new_seq = this->sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+                auto futex_lock = this->waiting_mutex.load(std::memory_order_relaxed);
+                if(futex_lock == nullptr) {
+                    return;
+                }
+
+                // Wake a single waiter and move the rest to the mutex word, instead of waking them all just to fight over the lock
+                if(futex::Requeue(this->sequence, 1, futex_lock->GetStateWord(), new_seq) < 0) {
+                    futex::Wake(this->sequence, INT_MAX);
+                }
+            }
+    };
+
+    class FutexParker : public native::Parker {
+        private:
+            static constexpr u32 StateEmpty = 0;
+            static constexpr u32 StateNotified = 1;
+            static constexpr u32 StateParked = UINT32_MAX;
+
+            std::atomic<u32> state;
+
+        public:
+            FutexParker() : state(StateEmpty) {}
+
+            virtual void Park(const bool is_absolute, const vm::type::Long time) override {
+                // Either consumes the permit (notified -> empty) or announces that we are going to sleep (empty -> parked)
+                if(this->state.fetch_sub(1, std::memory_order_acquire) == StateNotified) {
+                    return;
+                }
+
+                if(is_absolute) {
+                    if(time > 0) {
+                        const struct timespec deadline = {
+                            .tv_sec = static_cast<time_t>(time / 1000),
+                            .tv_nsec = static_cast<long>((time % 1000) * 1000000)
+                        };
+                        futex::WaitUntilRealtime(this->state, StateParked, &deadline);
+                    }
+                }
+                else if(time > 0) {
+                    const struct timespec timeout = {
+                        .tv_sec = static_cast<time_t>(time / 1000000000),
+                        .tv_nsec = static_cast<long>(time % 1000000000)
+                    };
+                    futex::Wait(this->state, StateParked, &timeout);
+                }
+                else {
+                    futex::Wait(this->state, StateParked);
+                }
+
+                // Woken up, timed out or spurious: in any case the permit (if any) is consumed
+                this->state.exchange(StateEmpty, std::memory_order_acquire);
+            }
+
+            virtual void Unpark() override {
+                // Only the parked state needs a syscall
+                if(this->state.exchange(StateNotified, std::memory_order_release) == StateParked) {
+                    futex::Wake(this->state, 1);
+                }
+            }
+    };
+
+}
+
+namespace javm::native {
+
+    Ptr<RecursiveMutex> CreateRecursiveMutex() {
+        return ptr::New<extras::FutexRecursiveMutex>();
+    }
+
+    Ptr<ConditionVariable> CreateConditionVariable() {
+        return ptr::New<extras::FutexConditionVariable>();
+    }
+
+    Ptr<Parker> CreateParker() {
+        return ptr::New<extras::FutexParker>();
+    }
+
+}
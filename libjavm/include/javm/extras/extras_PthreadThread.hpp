@@ -2,6 +2,7 @@
 #pragma once
 #include <javm/native/native_NativeThread.hpp>
 #include <pthread.h>
+#include <sched.h>
 #include <csignal>
 
 // Threading implementation - pthread
@@ -48,6 +49,13 @@ namespace javm::extras {
                 const auto ret = pthread_kill(this->pthread, 0);
                 return (ret == 0);
             }
+
+            virtual void Join() override {
+                if(existing) {
+                    return;
+                }
+                pthread_join(this->pthread, nullptr);
+            }
     };
 
 }
@@ -59,6 +67,10 @@ namespace javm::native {
         return extras::CastFromPthread(self_thr);
     }
 
+    void YieldCurrentThread() {
+        sched_yield();
+    }
+
     Ptr<Thread> CreateThread() {
         return ptr::New<extras::PthreadThread>();
     }
@@ -8,8 +8,8 @@ namespace javm::native::impl::java::io {
 
     class FileDescriptor {
         public:
-            static ExecutionResult initIDs(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult set(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult initIDs(const VariableSpan &param_vars);
+            static ExecutionResult set(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,7 +8,8 @@ namespace javm::native::impl::java::io {
 
     class FileInputStream {
         public:
-            static ExecutionResult initIDs(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult initIDs(const VariableSpan &param_vars);
+            static ExecutionResult readBytes(Ptr<Variable> this_var, const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,8 +8,8 @@ namespace javm::native::impl::java::io {
 
     class FileOutputStream {
         public:
-            static ExecutionResult initIDs(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult writeBytes(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult initIDs(const VariableSpan &param_vars);
+            static ExecutionResult writeBytes(Ptr<Variable> this_var, const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace javm::native::impl::java::io {
 
     class WinNTFileSystem {
         public:
-            static ExecutionResult initIDs(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult initIDs(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
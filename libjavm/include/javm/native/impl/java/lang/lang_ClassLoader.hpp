@@ -8,7 +8,7 @@ namespace javm::native::impl::java::lang {
 
     class ClassLoader {
         public:
-            static ExecutionResult registerNatives(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult registerNatives(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
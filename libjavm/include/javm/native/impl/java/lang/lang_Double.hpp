@@ -1,4 +1,3 @@
-
 #pragma once
 #include <javm/vm/vm_Variable.hpp>
 
@@ -8,8 +7,8 @@ namespace javm::native::impl::java::lang {
 
     class Double {
         public:
-            static ExecutionResult doubleToRawLongBits(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult longBitsToDouble(const std::vector<Ptr<Variable>> &param_vars);
+            static type::Long doubleToRawLongBits(const type::Double d);
+            static type::Double longBitsToDouble(const type::Long l);
     };
 
 }
\ No newline at end of file
@@ -1,4 +1,3 @@
-
 #pragma once
 #include <javm/vm/vm_Variable.hpp>
 
@@ -8,7 +7,7 @@ namespace javm::native::impl::java::lang {
 
     class Float {
         public:
-            static ExecutionResult floatToRawIntBits(const std::vector<Ptr<Variable>> &param_vars);
+            static type::Integer floatToRawIntBits(const type::Float f);
     };
 
 }
\ No newline at end of file
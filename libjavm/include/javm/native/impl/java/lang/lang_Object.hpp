@@ -8,12 +8,12 @@ namespace javm::native::impl::java::lang {
 
     class Object {
         public:
-            static ExecutionResult registerNatives(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult getClass(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult hashCode(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult notify(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult notifyAll(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult wait(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult registerNatives(const VariableSpan &param_vars);
+            static ExecutionResult getClass(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult hashCode(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult notify(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult notifyAll(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult wait(Ptr<Variable> this_var, const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
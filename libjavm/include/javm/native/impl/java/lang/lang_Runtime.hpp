@@ -0,0 +1,16 @@
+#pragma once
+#include <javm/vm/vm_Variable.hpp>
+
+namespace javm::native::impl::java::lang {
+
+    using namespace vm;
+
+    class Runtime {
+        public:
+            static ExecutionResult gc(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult totalMemory(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult freeMemory(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult maxMemory(Ptr<Variable> this_var, const VariableSpan &param_vars);
+    };
+
+}
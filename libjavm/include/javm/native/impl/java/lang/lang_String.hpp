@@ -8,7 +8,7 @@ namespace javm::native::impl::java::lang {
 
     class String {
         public:
-            static ExecutionResult intern(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult intern(Ptr<Variable> this_var, const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,16 +8,17 @@ namespace javm::native::impl::java::lang {
 
     class System {
         public:
-            static ExecutionResult registerNatives(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult initProperties(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult arraycopy(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult setIn0(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult setOut0(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult setErr0(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult mapLibraryName(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult loadLibrary(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult currentTimeMillis(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult identityHashCode(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult registerNatives(const VariableSpan &param_vars);
+            static ExecutionResult initProperties(const VariableSpan &param_vars);
+            static ExecutionResult arraycopy(const VariableSpan &param_vars);
+            static ExecutionResult setIn0(const VariableSpan &param_vars);
+            static ExecutionResult setOut0(const VariableSpan &param_vars);
+            static ExecutionResult setErr0(const VariableSpan &param_vars);
+            static ExecutionResult mapLibraryName(const VariableSpan &param_vars);
+            static ExecutionResult loadLibrary(const VariableSpan &param_vars);
+            static ExecutionResult load(const VariableSpan &param_vars);
+            static type::Long currentTimeMillis();
+            static ExecutionResult identityHashCode(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,11 +8,15 @@ namespace javm::native::impl::java::lang {
 
     class Thread {
         public:
-            static ExecutionResult registerNatives(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult currentThread(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult setPriority0(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult isAlive(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult start0(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult registerNatives(const VariableSpan &param_vars);
+            static ExecutionResult currentThread(const VariableSpan &param_vars);
+            static ExecutionResult setPriority0(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult isAlive(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult start0(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult sleep(const VariableSpan &param_vars);
+            static ExecutionResult yield(const VariableSpan &param_vars);
+            static ExecutionResult interrupt0(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult isInterrupted(Ptr<Variable> this_var, const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
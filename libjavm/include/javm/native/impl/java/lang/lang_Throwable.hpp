@@ -8,9 +8,9 @@ namespace javm::native::impl::java::lang {
 
     class Throwable {
         public:
-            static ExecutionResult fillInStackTrace(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult getStackTraceDepth(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult getStackTraceElement(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult fillInStackTrace(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getStackTraceDepth(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getStackTraceElement(Ptr<Variable> this_var, const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+#include <javm/vm/vm_Variable.hpp>
+
+namespace javm::native::impl::java::lang::ref {
+
+    using namespace vm;
+
+    class Reference {
+        public:
+            static ExecutionResult get(Ptr<Variable> this_var, const VariableSpan &param_vars);
+    };
+
+}
\ No newline at end of file
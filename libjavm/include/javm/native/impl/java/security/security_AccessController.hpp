@@ -8,8 +8,8 @@ namespace javm::native::impl::java::security {
 
     class AccessController {
         public:
-            static ExecutionResult doPrivileged(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult getStackAccessControlContext(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult doPrivileged(const VariableSpan &param_vars);
+            static ExecutionResult getStackAccessControlContext(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace javm::native::impl::java::util::concurrent::atomic {
 
     class AtomicLong {
         public:
-            static ExecutionResult VMSupportsCS8(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult VMSupportsCS8(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace javm::native::impl::sun::io {
 
     class Win32ErrorMode {
         public:
-            static ExecutionResult setErrorMode(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult setErrorMode(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,8 +8,8 @@ namespace javm::native::impl::sun::misc {
 
     class Signal {
         public:
-            static ExecutionResult findSignal(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult handle0(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult findSignal(const VariableSpan &param_vars);
+            static ExecutionResult handle0(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,17 +8,67 @@ namespace javm::native::impl::sun::misc {
 
     class Unsafe {
         public:
-            static ExecutionResult registerNatives(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult arrayBaseOffset(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult arrayIndexScale(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult addressSize(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult objectFieldOffset(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult getIntVolatile(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult compareAndSwapInt(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult allocateMemory(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult putLong(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult getByte(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult freeMemory(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult registerNatives(const VariableSpan &param_vars);
+            static ExecutionResult arrayBaseOffset(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult arrayIndexScale(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static type::Integer addressSize(const Ptr<Variable> &this_var);
+            static ExecutionResult objectFieldOffset(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult staticFieldOffset(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult staticFieldBase(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getObject(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putObject(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getObjectVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putObjectVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getInt(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putInt(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getIntVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putIntVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getLong(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putLong(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getLongVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putLongVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getBoolean(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putBoolean(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getBooleanVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putBooleanVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getByte(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putByte(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getByteVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putByteVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getShort(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putShort(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getShortVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putShortVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getChar(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putChar(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getCharVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putCharVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getFloat(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putFloat(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getFloatVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putFloatVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getDouble(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putDouble(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getDoubleVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putDoubleVolatile(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putOrderedObject(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putOrderedInt(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult putOrderedLong(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult compareAndSwapObject(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult compareAndSwapInt(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult compareAndSwapLong(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getAndAddInt(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getAndAddLong(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getAndSetInt(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getAndSetLong(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult getAndSetObject(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static type::Long allocateMemory(const Ptr<Variable> &this_var, const type::Long size);
+            // Raw memory (address) variants
+            static void putLongAddress(const Ptr<Variable> &this_var, const type::Long addr, const type::Long val);
+            static i8 getByteAddress(const Ptr<Variable> &this_var, const type::Long addr);
+            static void freeMemory(const Ptr<Variable> &this_var, const type::Long addr);
+            static ExecutionResult park(Ptr<Variable> this_var, const VariableSpan &param_vars);
+            static ExecutionResult unpark(Ptr<Variable> this_var, const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
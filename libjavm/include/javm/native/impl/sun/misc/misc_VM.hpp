@@ -8,7 +8,7 @@ namespace javm::native::impl::sun::misc {
 
     class VM {
         public:
-            static ExecutionResult initialize(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult initialize(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace javm::native::impl::sun::nio::cs {
 
     class StreamEncoder {
         public:
-            static ExecutionResult forOutputStreamWriter(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult forOutputStreamWriter(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
@@ -8,8 +8,8 @@ namespace javm::native::impl::sun::reflect {
 
     class Reflection {
         public:
-            static ExecutionResult getCallerClass(const std::vector<Ptr<Variable>> &param_vars);
-            static ExecutionResult getClassAccessFlags(const std::vector<Ptr<Variable>> &param_vars);
+            static ExecutionResult getCallerClass(const VariableSpan &param_vars);
+            static ExecutionResult getClassAccessFlags(const VariableSpan &param_vars);
     };
 
 }
\ No newline at end of file
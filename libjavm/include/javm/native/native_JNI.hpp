@@ -0,0 +1,308 @@
+#pragma once
+#include <javm/javm_Base.hpp>
+#include <cstdarg>
+
+namespace javm::native::jni {
+
+    // Binary interface of JNI (as in the JDK's jni.h), which libraries loaded through System.loadLibrary/System.load are built against
+    // Only the layout matters: natives get a JNIEnv pointing to the function table below, so every entry must stay at its standard position
+
+    using jboolean = u8;
+    using jbyte = i8;
+    using jchar = u16;
+    using jshort = i16;
+    using jint = i32;
+    using jlong = i64;
+    using jfloat = float;
+    using jdouble = double;
+    using jsize = jint;
+
+    // References are opaque handles (see the implementation), every reference type is just an alias of jobject
+
+    struct _jobject;
+    using jobject = _jobject*;
+    using jclass = jobject;
+    using jthrowable = jobject;
+    using jstring = jobject;
+    using jarray = jobject;
+    using jbooleanArray = jarray;
+    using jbyteArray = jarray;
+    using jcharArray = jarray;
+    using jshortArray = jarray;
+    using jintArray = jarray;
+    using jlongArray = jarray;
+    using jfloatArray = jarray;
+    using jdoubleArray = jarray;
+    using jobjectArray = jarray;
+    using jweak = jobject;
+
+    struct _jfieldID;
+    using jfieldID = _jfieldID*;
+    struct _jmethodID;
+    using jmethodID = _jmethodID*;
+
+    union jvalue {
+        jboolean z;
+        jbyte b;
+        jchar c;
+        jshort s;
+        jint i;
+        jlong j;
+        jfloat f;
+        jdouble d;
+        jobject l;
+    };
+
+    enum jobjectRefType {
+        JNIInvalidRefType = 0,
+        JNILocalRefType = 1,
+        JNIGlobalRefType = 2,
+        JNIWeakGlobalRefType = 3
+    };
+
+    struct JNINativeMethod {
+        char *name;
+        char *signature;
+        void *fnPtr;
+    };
+
+    constexpr jboolean JNI_FALSE = 0;
+    constexpr jboolean JNI_TRUE = 1;
+
+    constexpr jint JNI_OK = 0;
+    constexpr jint JNI_ERR = -1;
+    constexpr jint JNI_EDETACHED = -2;
+    constexpr jint JNI_EVERSION = -3;
+
+    constexpr jint JNI_COMMIT = 1;
+    constexpr jint JNI_ABORT = 2;
+
+    constexpr jint JNI_VERSION_1_1 = 0x00010001;
+    constexpr jint JNI_VERSION_1_2 = 0x00010002;
+    constexpr jint JNI_VERSION_1_4 = 0x00010004;
+    constexpr jint JNI_VERSION_1_6 = 0x00010006;
+    constexpr jint JNI_VERSION_1_8 = 0x00010008;
+
+    // Every (non-void) JNI value type, in the order the function table lists them
+
+    #define _JAVM_JNI_FOR_EACH_TYPE(entries) \
+    entries(jobject, Object) \
+    entries(jboolean, Boolean) \
+    entries(jbyte, Byte) \
+    entries(jchar, Char) \
+    entries(jshort, Short) \
+    entries(jint, Int) \
+    entries(jlong, Long) \
+    entries(jfloat, Float) \
+    entries(jdouble, Double)
+
+    #define _JAVM_JNI_FOR_EACH_PRIMITIVE_TYPE(entries) \
+    entries(jboolean, Boolean) \
+    entries(jbyte, Byte) \
+    entries(jchar, Char) \
+    entries(jshort, Short) \
+    entries(jint, Int) \
+    entries(jlong, Long) \
+    entries(jfloat, Float) \
+    entries(jdouble, Double)
+
+    struct JNINativeInterface;
+    struct JNIInvokeInterface;
+
+    struct JNIEnv {
+        const JNINativeInterface *functions;
+    };
+
+    struct JavaVM {
+        const JNIInvokeInterface *functions;
+    };
+
+    struct JNINativeInterface {
+        void *reserved0;
+        void *reserved1;
+        void *reserved2;
+        void *reserved3;
+
+        jint (*GetVersion)(JNIEnv*);
+
+        jclass (*DefineClass)(JNIEnv*, const char*, jobject, const jbyte*, jsize);
+        jclass (*FindClass)(JNIEnv*, const char*);
+
+        jmethodID (*FromReflectedMethod)(JNIEnv*, jobject);
+        jfieldID (*FromReflectedField)(JNIEnv*, jobject);
+        jobject (*ToReflectedMethod)(JNIEnv*, jclass, jmethodID, jboolean);
+
+        jclass (*GetSuperclass)(JNIEnv*, jclass);
+        jboolean (*IsAssignableFrom)(JNIEnv*, jclass, jclass);
+
+        jobject (*ToReflectedField)(JNIEnv*, jclass, jfieldID, jboolean);
+
+        jint (*Throw)(JNIEnv*, jthrowable);
+        jint (*ThrowNew)(JNIEnv*, jclass, const char*);
+        jthrowable (*ExceptionOccurred)(JNIEnv*);
+        void (*ExceptionDescribe)(JNIEnv*);
+        void (*ExceptionClear)(JNIEnv*);
+        void (*FatalError)(JNIEnv*, const char*);
+
+        jint (*PushLocalFrame)(JNIEnv*, jint);
+        jobject (*PopLocalFrame)(JNIEnv*, jobject);
+
+        jobject (*NewGlobalRef)(JNIEnv*, jobject);
+        void (*DeleteGlobalRef)(JNIEnv*, jobject);
+        void (*DeleteLocalRef)(JNIEnv*, jobject);
+        jboolean (*IsSameObject)(JNIEnv*, jobject, jobject);
+        jobject (*NewLocalRef)(JNIEnv*, jobject);
+        jint (*EnsureLocalCapacity)(JNIEnv*, jint);
+
+        jobject (*AllocObject)(JNIEnv*, jclass);
+        jobject (*NewObject)(JNIEnv*, jclass, jmethodID, ...);
+        jobject (*NewObjectV)(JNIEnv*, jclass, jmethodID, va_list);
+        jobject (*NewObjectA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+
+        jclass (*GetObjectClass)(JNIEnv*, jobject);
+        jboolean (*IsInstanceOf)(JNIEnv*, jobject, jclass);
+
+        jmethodID (*GetMethodID)(JNIEnv*, jclass, const char*, const char*);
+
+        #define _JAVM_JNI_CALL_METHOD_ENTRIES(type, name) \
+        type (*Call##name##Method)(JNIEnv*, jobject, jmethodID, ...); \
+        type (*Call##name##MethodV)(JNIEnv*, jobject, jmethodID, va_list); \
+        type (*Call##name##MethodA)(JNIEnv*, jobject, jmethodID, const jvalue*);
+
+        #define _JAVM_JNI_CALL_NONVIRTUAL_METHOD_ENTRIES(type, name) \
+        type (*CallNonvirtual##name##Method)(JNIEnv*, jobject, jclass, jmethodID, ...); \
+        type (*CallNonvirtual##name##MethodV)(JNIEnv*, jobject, jclass, jmethodID, va_list); \
+        type (*CallNonvirtual##name##MethodA)(JNIEnv*, jobject, jclass, jmethodID, const jvalue*);
+
+        #define _JAVM_JNI_CALL_STATIC_METHOD_ENTRIES(type, name) \
+        type (*CallStatic##name##Method)(JNIEnv*, jclass, jmethodID, ...); \
+        type (*CallStatic##name##MethodV)(JNIEnv*, jclass, jmethodID, va_list); \
+        type (*CallStatic##name##MethodA)(JNIEnv*, jclass, jmethodID, const jvalue*);
+
+        _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_CALL_METHOD_ENTRIES)
+        _JAVM_JNI_CALL_METHOD_ENTRIES(void, Void)
+
+        _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_CALL_NONVIRTUAL_METHOD_ENTRIES)
+        _JAVM_JNI_CALL_NONVIRTUAL_METHOD_ENTRIES(void, Void)
+
+        jfieldID (*GetFieldID)(JNIEnv*, jclass, const char*, const char*);
+
+        #define _JAVM_JNI_GET_FIELD_ENTRY(type, name) \
+        type (*Get##name##Field)(JNIEnv*, jobject, jfieldID);
+
+        #define _JAVM_JNI_SET_FIELD_ENTRY(type, name) \
+        void (*Set##name##Field)(JNIEnv*, jobject, jfieldID, type);
+
+        _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_GET_FIELD_ENTRY)
+        _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_SET_FIELD_ENTRY)
+
+        jmethodID (*GetStaticMethodID)(JNIEnv*, jclass, const char*, const char*);
+
+        _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_CALL_STATIC_METHOD_ENTRIES)
+        _JAVM_JNI_CALL_STATIC_METHOD_ENTRIES(void, Void)
+
+        jfieldID (*GetStaticFieldID)(JNIEnv*, jclass, const char*, const char*);
+
+        #define _JAVM_JNI_GET_STATIC_FIELD_ENTRY(type, name) \
+        type (*GetStatic##name##Field)(JNIEnv*, jclass, jfieldID);
+
+        #define _JAVM_JNI_SET_STATIC_FIELD_ENTRY(type, name) \
+        void (*SetStatic##name##Field)(JNIEnv*, jclass, jfieldID, type);
+
+        _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_GET_STATIC_FIELD_ENTRY)
+        _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_SET_STATIC_FIELD_ENTRY)
+
+        jstring (*NewString)(JNIEnv*, const jchar*, jsize);
+        jsize (*GetStringLength)(JNIEnv*, jstring);
+        const jchar *(*GetStringChars)(JNIEnv*, jstring, jboolean*);
+        void (*ReleaseStringChars)(JNIEnv*, jstring, const jchar*);
+
+        jstring (*NewStringUTF)(JNIEnv*, const char*);
+        jsize (*GetStringUTFLength)(JNIEnv*, jstring);
+        const char *(*GetStringUTFChars)(JNIEnv*, jstring, jboolean*);
+        void (*ReleaseStringUTFChars)(JNIEnv*, jstring, const char*);
+
+        jsize (*GetArrayLength)(JNIEnv*, jarray);
+
+        jobjectArray (*NewObjectArray)(JNIEnv*, jsize, jclass, jobject);
+        jobject (*GetObjectArrayElement)(JNIEnv*, jobjectArray, jsize);
+        void (*SetObjectArrayElement)(JNIEnv*, jobjectArray, jsize, jobject);
+
+        #define _JAVM_JNI_NEW_ARRAY_ENTRY(type, name) \
+        jarray (*New##name##Array)(JNIEnv*, jsize);
+
+        #define _JAVM_JNI_GET_ARRAY_ELEMENTS_ENTRY(type, name) \
+        type *(*Get##name##ArrayElements)(JNIEnv*, jarray, jboolean*);
+
+        #define _JAVM_JNI_RELEASE_ARRAY_ELEMENTS_ENTRY(type, name) \
+        void (*Release##name##ArrayElements)(JNIEnv*, jarray, type*, jint);
+
+        #define _JAVM_JNI_GET_ARRAY_REGION_ENTRY(type, name) \
+        void (*Get##name##ArrayRegion)(JNIEnv*, jarray, jsize, jsize, type*);
+
+        #define _JAVM_JNI_SET_ARRAY_REGION_ENTRY(type, name) \
+        void (*Set##name##ArrayRegion)(JNIEnv*, jarray, jsize, jsize, const type*);
+
+        _JAVM_JNI_FOR_EACH_PRIMITIVE_TYPE(_JAVM_JNI_NEW_ARRAY_ENTRY)
+        _JAVM_JNI_FOR_EACH_PRIMITIVE_TYPE(_JAVM_JNI_GET_ARRAY_ELEMENTS_ENTRY)
+        _JAVM_JNI_FOR_EACH_PRIMITIVE_TYPE(_JAVM_JNI_RELEASE_ARRAY_ELEMENTS_ENTRY)
+        _JAVM_JNI_FOR_EACH_PRIMITIVE_TYPE(_JAVM_JNI_GET_ARRAY_REGION_ENTRY)
+        _JAVM_JNI_FOR_EACH_PRIMITIVE_TYPE(_JAVM_JNI_SET_ARRAY_REGION_ENTRY)
+
+        #undef _JAVM_JNI_CALL_METHOD_ENTRIES
+        #undef _JAVM_JNI_CALL_NONVIRTUAL_METHOD_ENTRIES
+        #undef _JAVM_JNI_CALL_STATIC_METHOD_ENTRIES
+        #undef _JAVM_JNI_GET_FIELD_ENTRY
+        #undef _JAVM_JNI_SET_FIELD_ENTRY
+        #undef _JAVM_JNI_GET_STATIC_FIELD_ENTRY
+        #undef _JAVM_JNI_SET_STATIC_FIELD_ENTRY
+        #undef _JAVM_JNI_NEW_ARRAY_ENTRY
+        #undef _JAVM_JNI_GET_ARRAY_ELEMENTS_ENTRY
+        #undef _JAVM_JNI_RELEASE_ARRAY_ELEMENTS_ENTRY
+        #undef _JAVM_JNI_GET_ARRAY_REGION_ENTRY
+        #undef _JAVM_JNI_SET_ARRAY_REGION_ENTRY
+
+        jint (*RegisterNatives)(JNIEnv*, jclass, const JNINativeMethod*, jint);
+        jint (*UnregisterNatives)(JNIEnv*, jclass);
+
+        jint (*MonitorEnter)(JNIEnv*, jobject);
+        jint (*MonitorExit)(JNIEnv*, jobject);
+
+        jint (*GetJavaVM)(JNIEnv*, JavaVM**);
+
+        void (*GetStringRegion)(JNIEnv*, jstring, jsize, jsize, jchar*);
+        void (*GetStringUTFRegion)(JNIEnv*, jstring, jsize, jsize, char*);
+
+        void *(*GetPrimitiveArrayCritical)(JNIEnv*, jarray, jboolean*);
+        void (*ReleasePrimitiveArrayCritical)(JNIEnv*, jarray, void*, jint);
+
+        const jchar *(*GetStringCritical)(JNIEnv*, jstring, jboolean*);
+        void (*ReleaseStringCritical)(JNIEnv*, jstring, const jchar*);
+
+        jweak (*NewWeakGlobalRef)(JNIEnv*, jobject);
+        void (*DeleteWeakGlobalRef)(JNIEnv*, jweak);
+
+        jboolean (*ExceptionCheck)(JNIEnv*);
+
+        jobject (*NewDirectByteBuffer)(JNIEnv*, void*, jlong);
+        void *(*GetDirectBufferAddress)(JNIEnv*, jobject);
+        jlong (*GetDirectBufferCapacity)(JNIEnv*, jobject);
+
+        jobjectRefType (*GetObjectRefType)(JNIEnv*, jobject);
+    };
+
+    struct JNIInvokeInterface {
+        void *reserved0;
+        void *reserved1;
+        void *reserved2;
+
+        jint (*DestroyJavaVM)(JavaVM*);
+        jint (*AttachCurrentThread)(JavaVM*, void**, void*);
+        jint (*DetachCurrentThread)(JavaVM*);
+        jint (*GetEnv)(JavaVM*, void**, jint);
+        jint (*AttachCurrentThreadAsDaemon)(JavaVM*, void**, void*);
+    };
+
+    using JNIOnLoadFunction = jint(*)(JavaVM*, void*);
+
+}
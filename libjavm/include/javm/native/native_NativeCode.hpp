@@ -1,13 +1,51 @@
-
 #pragma once
 #include <javm/vm/vm_TypeBase.hpp>
 #include <javm/vm/vm_Sync.hpp>
 #include <map>
+#include <unordered_map>
 
 namespace javm::native {
 
-    using NativeInstanceMethod = vm::ExecutionResult(*)(Ptr<vm::Variable>, const std::vector<Ptr<vm::Variable>>&);
-    using NativeClassMethod = vm::ExecutionResult(*)(const std::vector<Ptr<vm::Variable>>&);
+    using NativeInstanceMethod = vm::ExecutionResult(*)(Ptr<vm::Variable>, const vm::VariableSpan&);
+    using NativeClassMethod = vm::ExecutionResult(*)(const vm::VariableSpan&);
+
+    // Class names are always stored in slash form
+    struct NativeLocation {
+        String class_name;
+        String name;
+        String descriptor;
+
+        inline bool operator==(const NativeLocation &other) const {
+            return (this->class_name == other.class_name) && (this->name == other.name) && (this->descriptor == other.descriptor);
+        }
+    };
+
+    struct NativeLocationHash {
+        inline size_t operator()(const NativeLocation &location) const {
+            const std::hash<String> str_hash;
+            auto hash = str_hash(location.class_name);
+            hash = (hash * 31) ^ str_hash(location.name);
+            hash = (hash * 31) ^ str_hash(location.descriptor);
+            return hash;
+        }
+    };
+
+    template<typename Fn>
+    using NativeTable = std::unordered_map<NativeLocation, Fn, NativeLocationHash>;
+
+    // Registry lookup cached on a method (see ClassType): the registry is only checked again if natives were registered after it was bound
+    // Version 0 means never bound, the registry's version starts at 1
+
+    struct NativeBinding {
+        std::atomic<u32> version;
+        std::atomic<NativeInstanceMethod> instance_method;
+        std::atomic<NativeClassMethod> class_method;
+        // Same for the JNI implementation (see GetBoundJNIMethod), only looked up for native methods without a registered native
+        std::atomic<u32> jni_version;
+        std::atomic<void*> jni_method;
+
+        NativeBinding() : version(0), instance_method(nullptr), class_method(nullptr), jni_version(0), jni_method(nullptr) {}
+    };
 
     void RegisterNativeInstanceMethod(const String &class_name, const String &method_name, const String &method_descriptor, NativeInstanceMethod method);
     bool HasNativeInstanceMethod(const String &class_name, const String &method_name, const String &method_descriptor);
@@ -17,4 +55,8 @@ namespace javm::native {
     bool HasNativeClassMethod(const String &class_name, const String &fn_name, const String &fn_descriptor);
     NativeClassMethod FindNativeClassMethod(const String &class_name, const String &fn_name, const String &fn_descriptor);
 
-}
\ No newline at end of file
+    // Native implementation of a method (nullptr if none), only looking it up in the registry if the binding isn't up to date
+    NativeInstanceMethod GetBoundNativeInstanceMethod(NativeBinding &binding, const String &class_name, const String &method_name, const String &method_descriptor);
+    NativeClassMethod GetBoundNativeClassMethod(NativeBinding &binding, const String &class_name, const String &fn_name, const String &fn_descriptor);
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <javm/native/native_NativeCode.hpp>
+
+namespace javm::native {
+
+    // Platform/lib-specific dynamic library functions (dlopen/dlsym or similar), needed to load JNI libraries
+
+    using LibraryHandle = void*;
+
+    // Platform file name of a library (like "libfoo.so" for "foo")
+    String MapLibraryName(const String &name);
+
+    // Both return nullptr on failure
+    LibraryHandle OpenLibrary(const String &path);
+    void *FindLibrarySymbol(LibraryHandle handle, const std::string &symbol_name);
+
+    struct NativeLibrary {
+        String path;
+        LibraryHandle handle;
+    };
+
+    // What JNI field and method IDs point to, owned by the instance so that IDs stay valid (and unique) as long as it lives
+    // Instance fields keep the class declaring them (to pick the right sub-instance), static fields keep their resolved slot
+
+    struct JNIMemberId {
+        Ptr<vm::ClassType> class_type;
+        String name;
+        String descriptor;
+        bool is_static;
+        u32 static_slot;
+    };
+
+    // Loads a JNI library (unless it was already loaded), calling its JNI_OnLoad if present
+    // Sets whether the library could be opened at all, only throwing (java.lang.UnsatisfiedLinkError or whatever JNI_OnLoad threw) if its initialization failed
+    vm::ExecutionResult LoadNativeLibrary(const String &path, bool &out_found);
+
+    // JNI implementation of a method (nullptr if none): the one registered through RegisterNatives, otherwise the one exported by a loaded library under its mangled name
+    // Bound like regular natives, so lookups only happen again after libraries get loaded or natives get registered
+    void *GetBoundJNIMethod(NativeBinding &binding, const String &class_name, const String &fn_name, const String &fn_descriptor);
+
+    // Native methods without a registered native go through these, which throw java.lang.UnsatisfiedLinkError if no JNI implementation is found either
+    vm::ExecutionResult CallJNIClassMethod(Ptr<vm::ClassType> class_type, NativeBinding &binding, const String &fn_name, const String &fn_descriptor, const vm::VariableSpan &param_vars);
+    vm::ExecutionResult CallJNIInstanceMethod(Ptr<vm::ClassType> class_type, NativeBinding &binding, const String &method_name, const String &method_descriptor, Ptr<vm::Variable> this_var, const vm::VariableSpan &param_vars);
+
+}
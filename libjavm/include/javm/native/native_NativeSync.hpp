@@ -25,4 +25,16 @@ namespace javm::native {
 
     Ptr<ConditionVariable> CreateConditionVariable();
 
+    // Per-thread park/unpark permit, as used by LockSupport (Unsafe.park/unpark)
+
+    class Parker {
+        public:
+            // Returns right away if a permit is available (consuming it), otherwise blocks until unparked, the timeout expires or spuriously
+            // Absolute times are milliseconds since the epoch, relative ones are nanoseconds (0 meaning no timeout)
+            virtual void Park(const bool is_absolute, const vm::type::Long time) = 0;
+            virtual void Unpark() = 0;
+    };
+
+    Ptr<Parker> CreateParker();
+
 }
\ No newline at end of file
@@ -3,6 +3,12 @@
 #include <javm/vm/vm_TypeBase.hpp>
 #include <functional>
 
+namespace javm::rt {
+
+    struct VMInstance;
+
+}
+
 namespace javm::native {
 
     // Platform/lib-specific native threading functions
@@ -22,6 +28,7 @@ namespace javm::native {
 
         private:
             Ptr<vm::Variable> thread_v;
+            Ptr<rt::VMInstance> instance;
 
         public:
             inline void SetThreadVariable(Ptr<vm::Variable> thread_v) {
@@ -32,12 +39,23 @@ namespace javm::native {
                 return this->thread_v;
             }
 
+            // VM instance the thread runs in
+            inline void SetInstance(Ptr<rt::VMInstance> instance) {
+                this->instance = instance;
+            }
+
+            inline Ptr<rt::VMInstance> GetInstance() {
+                return this->instance;
+            }
+
             virtual void Start(ThreadEntrypoint entry_fn) = 0;
             virtual ThreadHandle GetHandle() = 0;
             virtual bool IsAlive() = 0;
+            virtual void Join() = 0;
     };
 
     ThreadHandle GetCurrentThreadHandle();
+    void YieldCurrentThread();
 
     Ptr<Thread> CreateThread();
     Ptr<Thread> CreateExistingThread(const ThreadHandle handle);
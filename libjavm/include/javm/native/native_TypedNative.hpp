@@ -0,0 +1,159 @@
+#pragma once
+#include <javm/vm/vm_Variable.hpp>
+#include <javm/native/native_NativeCode.hpp>
+
+namespace javm::native {
+
+    // Typed natives: plain C++ functions taking and returning Java values, registered through an adapter generated at compile time
+    // The adapter reads the arguments in place from the caller's operand stack and boxes the result (if any), so the implementation never touches variables
+    //
+    // Primitive types are told apart by their C++ type (byte/boolean/short/char variables are all plain ints):
+    // - bool (Z), i8 (B), i16 (S), u16 (C), type::Integer (I), type::Long (J), type::Float (F), type::Double (D), and void (V) as return type
+    // - References are taken as const Ptr<vm::Variable>& and returned as Ptr<vm::Variable>
+    // - Returning vm::ExecutionResult allows throwing
+    // If every type is primitive the descriptor is derived from the signature, otherwise it must be given
+    // Instance natives take the this variable (const Ptr<vm::Variable>&) as their first parameter
+
+    namespace typed {
+
+        template<typename T>
+        struct ValueTraits {
+            static constexpr bool IsPrimitive = false;
+        };
+
+        #define _JAVM_TYPED_NATIVE_PRIMITIVE(cpp_type, var_type, desc) \
+        template<> \
+        struct ValueTraits<cpp_type> { \
+            static constexpr bool IsPrimitive = true; \
+            static constexpr char16_t Descriptor = desc; \
+            static inline cpp_type Read(const Ptr<vm::Variable> &var) { \
+                return static_cast<cpp_type>(var->PeekValue<var_type>()); \
+            } \
+            static inline Ptr<vm::Variable> Make(const cpp_type val) { \
+                return vm::NewPrimitiveVariable<var_type>(static_cast<var_type>(val)); \
+            } \
+        };
+
+        _JAVM_TYPED_NATIVE_PRIMITIVE(bool, vm::type::Boolean, u'Z')
+        _JAVM_TYPED_NATIVE_PRIMITIVE(i8, vm::type::Byte, u'B')
+        _JAVM_TYPED_NATIVE_PRIMITIVE(i16, vm::type::Short, u'S')
+        _JAVM_TYPED_NATIVE_PRIMITIVE(u16, vm::type::Character, u'C')
+        _JAVM_TYPED_NATIVE_PRIMITIVE(vm::type::Integer, vm::type::Integer, u'I')
+        _JAVM_TYPED_NATIVE_PRIMITIVE(vm::type::Long, vm::type::Long, u'J')
+        _JAVM_TYPED_NATIVE_PRIMITIVE(vm::type::Float, vm::type::Float, u'F')
+        _JAVM_TYPED_NATIVE_PRIMITIVE(vm::type::Double, vm::type::Double, u'D')
+
+        #undef _JAVM_TYPED_NATIVE_PRIMITIVE
+
+        template<>
+        struct ValueTraits<void> {
+            static constexpr bool IsPrimitive = true;
+            static constexpr char16_t Descriptor = u'V';
+        };
+
+        // References are passed as they are (without copying them), primitives are read in place
+        template<typename T>
+        inline T ReadArgument(const Ptr<vm::Variable> &var) {
+            using U = std::remove_cv_t<std::remove_reference_t<T>>;
+            if constexpr(std::is_same_v<U, Ptr<vm::Variable>>) {
+                return var;
+            }
+            else {
+                return ValueTraits<U>::Read(var);
+            }
+        }
+
+        template<typename R, typename Fn>
+        inline vm::ExecutionResult MakeResult(Fn &&fn) {
+            if constexpr(std::is_void_v<R>) {
+                fn();
+                return vm::ExecutionResult::Void();
+            }
+            else if constexpr(std::is_same_v<R, vm::ExecutionResult>) {
+                return fn();
+            }
+            else if constexpr(std::is_same_v<R, Ptr<vm::Variable>>) {
+                return vm::ExecutionResult::ReturnVariable(fn());
+            }
+            else {
+                return vm::ExecutionResult::ReturnVariable(ValueTraits<R>::Make(fn()));
+            }
+        }
+
+        template<typename R, typename ...Args>
+        struct Signature {
+            static constexpr bool IsDerivable = ValueTraits<R>::IsPrimitive && (ValueTraits<Args>::IsPrimitive && ...);
+        };
+
+        template<typename R, typename ...Args>
+        struct DerivedDescriptor {
+            static constexpr char16_t Value[] = { u'(', ValueTraits<Args>::Descriptor..., u')', ValueTraits<R>::Descriptor, u'\0' };
+        };
+
+        template<auto Fn>
+        struct ClassMethodAdapter;
+
+        template<typename R, typename ...Args, R(*Fn)(Args...)>
+        struct ClassMethodAdapter<Fn> {
+            using Sig = Signature<R, std::remove_cv_t<std::remove_reference_t<Args>>...>;
+            using Descriptor = DerivedDescriptor<R, std::remove_cv_t<std::remove_reference_t<Args>>...>;
+
+            template<size_t ...Is>
+            static inline vm::ExecutionResult CallImpl(const vm::VariableSpan &param_vars, std::index_sequence<Is...>) {
+                return MakeResult<R>([&]() {
+                    return Fn(ReadArgument<Args>(param_vars[Is])...);
+                });
+            }
+
+            static vm::ExecutionResult Call(const vm::VariableSpan &param_vars) {
+                return CallImpl(param_vars, std::index_sequence_for<Args...>{});
+            }
+        };
+
+        template<auto Fn>
+        struct InstanceMethodAdapter;
+
+        template<typename R, typename This, typename ...Args, R(*Fn)(This, Args...)>
+        struct InstanceMethodAdapter<Fn> {
+            using Sig = Signature<R, std::remove_cv_t<std::remove_reference_t<Args>>...>;
+            using Descriptor = DerivedDescriptor<R, std::remove_cv_t<std::remove_reference_t<Args>>...>;
+
+            template<size_t ...Is>
+            static inline vm::ExecutionResult CallImpl(Ptr<vm::Variable> this_var, const vm::VariableSpan &param_vars, std::index_sequence<Is...>) {
+                return MakeResult<R>([&]() {
+                    return Fn(this_var, ReadArgument<Args>(param_vars[Is])...);
+                });
+            }
+
+            static vm::ExecutionResult Call(Ptr<vm::Variable> this_var, const vm::VariableSpan &param_vars) {
+                return CallImpl(this_var, param_vars, std::index_sequence_for<Args...>{});
+            }
+        };
+
+    }
+
+    template<auto Fn>
+    inline void RegisterTypedNativeClassMethod(const String &class_name, const String &fn_name, const String &fn_descriptor) {
+        RegisterNativeClassMethod(class_name, fn_name, fn_descriptor, &typed::ClassMethodAdapter<Fn>::Call);
+    }
+
+    template<auto Fn>
+    inline void RegisterTypedNativeClassMethod(const String &class_name, const String &fn_name) {
+        using Adapter = typed::ClassMethodAdapter<Fn>;
+        static_assert(Adapter::Sig::IsDerivable, "The descriptor can only be derived from primitive types");
+        RegisterTypedNativeClassMethod<Fn>(class_name, fn_name, Adapter::Descriptor::Value);
+    }
+
+    template<auto Fn>
+    inline void RegisterTypedNativeInstanceMethod(const String &class_name, const String &method_name, const String &method_descriptor) {
+        RegisterNativeInstanceMethod(class_name, method_name, method_descriptor, &typed::InstanceMethodAdapter<Fn>::Call);
+    }
+
+    template<auto Fn>
+    inline void RegisterTypedNativeInstanceMethod(const String &class_name, const String &method_name) {
+        using Adapter = typed::InstanceMethodAdapter<Fn>;
+        static_assert(Adapter::Sig::IsDerivable, "The descriptor can only be derived from primitive types");
+        RegisterTypedNativeInstanceMethod<Fn>(class_name, method_name, Adapter::Descriptor::Value);
+    }
+
+}
@@ -17,6 +17,9 @@ namespace javm::rt {
     }
 
     Ptr<vm::ClassType> LocateClassType(const String &class_name);
+    // Same as locating java.lang.Object/java.lang.String, but cached in the current instance
+    Ptr<vm::ClassType> LocateObjectClassType();
+    Ptr<vm::ClassType> LocateStringClassType();
     void ResetCachedClassTypes();
 
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include <javm/rt/rt_ClassSource.hpp>
+#include <javm/vm/vm_Thread.hpp>
+#include <javm/vm/vm_Properties.hpp>
+#include <javm/vm/jutil/jutil_String.hpp>
+#include <javm/vm/ref/ref_Reflection.hpp>
+#include <javm/native/native_NativeLibrary.hpp>
+
+namespace javm::rt {
+
+    // An isolated VM: everything which used to be process-global lives here, so several instances can run side by side on their own threads
+    // Class sources hold the loaded class types (and therefore their static state), so they must not be shared between instances
+
+    struct VMInstance {
+        std::vector<Ptr<ClassSource>> class_sources;
+        vm::PropertyTable initial_system_props;
+        // Reflection types of primitive types (indexed by their variable type), and the reflection types of every java.lang.Class variable
+        std::array<vm::ref::ReflectionTypeTable, static_cast<size_t>(vm::VariableType::Double) + 1> primitive_ref_types;
+        std::unordered_map<vm::type::ClassInstance*, std::weak_ptr<vm::ref::ReflectionType>> class_var_ref_types;
+        vm::Monitor class_var_lock;
+        vm::jutil::StringInternTable intern_strings;
+        // Frequently needed class types, for arrays (which dispatch their methods to java.lang.Object) and strings
+        Ptr<vm::ClassType> object_class_type;
+        Ptr<vm::ClassType> string_class_type;
+        vm::Heap heap;
+
+        std::vector<Ptr<vm::ThreadAccessor>> thread_list;
+        vm::Monitor thread_list_lock;
+        // Changed (to a process-wide unique value) whenever the thread list changes, which invalidates the threads' cached accessors (see GetCurrentThread)
+        std::atomic<u64> thread_list_version;
+        vm::SafepointControl safepoint;
+
+        Ptr<vm::ThreadAccessor> thrown_thread;
+        Ptr<vm::Variable> thrown_throwable;
+        vm::Monitor thrown_lock;
+        bool thrown_notified;
+        // Whether the thrown throwable is set, checked without locking before every execution
+        std::atomic_bool is_thrown;
+
+        native::NativeTable<native::NativeInstanceMethod> native_instance_methods;
+        native::NativeTable<native::NativeClassMethod> native_class_methods;
+        vm::Monitor native_lock;
+        // Bumped on every registration, so that methods bound before it look their native up again (see NativeBinding)
+        std::atomic<u32> native_version;
+
+        // JNI state, also guarded by the native lock (loading libraries or registering JNI natives bumps the native version too)
+        std::vector<native::NativeLibrary> native_libraries;
+        // Registered through RegisterNatives, which takes precedence over symbols exported by the libraries
+        native::NativeTable<void*> jni_natives;
+        native::NativeTable<std::unique_ptr<native::JNIMemberId>> jni_field_ids;
+        native::NativeTable<std::unique_ptr<native::JNIMemberId>> jni_method_ids;
+
+        VMInstance() : thread_list_version(0), thrown_notified(true), is_thrown(false), native_version(1) {}
+        VMInstance(const VMInstance&) = delete;
+        VMInstance &operator=(const VMInstance&) = delete;
+    };
+
+    Ptr<VMInstance> CreateInstance();
+
+    // Makes the instance current for the calling thread (threads started by Java code inherit their creator's instance)
+    void EnterInstance(Ptr<VMInstance> instance);
+    void ExitInstance();
+
+    // Releases all the instance's state (its threads must have finished)
+    void DestroyInstance(Ptr<VMInstance> instance);
+
+    // Threads which never entered an instance use a process-wide default one, which keeps single-VM programs unchanged
+    VMInstance &GetCurrentInstance();
+    Ptr<VMInstance> GetCurrentInstancePtr();
+
+    class ScopedInstance {
+        private:
+            Ptr<VMInstance> prev_instance;
+
+        public:
+            ScopedInstance(Ptr<VMInstance> instance);
+            ~ScopedInstance();
+    };
+
+}
@@ -3,14 +3,17 @@
 #include <javm/vm/vm_Thread.hpp>
 #include <javm/native/native_Standard.hpp>
 #include <javm/rt/rt_Context.hpp>
+#include <javm/rt/rt_Instance.hpp>
 
 namespace javm::rt {
 
     vm::ExecutionResult PrepareExecution();
 
-    inline void InitializeVM(const vm::PropertyTable &initial_system_props) {
+    // The max heap size (in bytes, 0 meaning unlimited) applies to the current VM instance: going over it throws java.lang.OutOfMemoryError
+    inline void InitializeVM(const vm::PropertyTable &initial_system_props, const u64 max_heap_size = 0) {
         native::RegisterNativeStandardImplementation();
         vm::SetInitialSystemProperties(initial_system_props);
+        GetCurrentInstance().heap.SetMaxSize(max_heap_size);
     }
 
     inline void ResetExecution() {
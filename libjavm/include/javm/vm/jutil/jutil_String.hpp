@@ -1,15 +1,55 @@
 
 #pragma once
 #include <javm/vm/vm_Variable.hpp>
+#include <unordered_map>
+#include <array>
 
 namespace javm::vm::jutil {
 
+    // Interned strings (literals and String.intern() results) of an instance, keyed by their contents
+    // Entries are weak, so interned strings nobody references anymore get freed as usual, and their entries get pruned as the table grows
+    // The table is split in independently locked shards, so that threads interning different strings rarely contend
+
+    class StringInternTable {
+        public:
+            static constexpr u32 ShardCount = 16;
+            static constexpr size_t MinPruneThreshold = 0x100;
+
+        private:
+            struct Shard {
+                Monitor lock;
+                std::unordered_map<String, std::weak_ptr<type::ClassInstance>> entries;
+                size_t prune_threshold = MinPruneThreshold;
+            };
+
+            std::array<Shard, ShardCount> shards;
+
+            inline Shard &GetShard(const String &native_str) {
+                return this->shards[std::hash<String>()(native_str) % ShardCount];
+            }
+
+            static void PruneExpiredEntries(Shard &shard);
+
+        public:
+            // Returns nullptr if no string with these contents is interned
+            Ptr<Variable> Find(const String &native_str);
+            // Returns the already interned string with the same contents if any, otherwise the given one (which gets interned)
+            Ptr<Variable> Insert(const String &native_str, Ptr<Variable> str_var);
+            void Clear();
+    };
+
+    // Strings created from natives aren't interned, unlike string literals (see InternString)
     Ptr<Variable> NewString(const String &native_str);
+    // Builds the string straight from its chars (copied into its value array) without running any String constructor, and without interning it
+    Ptr<Variable> NewStringFromChars(const char16_t *chars, const size_t length);
     void SetStringValue(Ptr<Variable> str_var, const String &native_str);
     String GetStringValue(Ptr<Variable> str_var);
+    // Zero-copy access to the string's chars, only valid while the string (thus its value array) is alive
+    std::u16string_view GetStringView(Ptr<Variable> str_var);
 
-    void InternString(const String &native_str);
-    void InternVariable(Ptr<Variable> str_var);
+    // Both return the interned string with these contents, interning it first if needed
+    Ptr<Variable> InternString(const String &native_str);
+    Ptr<Variable> InternVariable(Ptr<Variable> str_var);
 
     inline Ptr<Variable> NewUtf8String(const std::string &native_str) {
         return NewString(str::FromUtf8(native_str));
@@ -4,18 +4,22 @@
 
 namespace javm::vm::ref {
 
+    // There's a single reflection type for every type (see ReflectionTypeTable), which also holds its java.lang.Class variable once created
+
     class ReflectionType {
         private:
             VariableType type;
-            Ptr<ClassType> base_type;
+            // Class types keep their reflection types alive, so it must be weak to avoid a cycle
+            std::weak_ptr<ClassType> base_type;
             u32 array_dimensions;
             String type_name;
+            Ptr<Variable> class_var;
 
-            String ComputeTypeName();
+            String ComputeTypeName(Ptr<ClassType> class_type);
 
         public:
-            ReflectionType(Ptr<ClassType> class_type, const u32 array_dimensions = 0) : type(VariableType::ClassInstance), base_type(class_type), array_dimensions(array_dimensions), type_name(ComputeTypeName()) {}
-            ReflectionType(VariableType primitive_type, const u32 array_dimensions = 0) : type(primitive_type), array_dimensions(array_dimensions), type_name(ComputeTypeName()) {}
+            ReflectionType(Ptr<ClassType> class_type, const u32 array_dimensions = 0) : type(VariableType::ClassInstance), base_type(class_type), array_dimensions(array_dimensions), type_name(ComputeTypeName(class_type)) {}
+            ReflectionType(VariableType primitive_type, const u32 array_dimensions = 0) : type(primitive_type), array_dimensions(array_dimensions), type_name(ComputeTypeName(nullptr)) {}
 
             inline constexpr bool IsPrimitiveType() {
                 return IsPrimitiveVariableType(this->type);
@@ -42,23 +46,89 @@ namespace javm::vm::ref {
             }
 
             inline bool IsClassInstance() {
-                return this->base_type && (!this->IsPrimitive()) && (this->type == VariableType::ClassInstance);
+                return !this->base_type.expired() && (!this->IsPrimitive()) && (this->type == VariableType::ClassInstance);
             }
 
             inline Ptr<ClassType> GetClassType() {
-                return this->base_type;
+                return this->base_type.lock();
             }
 
             inline String GetTypeName() {
                 return this->type_name;
             }
+
+            // See NewClassTypeVariable
+            inline Ptr<Variable> GetClassVariable() {
+                return std::atomic_load(&this->class_var);
+            }
+
+            // Returns the variable which ended up set, since another thread might have set one first
+            inline Ptr<Variable> TrySetClassVariable(Ptr<Variable> var) {
+                Ptr<Variable> cur_var;
+                if(std::atomic_compare_exchange_strong(&this->class_var, &cur_var, var)) {
+                    return var;
+                }
+                return cur_var;
+            }
+    };
+
+    // Reflection types of a base type (class or primitive) and its array types, indexed by array dimensions
+    // Class types hold their own table, primitive types' tables are held by the VM instance
+
+    class ReflectionTypeTable {
+        private:
+            Ptr<ReflectionType> base_ref_type;
+            std::vector<Ptr<ReflectionType>> array_ref_types;
+            Monitor lock;
+
+        public:
+            template<typename Fn>
+            inline Ptr<ReflectionType> GetOrCreate(const u32 array_dimensions, Fn create_fn) {
+                if(array_dimensions == 0) {
+                    auto ref_type = std::atomic_load(&this->base_ref_type);
+                    if(ref_type) {
+                        return ref_type;
+                    }
+                }
+
+                ScopedMonitorLock lk(this->lock);
+                if(array_dimensions == 0) {
+                    auto ref_type = std::atomic_load(&this->base_ref_type);
+                    if(!ref_type) {
+                        ref_type = create_fn();
+                        std::atomic_store(&this->base_ref_type, ref_type);
+                    }
+                    return ref_type;
+                }
+                if(array_dimensions > this->array_ref_types.size()) {
+                    this->array_ref_types.resize(array_dimensions);
+                }
+                auto &ref_type = this->array_ref_types[array_dimensions - 1];
+                if(!ref_type) {
+                    ref_type = create_fn();
+                }
+                return ref_type;
+            }
+
+            inline void Clear() {
+                ScopedMonitorLock lk(this->lock);
+                std::atomic_store(&this->base_ref_type, Ptr<ReflectionType>());
+                this->array_ref_types.clear();
+            }
     };
 
     inline bool EqualTypes(Ptr<ReflectionType> t_a, Ptr<ReflectionType> t_b) {
         return t_a->GetTypeName() == t_b->GetTypeName();
     }
 
+    Ptr<ReflectionType> GetReflectionType(Ptr<ClassType> class_type, const u32 array_dimensions = 0);
+    Ptr<ReflectionType> GetPrimitiveReflectionType(const VariableType primitive_type, const u32 array_dimensions = 0);
+
     Ptr<ReflectionType> FindReflectionTypeByName(const String &name);
     Ptr<ReflectionType> FindArrayReflectionType(Ptr<Array> &array);
 
+    // Reflection type of a java.lang.Class variable (created by NewClassTypeVariable), nullptr if it isn't one
+    Ptr<ReflectionType> FindReflectionTypeByClassVariable(Ptr<Variable> class_var);
+    void RegisterClassVariable(Ptr<ReflectionType> ref_type, Ptr<Variable> class_var);
+
 }
\ No newline at end of file
@@ -5,24 +5,155 @@
 
 namespace javm::vm {
 
-    // Note: the inner object inside an array is only used to call Object methods and for its monitor
+    // Calls the function with a typed pointer to primitive array storage (see Array::GetPrimitiveData)
+
+    template<typename Fn>
+    inline void VisitPrimitiveArrayData(const VariableType type, void *data, Fn fn) {
+        switch(type) {
+            case VariableType::Byte:
+            case VariableType::Boolean: {
+                fn(reinterpret_cast<i8*>(data));
+                break;
+            }
+            case VariableType::Short: {
+                fn(reinterpret_cast<i16*>(data));
+                break;
+            }
+            case VariableType::Character: {
+                fn(reinterpret_cast<u16*>(data));
+                break;
+            }
+            case VariableType::Integer: {
+                fn(reinterpret_cast<i32*>(data));
+                break;
+            }
+            case VariableType::Long: {
+                fn(reinterpret_cast<i64*>(data));
+                break;
+            }
+            case VariableType::Float: {
+                fn(reinterpret_cast<float*>(data));
+                break;
+            }
+            case VariableType::Double: {
+                fn(reinterpret_cast<double*>(data));
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Pinned access to the storage of a primitive array, for natives doing bulk work on it (I/O, copies, hashing...) without copying elements
+    // Storage never moves, and the pin holds the block it lives in, so the data stays valid while the pin lives, even if the array itself gets freed meanwhile
+    // Natives should only keep it for the duration of their call (see Array::PinPrimitiveData)
+
+    class PinnedArrayData {
+        private:
+            std::shared_ptr<u8[]> block;
+            u8 *data;
+            u32 length;
+            VariableType type;
+
+        public:
+            PinnedArrayData() : data(nullptr), length(0), type(VariableType::Invalid) {}
+            PinnedArrayData(std::shared_ptr<u8[]> block, u8 *data, const u32 length, const VariableType type) : block(block), data(data), length(length), type(type) {}
+
+            // Pins of null or non-primitive arrays are invalid
+            inline bool IsValid() const {
+                return this->data != nullptr;
+            }
+
+            inline VariableType GetVariableType() const {
+                return this->type;
+            }
+
+            inline u32 GetLength() const {
+                return this->length;
+            }
+
+            // Same element storage as Array::GetPrimitiveData
+            template<typename E>
+            inline E *GetData() const {
+                return reinterpret_cast<E*>(this->data);
+            }
+
+            // Size of the data in bytes
+            inline size_t GetSize() const;
+
+            // Whether the given element range (like the usual offset/length pairs of I/O methods) is within the array
+            inline bool IsValidRange(const type::Integer offset, const type::Integer count) const {
+                return (offset >= 0) && (count >= 0) && ((static_cast<u64>(offset) + static_cast<u64>(count)) <= this->length);
+            }
+    };
 
-    class Array {
+    // Arrays have no class instance: their (java.lang.Object) methods are dispatched through the class type, and the array itself holds the lock word
+    // One-dimensional primitive arrays keep their elements unboxed in zero-initialized contiguous storage, the rest keep variable slots
+    // That storage might be part of a block shared with other arrays (the innermost arrays of a multi-dimensional one), which lives as long as any of them
+
+    class Array : public MonitoredItem {
         private:
             VariableType type;
             Ptr<ClassType> class_type;
-            std::vector<Ptr<Variable>> inner_array;
+            std::vector<VariableSlot> inner_array;
+            std::shared_ptr<u8[]> primitive_block;
+            u8 *primitive_data;
             u32 length;
             u32 dimensions;
-            Ptr<ClassInstance> inner_object;
 
             Ptr<Variable> MakeDefaultVariable();
-            static Ptr<ClassInstance> CreateInnerObject();
 
         public:
-            Array(VariableType type, const u32 length, const u32 dimensions = 1) : type(type), inner_array(length), length(length), dimensions(dimensions), inner_object(CreateInnerObject()) {}
+            Array(VariableType type, const u32 length, const u32 dimensions = 1) : type(type), primitive_data(nullptr), length(length), dimensions(dimensions) {
+                if(this->IsPrimitiveArray()) {
+                    this->primitive_block = NewPrimitiveBlock(static_cast<size_t>(length) * GetElementSize(type));
+                    this->primitive_data = this->primitive_block.get();
+                }
+                else {
+                    this->inner_array.resize(length);
+                }
+            }
+
+            // Primitive array using (zero-initialized) storage inside the given block
+            Array(VariableType type, const u32 length, std::shared_ptr<u8[]> block, u8 *data) : type(type), primitive_block(block), primitive_data(data), length(length), dimensions(1) {}
+
+            Array(Ptr<ClassType> type, const u32 length, const u32 dimensions = 1) : type(VariableType::ClassInstance), class_type(type), inner_array(length), primitive_data(nullptr), length(length), dimensions(dimensions) {}
+
+            static inline std::shared_ptr<u8[]> NewPrimitiveBlock(const size_t size) {
+                return std::shared_ptr<u8[]>(new u8[size]());
+            }
+
+            // Storage size of a single element
+            static inline constexpr u64 GetElementSize(const VariableType type, const u32 dimensions = 1) {
+                if(dimensions > 1) {
+                    return sizeof(Ptr<Variable>);
+                }
+                switch(type) {
+                    case VariableType::Byte:
+                    case VariableType::Boolean:
+                        return sizeof(i8);
+                    case VariableType::Short:
+                    case VariableType::Character:
+                        return sizeof(i16);
+                    case VariableType::Integer:
+                    case VariableType::Float:
+                        return sizeof(i32);
+                    case VariableType::Long:
+                    case VariableType::Double:
+                        return sizeof(i64);
+                    default:
+                        return sizeof(Ptr<Variable>);
+                }
+            }
+
+            // Approximate size of an array, as accounted by the heap (lazily created element variables aren't included)
+            static inline constexpr u64 GetAllocationSize(const u32 length, const u64 elem_size = sizeof(Ptr<Variable>)) {
+                return sizeof(Array) + static_cast<u64>(length) * elem_size;
+            }
 
-            Array(Ptr<ClassType> type, const u32 length, const u32 dimensions = 1) : type(VariableType::ClassInstance), class_type(type), inner_array(length), length(length), dimensions(dimensions), inner_object(CreateInnerObject()) {}
+            inline u64 GetAllocationSize() {
+                return GetAllocationSize(this->length, GetElementSize(this->type, this->dimensions));
+            }
 
             inline VariableType GetVariableType() {
                 return this->type;
@@ -36,12 +167,12 @@ namespace javm::vm {
                 return this->dimensions > 1;
             }
 
-            inline Ptr<ClassType> GetClassType() {
-                return this->class_type;
+            inline bool IsPrimitiveArray() {
+                return (this->dimensions == 1) && IsPrimitiveVariableType(this->type);
             }
 
-            inline Ptr<ClassInstance> GetObjectInstance() {
-                return this->inner_object;
+            inline Ptr<ClassType> GetClassType() {
+                return this->class_type;
             }
 
             bool CanCastTo(const String &class_name);
@@ -54,12 +185,54 @@ namespace javm::vm {
                 return this->dimensions;
             }
 
+            // Raw storage slot of non-primitive arrays (no bounds check), for atomic accesses (see AtomicLoadSlot and similar)
+            inline VariableSlot &GetSlotAt(const u32 idx) {
+                return this->inner_array[idx];
+            }
+
+            // Raw storage of primitive arrays: byte/boolean as i8, short as i16, char as u16, int as i32, long as i64, float and double as themselves
+            template<typename E>
+            inline E *GetPrimitiveData() {
+                return reinterpret_cast<E*>(this->primitive_data);
+            }
+
+            // Raw element address of primitive arrays (no bounds check)
+            inline void *GetElementAddressAt(const u32 idx) {
+                return this->primitive_data + static_cast<size_t>(idx) * GetElementSize(this->type);
+            }
+
+            // Invalid pin if this isn't a primitive array
+            inline PinnedArrayData PinPrimitiveData() {
+                if(!this->IsPrimitiveArray()) {
+                    return {};
+                }
+                return { this->primitive_block, this->primitive_data, this->length, this->type };
+            }
+
+            // Primitive elements are boxed into new variables on load, and narrowed to the element type on store
             Ptr<Variable> GetAt(const u32 idx);
             bool SetAt(const u32 idx, Ptr<Variable> var);
 
-            inline ExecutionResult CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const std::vector<Ptr<Variable>> &param_vars) {
-                return this->inner_object->CallInstanceMethod(name, descriptor, this_as_var, param_vars);
+            // Garbage collector support, like ClassInstance (arrays hold no inner objects, so the object function is never called)
+
+            template<typename VarFn, typename ObjFn>
+            inline void VisitReferences(VarFn var_fn, ObjFn) {
+                for(auto &slot: this->inner_array) {
+                    var_fn(slot);
+                }
             }
+
+            inline void ClearReferences() {
+                for(auto &slot: this->inner_array) {
+                    slot.var.reset();
+                }
+            }
+
+            ExecutionResult CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const VariableSpan &param_vars);
     };
 
+    inline size_t PinnedArrayData::GetSize() const {
+        return static_cast<size_t>(this->length) * Array::GetElementSize(this->type);
+    }
+
 }
\ No newline at end of file
@@ -2,9 +2,16 @@
 #pragma once
 #include <javm/vm/vm_TypeBase.hpp>
 #include <javm/vm/vm_Sync.hpp>
+#include <javm/vm/vm_Heap.hpp>
 #include <javm/vm/vm_Attributes.hpp>
 #include <javm/native/native_NativeCode.hpp>
 
+namespace javm::vm::ref {
+
+    class ReflectionTypeTable;
+
+}
+
 namespace javm::vm {
 
     class ClassBaseField : public AccessFlagsItem, public AttributesItem {
@@ -47,21 +54,33 @@ namespace javm::vm {
 
     class ClassField : public ClassBaseField {
         private:
-            Ptr<Variable> var;
+            VariableSlot var;
+            // Parsed once from the descriptor, needed for default values
+            VariableType var_type;
 
         public:
-            using ClassBaseField::ClassBaseField;
+            ClassField(const NameAndTypeData nat, const u16 flags, const std::vector<AttributeInfo> &attrs, ConstantPool &pool) : ClassBaseField(nat, flags, attrs, pool), var_type(GetVariableTypeByDescriptor(nat.processed_desc)) {}
 
-            inline void SetVariable(Ptr<Variable> new_var) {
-                this->var = new_var;
+            // Lazily creates the default value if the field wasn't set yet
+            // Volatile fields are always accessed atomically
+            Ptr<Variable> GetVariable();
+            void SetVariable(Ptr<Variable> new_var);
+
+            inline bool HasVariable() {
+                return ptr::IsValid(this->var.var);
             }
 
-            inline Ptr<Variable> GetVariable() const {
+            inline bool IsVolatile() const {
+                return this->HasFlag<AccessFlags::Volatile>();
+            }
+
+            // Raw storage slot, for atomic accesses (see AtomicLoadSlot and similar)
+            inline VariableSlot &GetVariableSlot() {
                 return this->var;
             }
 
-            inline bool HasVariable() {
-                return ptr::IsValid(this->var);
+            inline VariableType GetVariableType() const {
+                return this->var_type;
             }
     };
 
@@ -70,18 +89,32 @@ namespace javm::vm {
             using ClassBaseField::ClassBaseField;
     };
 
-    class MonitoredItem {
-        protected:
-            Ptr<Monitor> monitor;
+    // Subtype checks compare against the supertypes of a class instead of walking its hierarchy:
+    // - primary supers: super class chain, indexed by depth (java.lang.Object is at 0), so checking against a class is a single indexed compare
+    // - secondary supers: every interface implemented (directly or not), which gets scanned
+    // Supertypes are held strongly (they never reference their subtypes, so no cycles are made)
 
-        public:
-            MonitoredItem() : monitor(ptr::New<Monitor>()) {}
+    struct ClassHierarchyDisplay {
+        u32 depth;
+        std::vector<Ptr<ClassType>> primary_supers;
+        std::vector<Ptr<ClassType>> secondary_supers;
+    };
 
-            inline Ptr<Monitor> GetMonitor() {
-                return this->monitor;
-            }
+    // Initialization states (JVMS 5.5), only moved forward while holding the class's initialization lock
+
+    enum class ClassInitializationState : u8 {
+        NotInitialized,
+        BeingInitialized,
+        Initialized,
+        Erroneous
     };
 
+    // Variadic call helpers take separate Java arguments: already built parameter lists (vectors, spans) must go to the span overloads instead
+    // Otherwise the template would be an exact match for them, and the helpers would end up calling themselves
+
+    template<typename ...JArgs>
+    inline constexpr bool IsJavaArgumentList = !(std::is_convertible_v<JArgs, const VariableSpan&> || ...);
+
     class ClassType : public AccessFlagsItem, public MonitoredItem {
         private:
             String class_name;
@@ -90,13 +123,28 @@ namespace javm::vm {
             std::vector<String> interface_class_names;
             std::vector<ClassBaseField> fields;
             std::vector<ClassBaseField> invokables;
-            std::vector<ClassField> static_fields;
-            bool static_block_called;
+            // Native implementations of the invokables (parallel to them), bound when first called
+            std::unique_ptr<native::NativeBinding[]> native_bindings;
+            // Static fields are laid out in a flat slot array (parallel to their declarations), filled with default values when the class is created
+            std::vector<ClassBaseField> static_fields;
+            std::vector<VariableType> static_types;
+            std::vector<VariableSlot> static_slots;
+            std::atomic<ClassInitializationState> init_state;
+            // Lock id (see GetCurrentLockOwnerId) of the thread running the initializer while being initialized
+            u32 init_thread_id;
+            Monitor init_lock;
             bool static_block_enabled;
             ConstantPool pool;
+            std::atomic<u64> instance_size;
+            Ptr<ref::ReflectionTypeTable> ref_types;
+            // Computed when first needed, since super types might not be loadable until then
+            std::atomic<ClassHierarchyDisplay*> hierarchy_display;
+
+            ClassHierarchyDisplay *ComputeHierarchyDisplay();
 
         public:
             ClassType(const String &name, const String &super_name, const String &source_file, const std::vector<String> &interface_names, const std::vector<ClassBaseField> &fields, const std::vector<ClassBaseField> &invokables, const u16 flags, ConstantPool pool);
+            ~ClassType();
 
             inline String GetClassName() {
                 return this->class_name;
@@ -125,6 +173,9 @@ namespace javm::vm {
                 return !this->interface_class_names.empty();
             }
 
+            // Approximate size of an instance (including its super class and interface instances), as accounted by the heap
+            u64 GetInstanceSize();
+
             inline std::vector<ClassBaseField> &GetRawFields() {
                 return this->fields;
             }
@@ -133,6 +184,10 @@ namespace javm::vm {
                 return this->invokables;
             }
 
+            inline native::NativeBinding &GetNativeBinding(const u32 invokable_idx) {
+                return this->native_bindings[invokable_idx];
+            }
+
             type::Integer GetRawFieldUnsafeOffset(const String &name, const String &descriptor);
             bool IsRawFieldStatic(const String &name, const String &descriptor);
 
@@ -144,7 +199,20 @@ namespace javm::vm {
                 this->static_block_enabled = false;
             }
 
-            ExecutionResult EnsureStaticInitializerCalled();
+            inline bool IsInitialized() {
+                return this->init_state.load(std::memory_order_acquire) == ClassInitializationState::Initialized;
+            }
+
+            // Initializes the class (super classes first) if it isn't yet, waiting for any other thread already doing it
+            // Once initialized this is a single load, so callers can check it on every access
+            inline ExecutionResult EnsureStaticInitializerCalled() {
+                if(this->IsInitialized()) {
+                    return ExecutionResult::Void();
+                }
+                return this->Initialize();
+            }
+
+            ExecutionResult Initialize();
 
             inline std::vector<ClassBaseField> &GetFields() {
                 return this->fields;
@@ -158,22 +226,74 @@ namespace javm::vm {
                 return this->pool;
             }
 
-            ExecutionResult CallClassMethod(const String &name, const String &descriptor, const std::vector<Ptr<Variable>> &param_vars);
+            // Reflection types of this class and its array types (see ref::GetReflectionType)
+            inline ref::ReflectionTypeTable &GetReflectionTypeTable() {
+                return *this->ref_types;
+            }
+
+            ExecutionResult CallClassMethod(const String &name, const String &descriptor, const VariableSpan &param_vars);
             bool HasClassMethod(const String &name, const String &descriptor);
 
-            template<typename ...JArgs>
+            // Calls this class's (or a super class's) instance method on the given object without any class instance, only valid for methods not touching member fields
+            // Used by arrays, which dispatch java.lang.Object methods this way
+            ExecutionResult CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const VariableSpan &param_vars);
+
+            template<typename ...JArgs, std::enable_if_t<IsJavaArgumentList<JArgs...>, int> = 0>
             inline ExecutionResult CallClassMethod(const String &name, const String &descriptor, JArgs &&...java_args) {
                 const std::vector<Ptr<Variable>> param_vars = { std::forward<JArgs>(java_args)... };
-                return this->CallClassMethod(name, descriptor, param_vars);
+                return this->CallClassMethod(name, descriptor, VariableSpan(param_vars));
             }
 
+            // Name-based accessors (for natives and the runtime), the interpreter resolves field references to a slot once instead
             Ptr<Variable> GetStaticField(const String &name, const String &descriptor);
             void SetStaticField(const String &name, const String &descriptor, Ptr<Variable> var);
             bool HasStaticField(const String &name, const String &descriptor);
 
-            Ptr<Variable> GetStaticFieldByUnsafeOffset(const type::Integer offset);
-            void SetStaticFieldByUnsafeOffset(const type::Integer offset, Ptr<Variable> var);
+            // Slot of a static field declared by this class, -1 if not found
+            i32 FindStaticFieldSlot(const String &name, const String &descriptor);
+            // Field resolution (JVMS 5.4.3.2): this class, then its super interfaces, then its super class
+            // Returns the class declaring the field (nullptr if not found), and sets the slot index within it
+            Ptr<ClassType> ResolveStaticField(const String &name, const String &descriptor, u32 &out_slot);
+
+            // Slot accessors (no bounds checks), the class must be initialized first
+            // Volatile fields are always accessed atomically
+            Ptr<Variable> GetStaticFieldAt(const u32 slot);
+            void SetStaticFieldAt(const u32 slot, Ptr<Variable> var);
+
+            inline u32 GetStaticFieldCount() {
+                return this->static_slots.size();
+            }
+
+            // Raw storage slot, for atomic accesses (see AtomicLoadSlot and similar)
+            inline VariableSlot &GetStaticFieldSlot(const u32 slot) {
+                return this->static_slots[slot];
+            }
+
+            inline VariableType GetStaticFieldType(const u32 slot) {
+                return this->static_types[slot];
+            }
+
+            // Drops every static field value (used when tearing down a VM instance)
+            inline void ClearStaticFields() {
+                for(auto &slot: this->static_slots) {
+                    slot.var.reset();
+                }
+            }
+
+            inline ClassHierarchyDisplay &GetHierarchyDisplay() {
+                auto display = this->hierarchy_display.load(std::memory_order_acquire);
+                if(display == nullptr) {
+                    display = this->ComputeHierarchyDisplay();
+                }
+                return *display;
+            }
+
+            inline bool IsInterface() {
+                return this->HasFlag<AccessFlags::Interface>();
+            }
 
+            bool IsSubtypeOf(ClassType &other);
+            // Same as locating the class and checking it as above, falling back to comparing names if it can't be located
             bool CanCastTo(const String &class_name);
 
             LineNumberTable GetMethodLineNumberTable(const String &name, const String &descriptor);
@@ -214,20 +334,36 @@ namespace javm::vm {
             void SetField(const String &name, const String &descriptor, Ptr<Variable> var);
             bool HasField(const String &name, const String &descriptor);
 
-            Ptr<Variable> GetFieldByUnsafeOffset(const type::Integer offset);
-            void SetFieldByUnsafeOffset(const type::Integer offset, Ptr<Variable> var);
+            // Note: the offset is relative to this instance's class, not to super classes
+            ClassField *GetFieldByUnsafeOffset(const type::Integer offset);
+
+            ExecutionResult CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const VariableSpan &param_vars);
 
-            ExecutionResult CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const std::vector<Ptr<Variable>> &param_vars);
+            // Garbage collector support: visit every reference this instance holds (super/interface instances are visited as objects)
 
-            template<typename ...JArgs>
+            template<typename VarFn, typename ObjFn>
+            inline void VisitReferences(VarFn var_fn, ObjFn obj_fn) {
+                for(auto &field: this->member_fields) {
+                    var_fn(field.GetVariableSlot());
+                }
+                obj_fn(this->super_class_instance);
+                for(auto &intf_instance: this->interface_instances) {
+                    obj_fn(intf_instance);
+                }
+            }
+
+            void ClearReferences();
+
+            template<typename ...JArgs, std::enable_if_t<IsJavaArgumentList<JArgs...>, int> = 0>
             inline ExecutionResult CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, JArgs &&...java_args) {
                 const std::vector<Ptr<Variable>> param_vars = { std::forward<JArgs>(java_args)... };
-                return this->CallInstanceMethod(name, descriptor, this_as_var, param_vars);
+                return this->CallInstanceMethod(name, descriptor, this_as_var, VariableSpan(param_vars));
             }
 
-            template<typename ...JArgs>
+            template<typename ...JArgs, std::enable_if_t<IsJavaArgumentList<JArgs...>, int> = 0>
             inline ExecutionResult CallConstructor(Ptr<Variable> this_as_var, const String &descriptor, JArgs &&...java_args) {
-                return this->CallInstanceMethod(u"<init>", descriptor, this_as_var, java_args...);
+                const std::vector<Ptr<Variable>> param_vars = { std::forward<JArgs>(java_args)... };
+                return this->CallInstanceMethod(u"<init>", descriptor, this_as_var, VariableSpan(param_vars));
             }
     };
 
@@ -2,9 +2,13 @@
 #pragma once
 #include <javm/javm_Memory.hpp>
 #include <javm/vm/vm_Base.hpp>
+#include <atomic>
 
 namespace javm::vm {
 
+    class Variable;
+    class ClassType;
+
     enum class ConstantPoolTag : u8 {
         Invalid = 0,
         Utf8 = 1,
@@ -201,9 +205,21 @@ namespace javm::vm {
             InstanceMethodHandleData method_handle;
             InstanceMethodTypeData method_type;
             InvokeDynamicData invoke_dynamic;
+
+            // Value of loadable constants (see LDC/LDC_W/LDC2_W), resolved when first loaded: the item owns the first resolved value, which gets published through the raw pointer
+            Ptr<Variable> resolved_var_ref;
+            std::atomic_bool resolved_var_claimed;
+            std::atomic<Variable*> resolved_var;
+            // Class constants used in type checks (CHECKCAST/INSTANCEOF/exception handlers): class type resolved when first checked, and the last class type which passed the check
+            // Class types stay loaded (owned by their class sources) for as long as the instance lives, so raw pointers are enough
+            std::atomic<ClassType*> resolved_class_type;
+            std::atomic<ClassType*> last_subtype;
+            // Static field references (see GETSTATIC/PUTSTATIC): class declaring the field and its static slot, resolved when first accessed
+            std::atomic<ClassType*> resolved_field_class_type;
+            std::atomic<u32> resolved_field_slot;
             
         public:
-            ConstantPoolItem() : tag(ConstantPoolTag::Invalid), empty(true) {}
+            ConstantPoolItem() : tag(ConstantPoolTag::Invalid), empty(true), resolved_var_claimed(false), resolved_var(nullptr), resolved_class_type(nullptr), last_subtype(nullptr), resolved_field_class_type(nullptr), resolved_field_slot(0) {}
             ConstantPoolItem(MemoryReader &reader);
 
             inline ConstantPoolTag GetTag() {
@@ -258,6 +274,62 @@ namespace javm::vm {
                 return this->invoke_dynamic;
             }
 
+            // Variables are never modified once created, so the same one can be pushed every time
+            // The owning reference is written before the pointer gets published, and never again until teardown
+            inline Ptr<Variable> GetResolvedVariable() {
+                if(this->resolved_var.load(std::memory_order_acquire) != nullptr) {
+                    return this->resolved_var_ref;
+                }
+                return nullptr;
+            }
+
+            // Only the first thread resolving the constant gets to cache it, others just use their own (equal) value
+            inline void SetResolvedVariable(Ptr<Variable> var) {
+                if(!this->resolved_var_claimed.exchange(true, std::memory_order_relaxed)) {
+                    this->resolved_var_ref = var;
+                    this->resolved_var.store(var.get(), std::memory_order_release);
+                }
+            }
+
+            inline ClassType *GetResolvedClassType() {
+                return this->resolved_class_type.load(std::memory_order_acquire);
+            }
+
+            inline void SetResolvedClassType(ClassType *class_type) {
+                this->resolved_class_type.store(class_type, std::memory_order_release);
+            }
+
+            inline ClassType *GetLastSubtype() {
+                return this->last_subtype.load(std::memory_order_acquire);
+            }
+
+            inline void SetLastSubtype(ClassType *class_type) {
+                this->last_subtype.store(class_type, std::memory_order_release);
+            }
+
+            // The slot is written before the class type gets published (with release), so whoever sees the class type (with acquire) sees the slot too
+            // Concurrent resolutions always store the same class type and slot, so they don't need to be ordered among themselves
+            inline ClassType *GetResolvedFieldClassType(u32 &out_slot) {
+                auto class_type = this->resolved_field_class_type.load(std::memory_order_acquire);
+                out_slot = this->resolved_field_slot.load(std::memory_order_relaxed);
+                return class_type;
+            }
+
+            inline void SetResolvedField(ClassType *class_type, const u32 slot) {
+                this->resolved_field_slot.store(slot, std::memory_order_relaxed);
+                this->resolved_field_class_type.store(class_type, std::memory_order_release);
+            }
+
+            // Resolved class types reference each other through their constant pools, these cycles need to be broken when tearing down
+            inline void ClearResolvedItems() {
+                this->resolved_var.store(nullptr);
+                this->resolved_var_ref.reset();
+                this->resolved_var_claimed.store(false);
+                this->resolved_class_type.store(nullptr);
+                this->last_subtype.store(nullptr);
+                this->resolved_field_class_type.store(nullptr);
+            }
+
             inline constexpr bool IsEmpty() {
                 if(this->empty) {
                     return true;
@@ -295,6 +367,14 @@ namespace javm::vm {
             inline void InsertEmptyItem() {
                 this->InsertItem(nullptr);
             }
+
+            inline void ClearResolvedItems() {
+                for(auto &item: this->inner_pool) {
+                    if(item) {
+                        item->ClearResolvedItems();
+                    }
+                }
+            }
     };
 
 }
\ No newline at end of file
@@ -6,48 +6,70 @@
 
 namespace javm::vm {
 
-    class ExecutionFrame {
-        private:
-            enum class VariableStackMode {
-                FixedSize, // Locals
-                Growable // Stack
+    // Per-thread stack of variable slots, backing every frame's locals and operand stack
+    // Frames are strictly nested, so slots are just bump-allocated and released (cleared) in LIFO order
+    // Slots live in fixed chunks which are never reallocated, so pointers to them stay valid until released
+
+    class VariableArena {
+        public:
+            static constexpr size_t ChunkSlotCount = 0x1000;
+
+            struct Mark {
+                size_t chunk_idx;
+                size_t used;
             };
 
-            class VariableStack {
-                private:
-                    std::vector<Ptr<Variable>> inner_list;
-                    VariableStackMode stack_mode;
+        private:
+            struct Chunk {
+                std::unique_ptr<Ptr<Variable>[]> slots;
+                size_t capacity;
+                size_t used;
+            };
 
-                    constexpr inline bool IsFixedSize() {
-                        return this->stack_mode == VariableStackMode::FixedSize;
-                    }
+            std::vector<Chunk> chunks;
+            size_t cur_chunk_idx;
 
-                    constexpr inline bool IsGrowable() {
-                        return this->stack_mode == VariableStackMode::Growable;
-                    }
+        public:
+            VariableArena() : cur_chunk_idx(0) {}
 
-                public:
-                    VariableStack(const VariableStackMode mode) : stack_mode(mode) {}
+            inline Mark GetMark() {
+                if(this->chunks.empty()) {
+                    return { 0, 0 };
+                }
+                return { this->cur_chunk_idx, this->chunks[this->cur_chunk_idx].used };
+            }
 
-                    void ResetFill(Ptr<Variable> this_var, const u16 length);
-                    Ptr<Variable> GetAt(const u32 idx);
-                    void SetAt(const u32 idx, Ptr<Variable> var);
+            Ptr<Variable> *Allocate(const size_t count);
+            // Grows the last allocation (ending at the given slot) in place, if its chunk has room
+            bool TryExtend(Ptr<Variable> *block_end, const size_t count);
+            void Release(const Mark &mark);
+    };
 
-                    Ptr<Variable> Pop();
-                    void Push(Ptr<Variable> var);
-            };
+    VariableArena &GetCurrentThreadVariableArena();
 
+    class ExecutionFrame {
         private:
-            VariableStack stack;
-            VariableStack locals;
+            VariableArena &arena;
+            VariableArena::Mark arena_mark;
+            Ptr<Variable> *locals;
+            u32 locals_count;
+            Ptr<Variable> *stack;
+            u32 stack_size;
+            u32 stack_capacity;
             ConstantPool &exec_pool;
-            std::vector<ExceptionTableEntry> exc_table;
+            const std::vector<ExceptionTableEntry> &exc_table;
             const u8 *code_ptr;
             u32 code_offset;
 
+            void GrowStack();
+
         public:
-            ExecutionFrame(const u8 *raw_code, const u16 max_locals, const std::vector<ExceptionTableEntry> &exc_table, ConstantPool &pool, Ptr<Variable> this_var = nullptr) : stack(VariableStackMode::Growable), locals(VariableStackMode::FixedSize), exec_pool(pool), exc_table(exc_table), code_ptr(raw_code), code_offset(0) {
-                this->locals.ResetFill(this_var, max_locals);
+            ExecutionFrame(const u8 *raw_code, const u32 locals_count, const u16 max_stack, const std::vector<ExceptionTableEntry> &exc_table, ConstantPool &pool);
+            ExecutionFrame(const ExecutionFrame&) = delete;
+            ExecutionFrame &operator=(const ExecutionFrame&) = delete;
+
+            ~ExecutionFrame() {
+                this->arena.Release(this->arena_mark);
             }
 
             inline ConstantPool &GetThisConstantPool() {
@@ -55,19 +77,58 @@ namespace javm::vm {
             }
 
             inline Ptr<Variable> GetLocalAt(const u32 idx) {
-                return this->locals.GetAt(idx);
+                if(idx < this->locals_count) {
+                    return this->locals[idx];
+                }
+                return nullptr;
             }
 
             inline void SetLocalAt(const u32 idx, Ptr<Variable> var) {
-                this->locals.SetAt(idx, var);
+                if(idx < this->locals_count) {
+                    this->locals[idx] = std::move(var);
+                }
             }
 
             inline Ptr<Variable> PopStack() {
-                return this->stack.Pop();
+                if(this->stack_size == 0) {
+                    return nullptr;
+                }
+                this->stack_size--;
+                return std::move(this->stack[this->stack_size]);
             }
 
             inline void PushStack(Ptr<Variable> var) {
-                this->stack.Push(var);
+                if(this->stack_size == this->stack_capacity) {
+                    this->GrowStack();
+                }
+                this->stack[this->stack_size] = std::move(var);
+                this->stack_size++;
+            }
+
+            // The top variables (in push order), which stay in the stack until dropped
+            inline VariableSpan PeekStack(const u32 count) {
+                const auto span_count = std::min(count, this->stack_size);
+                return VariableSpan(this->stack + (this->stack_size - span_count), span_count);
+            }
+
+            // Variable under the top ones (0 being the top one)
+            inline Ptr<Variable> PeekStackAt(const u32 depth) {
+                if(depth < this->stack_size) {
+                    return this->stack[this->stack_size - depth - 1];
+                }
+                return nullptr;
+            }
+
+            inline void DropStack(const u32 count) {
+                const auto drop_count = std::min(count, this->stack_size);
+                for(u32 i = 0; i < drop_count; i++) {
+                    this->stack_size--;
+                    this->stack[this->stack_size].reset();
+                }
+            }
+
+            inline void ClearStack() {
+                this->DropStack(this->stack_size);
             }
 
             template<typename T>
@@ -100,8 +161,8 @@ namespace javm::vm {
             void NotifyThrown();
     };
 
-    ExecutionResult ExecuteStaticCode(const u8 *code_ptr, const u16 max_locals, const std::vector<ExceptionTableEntry> &exc_table, ConstantPool &pool, const std::vector<Ptr<Variable>> &param_vars);
-    ExecutionResult ExecuteCode(const u8 *code_ptr, const u16 max_locals, const std::vector<ExceptionTableEntry> &exc_table, Ptr<Variable> this_var, ConstantPool &pool, const std::vector<Ptr<Variable>> &param_vars);
+    ExecutionResult ExecuteStaticCode(const u8 *code_ptr, const u16 max_locals, const u16 max_stack, const std::vector<ExceptionTableEntry> &exc_table, ConstantPool &pool, const VariableSpan &param_vars);
+    ExecutionResult ExecuteCode(const u8 *code_ptr, const u16 max_locals, const u16 max_stack, const std::vector<ExceptionTableEntry> &exc_table, Ptr<Variable> this_var, ConstantPool &pool, const VariableSpan &param_vars);
 
     inline ExecutionResult ThrowExisting(Ptr<Variable> throwable_v, const bool is_catchable = true) {
         return ExecutionResult::Throw(throwable_v, is_catchable);
@@ -0,0 +1,226 @@
+#pragma once
+#include <javm/vm/vm_TypeBase.hpp>
+#include <javm/vm/vm_Sync.hpp>
+
+namespace javm::native {
+
+    class Thread;
+
+}
+
+namespace javm::vm {
+
+    // Objects are still owned through shared pointers, which free everything except cycles
+    // The heap keeps (weak) track of every object and arrays, so that the collector can find and break unreachable cycles
+
+    struct HeapEntry {
+        std::weak_ptr<void> ref;
+        // Accounted bytes, released once the entry is pruned
+        u64 size;
+        bool is_array;
+    };
+
+    class ParallelMarker;
+    class CycleCollector;
+
+    class Heap {
+        public:
+            static constexpr u64 MinCollectionThreshold = 0x4000;
+            static constexpr u32 SafepointTimeoutMs = 10;
+            // Collections attempted before giving up on an allocation which doesn't fit under the heap limit
+            static constexpr u32 OutOfMemoryCollectionAttemptCount = 3;
+            // Unused soft references are kept this long (in ms) for every free MB in the heap
+            static constexpr type::Long SoftReferenceMsPerFreeMB = 1000;
+
+        private:
+            Monitor lock;
+            std::vector<HeapEntry> entries;
+            u64 collection_threshold;
+            std::atomic<u64> used_size;
+            std::atomic<u64> metadata_size;
+            u64 max_size;
+            u32 marker_worker_count;
+            ParallelMarker *active_marker;
+            bool concurrent_mark;
+            std::atomic_bool collecting;
+            std::atomic_bool satb_active;
+            Monitor satb_lock;
+            std::vector<void*> satb_log;
+            Ptr<CycleCollector> concurrent_collector;
+            Ptr<native::Thread> concurrent_thread;
+            u64 collection_count;
+            u64 collected_object_count;
+
+            void PruneExpiredEntries();
+            bool DoCollect(const bool concurrent, const bool clear_soft_refs);
+            type::Long GetSoftReferenceMaxAge(const bool clear_soft_refs);
+            void EnqueuePendingReferences(CycleCollector &collector, std::vector<Ptr<Variable>> &pending_refs);
+            void FinishCollection(const u64 collected_count);
+            void JoinConcurrentCycle();
+            std::vector<void*> TakeSATBLog();
+
+        public:
+            Heap() : collection_threshold(MinCollectionThreshold), used_size(0), metadata_size(0), max_size(0), marker_worker_count(1), active_marker(nullptr), concurrent_mark(false), collecting(false), satb_active(false), collection_count(0), collected_object_count(0) {}
+
+            // Takes the entries allocated by a thread (see FlushThreadHeapBuffer), returns whether a collection should be attempted
+            bool AddEntries(std::vector<HeapEntry> &thread_entries);
+
+            // Triggered by allocations, once the number of registered objects and arrays has doubled since the last collection
+            // With concurrent marking enabled, it only stops the world to build the graph and to drain the SATB log at the end
+            bool Collect();
+            // Always stops the world for the whole collection (waiting for any concurrent one to finish first)
+            // Soft references are normally cleared depending on how much room is left, unless told to clear all of them
+            bool CollectBlocking(const bool clear_soft_refs = false);
+
+            void Reset();
+
+            // Limit for the accounted size of objects, arrays and class metadata, 0 means unlimited
+            inline void SetMaxSize(const u64 size) {
+                this->max_size = size;
+            }
+
+            inline u64 GetMaxSize() {
+                return this->max_size;
+            }
+
+            // Objects freed by reference counting are only discounted once the heap prunes their entries (on collections, or when close to the limit)
+            inline u64 GetUsedSize() {
+                return this->used_size.load(std::memory_order_relaxed) + this->metadata_size.load(std::memory_order_relaxed);
+            }
+
+            // Class metadata is never collected, it's only released when the instance's class types are reset
+            inline void AddMetadataSize(const u64 size) {
+                this->metadata_size.fetch_add(size, std::memory_order_relaxed);
+            }
+
+            inline void ResetMetadataSize() {
+                this->metadata_size.store(0);
+            }
+
+            // Checks whether an allocation of the given size fits under the limit, pruning and collecting if needed
+            bool EnsureAvailable(const u64 size);
+
+            // Big graphs get marked by this many threads (the collecting one included), 1 disables parallel marking
+            inline void SetMarkerWorkerCount(const u32 count) {
+                this->marker_worker_count = std::max(count, 1u);
+            }
+
+            inline u32 GetMarkerWorkerCount() {
+                return this->marker_worker_count;
+            }
+
+            // Used by the marker threads to find their job
+            inline ParallelMarker *GetActiveMarker() {
+                return this->active_marker;
+            }
+
+            inline void SetActiveMarker(ParallelMarker *marker) {
+                this->active_marker = marker;
+            }
+
+            // Marks in a background thread while the mutators keep running, protected by a SATB (snapshot-at-the-beginning) write barrier
+            inline void SetConcurrentMarkEnabled(const bool enabled) {
+                this->concurrent_mark = enabled;
+            }
+
+            inline bool IsConcurrentMarkEnabled() {
+                return this->concurrent_mark;
+            }
+
+            // Whether reference slots must go through the SATB barrier (see StoreHeapSlot)
+            inline bool IsSATBActive() {
+                return this->satb_active.load(std::memory_order_acquire);
+            }
+
+            void LogOverwrittenReference(const Ptr<Variable> &old_var);
+
+            // Used by the background collector thread
+            void RunConcurrentCycle();
+
+            u64 GetObjectCount();
+
+            inline u64 GetCollectionCount() {
+                return this->collection_count;
+            }
+
+            inline u64 GetCollectedObjectCount() {
+                return this->collected_object_count;
+            }
+    };
+
+    // These work on the current VM instance's heap
+    // Allocations are first registered in a per-thread buffer, which gets handed to the heap once full (or when the thread leaves the instance)
+    // This only batches the registration: memory itself still comes from the regular allocator
+
+    void RegisterHeapObject(Ptr<ClassInstance> obj);
+    void RegisterHeapObject(Ptr<Array> arr);
+    void FlushThreadHeapBuffer();
+
+    void RegisterHeapMetadata(const u64 size);
+
+    // Allocation paths which can throw (the interpreter's NEW/*NEWARRAY instructions) check this first, throwing java.lang.OutOfMemoryError on failure
+    // Other allocations (natives, strings, throwables...) are accounted but never fail
+    bool EnsureHeapSpace(const u64 size);
+
+    // Storage of a variable (field, static field or array element)
+    // Ordinary accesses copy the variable directly, being as racy as any non-volatile Java access
+    // Accesses which must be atomic (volatile fields, Unsafe, the SATB barrier and the concurrent marker) take the slot's own spinlock instead
+    // The lock only guards the variable copy/swap, and overwritten values are released after unlocking
+
+    struct VariableSlot {
+        Ptr<Variable> var;
+        u8 lock_flag = 0;
+
+        void WaitUnlocked();
+
+        inline void Lock() {
+            while(__atomic_test_and_set(&this->lock_flag, __ATOMIC_ACQUIRE)) {
+                this->WaitUnlocked();
+            }
+        }
+
+        inline void Unlock() {
+            __atomic_clear(&this->lock_flag, __ATOMIC_RELEASE);
+        }
+
+        inline Ptr<Variable> Load() {
+            this->Lock();
+            auto cur_var = this->var;
+            this->Unlock();
+            return cur_var;
+        }
+
+        // Returns the overwritten value
+        inline Ptr<Variable> Exchange(Ptr<Variable> new_var) {
+            this->Lock();
+            this->var.swap(new_var);
+            this->Unlock();
+            return new_var;
+        }
+
+        // Compares by identity, on failure the expected value gets updated with the current one (like std::atomic)
+        inline bool CompareExchange(Ptr<Variable> &expected_var, Ptr<Variable> new_var) {
+            this->Lock();
+            if(this->var == expected_var) {
+                this->var.swap(new_var);
+                this->Unlock();
+                return true;
+            }
+            auto cur_var = this->var;
+            this->Unlock();
+            expected_var.swap(cur_var);
+            return false;
+        }
+    };
+
+    // SATB write barrier, for reference slots the marker walks (fields and array elements)
+    // While a concurrent mark runs the slot is swapped atomically and the overwritten value gets logged, so that nothing reachable when marking started is missed
+    void StoreHeapSlot(VariableSlot &slot, Ptr<Variable> var);
+    // Same for slots which are already updated atomically (volatile fields, Unsafe), given the value they held
+    void LogOverwrittenHeapSlot(const Ptr<Variable> &old_var);
+
+    // Collection stops every other thread of the instance at a safepoint first, and is skipped (returning false) if they can't be stopped in time
+    // Returns whether a collection actually took place
+    bool CollectGarbage();
+
+}
@@ -1,6 +1,7 @@
 
 #pragma once
 #include <javm/native/native_NativeSync.hpp>
+#include <atomic>
 
 namespace javm::vm {
 
@@ -56,4 +57,122 @@ namespace javm::vm {
             }
     };
 
-}
\ No newline at end of file
+    class ObjectMonitor;
+
+    // Interruption state of a thread which might wait on object monitors
+    // The monitor being waited on stays registered meanwhile, so that interrupting the thread wakes it up
+
+    class MonitorWaiter {
+        private:
+            std::atomic_bool interrupted;
+            Ptr<native::RecursiveMutex> lock;
+            ObjectMonitor *monitor;
+
+        public:
+            MonitorWaiter() : interrupted(false), lock(native::CreateRecursiveMutex()), monitor(nullptr) {}
+
+            void SetMonitor(ObjectMonitor *monitor);
+            void Interrupt();
+
+            inline bool IsInterrupted() {
+                return this->interrupted.load();
+            }
+
+            inline bool ClearInterrupted() {
+                return this->interrupted.exchange(false);
+            }
+    };
+
+    // Small per-thread id used as the owner field of object lock words (0 is never used)
+    u32 GetCurrentLockOwnerId();
+
+    // Full monitor, only inflated for objects which get contended or waited on
+
+    class ObjectMonitor {
+        private:
+            Ptr<native::RecursiveMutex> lock;
+            Ptr<native::ConditionVariable> entry_cond_var;
+            Ptr<native::ConditionVariable> wait_cond_var;
+            u32 owner_id;
+            u32 recursion_count;
+
+        public:
+            ObjectMonitor(const u32 owner_id, const u32 recursion_count) : lock(native::CreateRecursiveMutex()), entry_cond_var(native::CreateConditionVariable()), wait_cond_var(native::CreateConditionVariable()), owner_id(owner_id), recursion_count(recursion_count) {}
+
+            void Enter(const u32 self_id);
+            bool Leave(const u32 self_id);
+            // The waiter (if any) gets this monitor registered while waiting, so that interrupting it wakes the monitor up
+            bool Wait(const u32 self_id, const type::Long ms, MonitorWaiter *waiter);
+            bool Notify(const u32 self_id);
+            bool NotifyAll(const u32 self_id);
+            bool IsOwnedBy(const u32 self_id);
+            // Wakes every waiter regardless of ownership (they just see a spurious wakeup unless they were interrupted)
+            void WakeWaiters();
+    };
+
+    // Lock word stored inline in every object:
+    // - 0: unlocked
+    // - bit 0 clear: thin lock, owner id in the upper 32 bits and recursion count in bits 1-31
+    // - bit 0 set: inflated, the rest of the word is the ObjectMonitor pointer
+
+    class ObjectLock {
+        private:
+            std::atomic<u64> lock_word;
+
+            static constexpr u64 InflatedBit = 1;
+            static constexpr u64 ThinCountUnit = 2;
+            static constexpr u64 ThinCountMask = 0xFFFFFFFE;
+
+            static inline constexpr u64 MakeThinWord(const u32 owner_id, const u32 count) {
+                return (static_cast<u64>(owner_id) << 32) | (static_cast<u64>(count) * ThinCountUnit);
+            }
+
+            static inline constexpr u32 GetThinOwnerId(const u64 word) {
+                return static_cast<u32>(word >> 32);
+            }
+
+            static inline constexpr u32 GetThinCount(const u64 word) {
+                return static_cast<u32>((word & ThinCountMask) / ThinCountUnit);
+            }
+
+            static inline constexpr bool IsInflatedWord(const u64 word) {
+                return word & InflatedBit;
+            }
+
+            static inline ObjectMonitor *GetWordMonitor(const u64 word) {
+                return reinterpret_cast<ObjectMonitor*>(static_cast<uintptr_t>(word & ~InflatedBit));
+            }
+
+            ObjectMonitor *Inflate();
+
+        public:
+            ObjectLock() : lock_word(0) {}
+            ObjectLock(const ObjectLock&) = delete;
+            ObjectLock &operator=(const ObjectLock&) = delete;
+            ~ObjectLock();
+
+            void Enter();
+            // Only succeeds if the lock can be taken without blocking (unlocked or already thin-locked by us)
+            bool TryEnter();
+            bool Leave();
+            bool Wait(const type::Long ms, MonitorWaiter *waiter = nullptr);
+            bool Notify();
+            bool NotifyAll();
+            bool IsHeldByCurrentThread();
+
+            inline bool IsInflated() {
+                return IsInflatedWord(this->lock_word.load(std::memory_order_acquire));
+            }
+    };
+
+    class MonitoredItem {
+        protected:
+            ObjectLock lock;
+
+        public:
+            inline ObjectLock &GetLock() {
+                return this->lock;
+            }
+    };
+
+}
@@ -4,6 +4,7 @@
 #include <javm/vm/jutil/jutil_Throwable.hpp>
 #include <javm/vm/jutil/jutil_String.hpp>
 #include <javm/native/native_NativeThread.hpp>
+#include <javm/native/native_NativeSync.hpp>
 
 namespace javm::vm {
 
@@ -19,15 +20,37 @@ namespace javm::vm {
         u16 code_offset;
     };
 
+    enum class ThreadState : u8 {
+        Running, // Executing Java code, which must reach a safepoint before the world can be stopped
+        Blocked, // Parked, sleeping, waiting or otherwise out of Java code (without touching the heap)
+        Stopped // Stopped at a safepoint
+    };
+
+    // Per-instance safepoint polling word: threads check it at back-edges and calls, and stop while it's set
+
+    struct SafepointControl {
+        std::atomic_bool requested;
+        Monitor monitor;
+
+        SafepointControl() : requested(false) {}
+    };
+
     class ThreadAccessor {
         private:
             Ptr<native::Thread> thread_obj;
             Ptr<Variable> throwable_v;
             std::vector<CallInfo> call_stack;
             bool caller_sensitive;
+            Ptr<native::Parker> parker;
+            Ptr<native::Parker> sleep_parker;
+            MonitorWaiter waiter;
+            std::atomic<ThreadState> state;
+            SafepointControl &safepoint;
+
+            void StopAtSafepoint();
 
         public:
-            ThreadAccessor(Ptr<native::Thread> thr_obj) : thread_obj(thr_obj), caller_sensitive(false) {}
+            ThreadAccessor(Ptr<native::Thread> thr_obj, SafepointControl &safepoint, const ThreadState initial_state) : thread_obj(thr_obj), caller_sensitive(false), parker(native::CreateParker()), sleep_parker(native::CreateParker()), state(initial_state), safepoint(safepoint) {}
 
             inline ThreadHandle GetThreadHandle() {
                 return this->thread_obj->GetHandle();
@@ -68,6 +91,47 @@ namespace javm::vm {
                 return this->call_stack;
             }
 
+            // LockSupport (Unsafe.park/unpark) permit
+
+            inline Ptr<native::Parker> GetParker() {
+                return this->parker;
+            }
+
+            // Thread.sleep() gets its own parker, so that it never consumes a LockSupport permit
+
+            inline Ptr<native::Parker> GetSleepParker() {
+                return this->sleep_parker;
+            }
+
+            // Passed to Object.wait() monitor waits, so that Interrupt() can wake them up
+            inline MonitorWaiter *GetMonitorWaiter() {
+                return &this->waiter;
+            }
+
+            void Interrupt();
+
+            inline bool IsInterrupted() {
+                return this->waiter.IsInterrupted();
+            }
+
+            inline bool ClearInterrupted() {
+                return this->waiter.ClearInterrupted();
+            }
+
+            inline ThreadState GetState() {
+                return this->state.load();
+            }
+
+            inline void PollSafepoint() {
+                if(this->safepoint.requested.load(std::memory_order_acquire)) {
+                    this->StopAtSafepoint();
+                }
+            }
+
+            // Surround anything which might block for a while (without touching the heap), so that the world can be stopped meanwhile
+            void EnterBlockedState();
+            void LeaveBlockedState();
+
             inline std::vector<CallInfo> GetInvertedCallStack() {
                 auto stack = this->GetCallStack();
                 std::reverse(stack.begin(), stack.end());
@@ -75,6 +139,24 @@ namespace javm::vm {
             }
     };
 
+    class ScopedBlockedState {
+        private:
+            Ptr<ThreadAccessor> accessor;
+
+        public:
+            ScopedBlockedState(Ptr<ThreadAccessor> accessor) : accessor(accessor) {
+                if(this->accessor) {
+                    this->accessor->EnterBlockedState();
+                }
+            }
+
+            ~ScopedBlockedState() {
+                if(this->accessor) {
+                    this->accessor->LeaveBlockedState();
+                }
+            }
+    };
+
     class CallerSensitiveGuard {
         private:
             bool already_guarded;
@@ -84,22 +166,32 @@ namespace javm::vm {
             ~CallerSensitiveGuard();
     };
 
-    Ptr<ThreadAccessor> RegisterThread(Ptr<native::Thread> thread_obj);
+    // Threads registered by someone else (before they start) count as blocked until they actually start running Java code
+    Ptr<ThreadAccessor> RegisterThread(Ptr<native::Thread> thread_obj, const ThreadState initial_state = ThreadState::Blocked);
     void UnregisterThread(Ptr<native::Thread> thread_obj);
     void UnregisterSelf();
+    // Used when tearing down a VM instance
+    void UnregisterAllThreads();
 
     Ptr<Variable> GetCurrentThreadVariable();
     Ptr<ThreadAccessor> GetThreadByHandle(const native::ThreadHandle handle);
+    Ptr<ThreadAccessor> GetThreadByVariable(Ptr<Variable> thread_v);
 
-    inline Ptr<ThreadAccessor> GetCurrentThread() {
-        const auto cur_handle = native::GetCurrentThreadHandle();
-        return GetThreadByHandle(cur_handle);
-    }
+    // Cached per thread, so the thread list is only looked up again after it changes
+    Ptr<ThreadAccessor> GetCurrentThread();
 
     u32 GetThreadCount();
 
     void RegisterAndStartThread(Ptr<Variable> thread_var);
 
+    // Stop-the-world: waits until every other thread of the instance is stopped at a safepoint or blocked
+    // Gives up (returning false) if some thread doesn't get there in time, or if another thread is already stopping the world
+    bool StopOtherThreads(const u32 timeout_ms);
+    void ResumeOtherThreads();
+
+    // Object lock acquisition which doesn't hold back safepoints while contended
+    void EnterObjectLock(ObjectLock &lock);
+
     void RegisterThrown(Ptr<Variable> throwable_v);
     Ptr<ThreadAccessor> RetrieveThrownThread();
     Ptr<Variable> RetrieveThrownThrowable();
@@ -93,6 +93,40 @@ namespace javm::vm {
 
     };
 
+    // Non-owning view of contiguous variables, which is how parameters are passed around (the interpreter passes them straight from the caller's operand stack)
+    // Vectors convert to it, so they can still be used when calling methods from C++
+
+    class VariableSpan {
+        private:
+            const Ptr<Variable> *vars;
+            size_t count;
+
+        public:
+            constexpr VariableSpan() : vars(nullptr), count(0) {}
+            constexpr VariableSpan(const Ptr<Variable> *vars, const size_t count) : vars(vars), count(count) {}
+            VariableSpan(const std::vector<Ptr<Variable>> &vars) : vars(vars.data()), count(vars.size()) {}
+
+            inline const Ptr<Variable> &operator[](const size_t idx) const {
+                return this->vars[idx];
+            }
+
+            inline size_t size() const {
+                return this->count;
+            }
+
+            inline bool empty() const {
+                return this->count == 0;
+            }
+
+            inline const Ptr<Variable> *begin() const {
+                return this->vars;
+            }
+
+            inline const Ptr<Variable> *end() const {
+                return this->vars + this->count;
+            }
+    };
+
     bool IsPrimitiveType(const String &type_name);
 
     String GetPrimitiveTypeDescriptor(const VariableType type);
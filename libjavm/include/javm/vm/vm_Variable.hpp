@@ -2,6 +2,7 @@
 #pragma once
 #include <javm/vm/vm_Array.hpp>
 #include <javm/vm/ref/ref_Reflection.hpp>
+#include <javm/vm/vm_Heap.hpp>
 
 namespace javm::vm {
 
@@ -96,6 +97,39 @@ namespace javm::vm {
 
             #undef _JAVM_VAR_CTOR
 
+            // The union doesn't know which member is active, so the held value must be released here
+            ~Variable() {
+                switch(this->type) {
+                    case VariableType::Byte:
+                    case VariableType::Boolean:
+                    case VariableType::Short:
+                    case VariableType::Character:
+                    case VariableType::Integer:
+                        this->value.common_int_val.~Ptr<type::Integer>();
+                        break;
+                    case VariableType::Long:
+                        this->value.long_val.~Ptr<type::Long>();
+                        break;
+                    case VariableType::Float:
+                        this->value.float_val.~Ptr<type::Float>();
+                        break;
+                    case VariableType::Double:
+                        this->value.double_val.~Ptr<type::Double>();
+                        break;
+                    case VariableType::ClassInstance:
+                        this->value.class_val.~Ptr<type::ClassInstance>();
+                        break;
+                    case VariableType::Array:
+                        this->value.arr_val.~Ptr<type::Array>();
+                        break;
+                    case VariableType::NullObject:
+                        this->value.null_val.~Ptr<type::NullObject>();
+                        break;
+                    default:
+                        break;
+                }
+            }
+
             template<VariableType Type>
             inline constexpr bool CanGetAs() {
                 return this->type == Type;
@@ -131,6 +165,40 @@ namespace javm::vm {
                 return ptr::GetValue(obj);
             }
 
+            // Same as above, but reads the value in place, without copying the held pointer (used by typed natives)
+            template<typename T>
+            inline T PeekValue() {
+                static_assert(IsPrimitiveType<T>(), "Invalid primitive type");
+                constexpr auto v_type = DetermineVariableType<T>();
+                if(v_type != this->type) {
+                    return {};
+                }
+
+                if constexpr(std::is_same_v<T, type::Integer>) {
+                    return *this->value.common_int_val;
+                }
+                else if constexpr(std::is_same_v<T, type::Long>) {
+                    return *this->value.long_val;
+                }
+                else if constexpr(std::is_same_v<T, type::Float>) {
+                    return *this->value.float_val;
+                }
+                else {
+                    return *this->value.double_val;
+                }
+            }
+
+            // Object reference held by this variable (if any), for the garbage collector
+            template<typename Fn>
+            inline void VisitObjectReference(Fn fn) {
+                if(this->type == VariableType::ClassInstance) {
+                    fn(this->value.class_val);
+                }
+                else if(this->type == VariableType::Array) {
+                    fn(this->value.arr_val);
+                }
+            }
+
             template<typename T>
             inline void SetAs(Ptr<T> val) {
                 static_assert(IsValidVariableType<T>(), "Invalid type");
@@ -151,6 +219,40 @@ namespace javm::vm {
         return ptr::New<Variable>(ptr::New<T>(t));
     }
 
+    // Primitive array elements (see Array::GetPrimitiveData) from/to variables, where byte/boolean/short/char are plain ints
+
+    template<typename E>
+    inline Ptr<Variable> NewArrayElementVariable(const E elem) {
+        if constexpr(std::is_same_v<E, i64>) {
+            return NewPrimitiveVariable<type::Long>(elem);
+        }
+        else if constexpr(std::is_same_v<E, float>) {
+            return NewPrimitiveVariable<type::Float>(elem);
+        }
+        else if constexpr(std::is_same_v<E, double>) {
+            return NewPrimitiveVariable<type::Double>(elem);
+        }
+        else {
+            return NewPrimitiveVariable<type::Integer>(static_cast<type::Integer>(elem));
+        }
+    }
+
+    template<typename E>
+    inline E GetArrayElementValue(Ptr<Variable> var) {
+        if constexpr(std::is_same_v<E, i64>) {
+            return var->GetValue<type::Long>();
+        }
+        else if constexpr(std::is_same_v<E, float>) {
+            return var->GetValue<type::Float>();
+        }
+        else if constexpr(std::is_same_v<E, double>) {
+            return var->GetValue<type::Double>();
+        }
+        else {
+            return static_cast<E>(var->GetValue<type::Integer>());
+        }
+    }
+
     inline Ptr<Variable> NewDefaultPrimitiveVariable(const VariableType type) {
         if(!IsPrimitiveVariableType(type)) {
             return nullptr;
@@ -202,13 +304,26 @@ namespace javm::vm {
         }
     }
 
+    inline Ptr<type::ClassInstance> NewClassInstance(Ptr<ClassType> class_type) {
+        auto class_obj = ptr::New<type::ClassInstance>(class_type);
+        RegisterHeapObject(class_obj);
+        return class_obj;
+    }
+
+    template<typename ...Args>
+    inline Ptr<type::Array> NewArrayObject(Args &&...args) {
+        auto arr_obj = ptr::New<type::Array>(args...);
+        RegisterHeapObject(arr_obj);
+        return arr_obj;
+    }
+
     inline Ptr<Variable> NewClassVariable(Ptr<ClassType> class_type) {
-        return ptr::New<Variable>(ptr::New<type::ClassInstance>(class_type));
+        return ptr::New<Variable>(NewClassInstance(class_type));
     }
 
     template<typename ...JArgs>
     inline Ptr<Variable> NewClassVariable(Ptr<ClassType> class_type, const String &init_descriptor, JArgs &&...java_args) {
-        auto class_var = ptr::New<Variable>(ptr::New<type::ClassInstance>(class_type));
+        auto class_var = ptr::New<Variable>(NewClassInstance(class_type));
         
         auto class_obj = class_var->GetAs<type::ClassInstance>();
         class_obj->CallConstructor(class_var, init_descriptor, java_args...);
@@ -217,16 +332,16 @@ namespace javm::vm {
     }
 
     inline Ptr<Variable> NewArrayVariable(const u32 length, const VariableType type, const u32 dimension = 1) {
-        return ptr::New<Variable>(ptr::New<type::Array>(type, length, dimension));
+        return ptr::New<Variable>(NewArrayObject(type, length, dimension));
     }
 
     inline Ptr<Variable> NewArrayVariable(const u32 length, Ptr<ClassType> type, const u32 dimension = 1) {
-        return ptr::New<Variable>(ptr::New<type::Array>(type, length, dimension));
+        return ptr::New<Variable>(NewArrayObject(type, length, dimension));
     }
 
     template<typename ...JArgs>
     inline Ptr<Variable> NewArray(VariableType type, JArgs &&...java_args) {
-        auto arr_obj = ptr::New<type::Array>(type, sizeof...(JArgs));
+        auto arr_obj = NewArrayObject(type, static_cast<u32>(sizeof...(JArgs)));
 
         u32 idx = 0;
         (arr_obj->SetAt(idx++, java_args), ...);
@@ -244,10 +359,47 @@ namespace javm::vm {
         return NewPrimitiveVariable<type::Boolean>(false);
     }
 
+    // Atomic accesses to variable slots (fields, static fields, array elements), used for volatile fields and Unsafe (see VariableSlot)
+    // Empty slots are lazily filled with the default value of the given type, without overwriting anything stored meanwhile
+
+    Ptr<Variable> AtomicLoadSlot(VariableSlot &slot, const VariableType type);
+
+    // Stores swap the slot, since the overwritten value might need to be logged by the SATB barrier (see StoreHeapSlot)
+    // The slot lock already orders them like release stores (Unsafe.putOrdered*)
+
+    inline void AtomicStoreSlot(VariableSlot &slot, Ptr<Variable> var) {
+        const auto old_var = slot.Exchange(var);
+        LogOverwrittenHeapSlot(old_var);
+    }
+
+    // The update function gets the current value and returns the new one, or nullptr to leave the slot untouched
+    // Returns the value the slot held right before the update (or the current one if nothing was updated)
+    template<typename Fn>
+    inline Ptr<Variable> AtomicUpdateSlot(VariableSlot &slot, const VariableType type, Fn update_fn) {
+        auto cur_var = AtomicLoadSlot(slot, type);
+        while(true) {
+            auto new_var = update_fn(cur_var);
+            if(!new_var) {
+                return cur_var;
+            }
+            // On failure cur_var gets updated with the actual current value, so just retry
+            if(slot.CompareExchange(cur_var, new_var)) {
+                LogOverwrittenHeapSlot(cur_var);
+                return cur_var;
+            }
+        }
+    }
+
     // New java.lang.Class variable from reflection type
 
     Ptr<Variable> NewClassTypeVariable(Ptr<ref::ReflectionType> ref_type);
 
+    // Reference equality: same object, or both null
+    bool IsSameObject(Ptr<Variable> var_a, Ptr<Variable> var_b);
+
+    // Lock word of the object (class instance or array) held by the variable, nullptr otherwise
+    ObjectLock *GetObjectLock(Ptr<Variable> var);
+
     String FormatVariableType(Ptr<Variable> var);
     String FormatVariable(Ptr<Variable> var);
 
@@ -6,7 +6,8 @@ namespace javm {
 
     namespace {
 
-        std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> g_StringConvert;
+        // Converters keep conversion state, so they can't be shared between threads
+        thread_local std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> g_StringConvert;
 
     }
 
@@ -26,9 +26,8 @@ namespace javm::native::impl {
         }
         else if(var->CanGetAs<VariableType::Array>()) {
             auto array = var->GetAs<type::Array>();
-            auto array_obj = array->GetObjectInstance();
-            const auto array_obj_ptr = reinterpret_cast<uintptr_t>(array_obj.get());
-            const auto hash_code = static_cast<type::Integer>(array_obj_ptr);
+            const auto array_ptr = reinterpret_cast<uintptr_t>(array.get());
+            const auto hash_code = static_cast<type::Integer>(array_ptr);
             JAVM_LOG("[java.lang.Object.hashCode] called - array hash code: %d", hash_code);
             return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(hash_code));
         }
@@ -38,6 +37,10 @@ namespace javm::native::impl {
 
     Ptr<ref::ReflectionType> GetReflectionTypeFromClassVariable(Ptr<Variable> var) {
         if(var->CanGetAs<VariableType::ClassInstance>()) {
+            auto ref_type = ref::FindReflectionTypeByClassVariable(var);
+            if(ref_type) {
+                return ref_type;
+            }
             auto var_obj = var->GetAs<type::ClassInstance>();
             auto name_v = var_obj->GetField(u"name", u"Ljava/lang/String;");
             const auto name = jutil::GetStringValue(name_v);
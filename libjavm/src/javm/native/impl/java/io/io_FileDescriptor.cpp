@@ -5,12 +5,12 @@ namespace javm::native::impl::java::io {
 
     using namespace vm;
 
-    ExecutionResult FileDescriptor::initIDs(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult FileDescriptor::initIDs(const VariableSpan &param_vars) {
         JAVM_LOG("[java.io.FileDescriptor.initIDs] called");
         return ExecutionResult::Void();
     }
 
-    ExecutionResult FileDescriptor::set(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult FileDescriptor::set(const VariableSpan &param_vars) {
         auto fd_v = param_vars[0];
         const auto fd_i = fd_v->GetValue<type::Integer>();
         JAVM_LOG("[java.io.FileDescriptor.set] called - fd: %d", fd_i);
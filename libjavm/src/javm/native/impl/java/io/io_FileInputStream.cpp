@@ -1,13 +1,72 @@
 #include <javm/javm_VM.hpp>
 #include <javm/native/impl/java/io/io_FileInputStream.hpp>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 
 namespace javm::native::impl::java::io {
 
     using namespace vm;
 
-    ExecutionResult FileInputStream::initIDs(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult FileInputStream::initIDs(const VariableSpan &param_vars) {
         JAVM_LOG("[java.io.FileInputStream.initIDs] called");
         return ExecutionResult::Void();
     }
 
+    ExecutionResult FileInputStream::readBytes(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto byte_arr_v = param_vars[0];
+        if(byte_arr_v->IsNull()) {
+            return Throw(u"java/lang/NullPointerException");
+        }
+        auto byte_arr = byte_arr_v->GetAs<type::Array>();
+        auto off_v = param_vars[1];
+        const auto off = off_v->GetValue<type::Integer>();
+        auto len_v = param_vars[2];
+        const auto len = len_v->GetValue<type::Integer>();
+
+        JAVM_LOG("[java.io.FileInputStream.readBytes] called - Array: bytes[%d], Offset: %d, Length: %d", byte_arr->GetLength(), off, len);
+
+        // Read straight into the array's storage
+        const auto bytes = byte_arr->PinPrimitiveData();
+        if(!bytes.IsValidRange(off, len)) {
+            return Throw(u"java/lang/IndexOutOfBoundsException");
+        }
+        if(len == 0) {
+            return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(0));
+        }
+
+        auto this_obj = this_var->GetAs<type::ClassInstance>();
+        auto fd_fd_v = this_obj->GetField(u"fd", u"Ljava/io/FileDescriptor;");
+        auto fd_fd_obj = fd_fd_v->GetAs<type::ClassInstance>();
+        auto fd_v = fd_fd_obj->GetField(u"fd", u"I");
+        const auto fd = fd_v->GetValue<type::Integer>();
+
+        JAVM_LOG("[java.io.FileInputStream.readBytes] FD: %d", fd);
+        // Closed streams have their descriptor reset to -1
+        if(fd == -1) {
+            return Throw(u"java/io/IOException", u"Stream Closed");
+        }
+
+        // Reads might block for long (stdin, pipes), so safepoints aren't held back meanwhile (the array data stays pinned)
+        ssize_t ret;
+        auto read_errno = 0;
+        {
+            ScopedBlockedState blocked(GetCurrentThread());
+            do {
+                ret = read(fd, bytes.GetData<i8>() + off, len);
+            } while((ret < 0) && (errno == EINTR));
+            read_errno = errno;
+        }
+        JAVM_LOG("[java.io.FileInputStream.readBytes] Ret: %ld", ret);
+        if(ret < 0) {
+            return Throw(u"java/io/IOException", str::FromUtf8(strerror(read_errno)));
+        }
+
+        // End of file
+        if(ret == 0) {
+            return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(-1));
+        }
+        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(static_cast<type::Integer>(ret)));
+    }
+
 }
\ No newline at end of file
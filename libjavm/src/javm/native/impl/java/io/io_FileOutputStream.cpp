@@ -1,18 +1,23 @@
 #include <javm/javm_VM.hpp>
 #include <javm/native/impl/java/io/io_FileOutputStream.hpp>
 #include <unistd.h>
+#include <cerrno>
+#include <cstring>
 
 namespace javm::native::impl::java::io {
 
     using namespace vm;
 
-    ExecutionResult FileOutputStream::initIDs(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult FileOutputStream::initIDs(const VariableSpan &param_vars) {
         JAVM_LOG("[java.io.FileOutputStream.initIDs] called");
         return ExecutionResult::Void();
     }
 
-    ExecutionResult FileOutputStream::writeBytes(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult FileOutputStream::writeBytes(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         auto byte_arr_v = param_vars[0];
+        if(byte_arr_v->IsNull()) {
+            return Throw(u"java/lang/NullPointerException");
+        }
         auto byte_arr = byte_arr_v->GetAs<type::Array>();
         auto off_v = param_vars[1];
         const auto off = off_v->GetValue<type::Integer>();
@@ -23,6 +28,12 @@ namespace javm::native::impl::java::io {
 
         JAVM_LOG("[java.io.FileOutputStream.writeBytes] called - Array: bytes[%d], Offset: %d, Length: %d, Append: %s", byte_arr->GetLength(), off, len, append ? "true" : "false");
 
+        // Byte arrays are already plain bytes, so they're written straight from their storage
+        const auto bytes = byte_arr->PinPrimitiveData();
+        if(!bytes.IsValidRange(off, len)) {
+            return Throw(u"java/lang/IndexOutOfBoundsException");
+        }
+
         auto this_obj = this_var->GetAs<type::ClassInstance>();
         auto fd_fd_v = this_obj->GetField(u"fd", u"Ljava/io/FileDescriptor;");
         auto fd_fd_obj = fd_fd_v->GetAs<type::ClassInstance>();
@@ -30,20 +41,35 @@ namespace javm::native::impl::java::io {
         const auto fd = fd_v->GetValue<type::Integer>();
 
         JAVM_LOG("[java.io.FileOutputStream.writeBytes] FD: %d", fd);
-
-        const auto proper_len = std::min(static_cast<u32>(len), byte_arr->GetLength());
-
-        auto tmpbuf = new u8[proper_len]();
-        for(u32 i = 0; i < proper_len; i++) {
-            auto byte_v = byte_arr->GetAt(i);
-            const auto byte = static_cast<u8>(byte_v->GetValue<type::Integer>());
-            tmpbuf[i] = byte;
+        // Closed streams have their descriptor reset to -1
+        if(fd == -1) {
+            return Throw(u"java/io/IOException", u"Stream Closed");
         }
 
-        const auto ret = write(fd, tmpbuf, proper_len);
-        JAVM_LOG("[java.io.FileOutputStream.writeBytes] Ret: %ld", ret);
+        // Writes might be partial, and might block for long (full pipes), so safepoints aren't held back meanwhile (the array data stays pinned)
+        auto data = bytes.GetData<i8>() + off;
+        size_t left = len;
+        auto write_errno = 0;
+        {
+            ScopedBlockedState blocked(GetCurrentThread());
+            while(left > 0) {
+                const auto ret = write(fd, data, left);
+                JAVM_LOG("[java.io.FileOutputStream.writeBytes] Ret: %ld", ret);
+                if(ret < 0) {
+                    if(errno == EINTR) {
+                        continue;
+                    }
+                    write_errno = errno;
+                    break;
+                }
+                data += ret;
+                left -= ret;
+            }
+        }
+        if(write_errno != 0) {
+            return Throw(u"java/io/IOException", str::FromUtf8(strerror(write_errno)));
+        }
 
-        delete[] tmpbuf;
         return ExecutionResult::Void();
     }
 
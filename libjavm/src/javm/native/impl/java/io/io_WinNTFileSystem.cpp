@@ -5,7 +5,7 @@ namespace javm::native::impl::java::io {
 
     using namespace vm;
 
-    ExecutionResult WinNTFileSystem::initIDs(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult WinNTFileSystem::initIDs(const VariableSpan &param_vars) {
         JAVM_LOG("[java.io.WinNTFileSystem.initIDs] called");
         return ExecutionResult::Void();
     }
@@ -6,12 +6,12 @@ namespace javm::native::impl::java::lang {
 
     using namespace vm;
 
-    ExecutionResult Class::registerNatives(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::registerNatives(const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Class.registerNatives] called...");
         return ExecutionResult::Void();
     }
 
-    ExecutionResult Class::getPrimitiveClass(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::getPrimitiveClass(const VariableSpan &param_vars) {
         auto type_name_v = param_vars[0];
         auto type_name = jutil::GetStringValue(type_name_v);
         JAVM_LOG("[java.lang.Class.getPrimitiveClass] called - primitive type name: '%s'...", str::ToUtf8(type_name).c_str());
@@ -22,7 +22,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(MakeNull());
     }
 
-    ExecutionResult Class::desiredAssertionStatus0(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::desiredAssertionStatus0(const VariableSpan &param_vars) {
         auto ref_type = GetReflectionTypeFromClassVariable(param_vars[0]);
         if(ref_type) {
             JAVM_LOG("[java.lang.Class.desiredAssertionStatus0] called - Reflection type name: '%s'...", str::ToUtf8(ref_type->GetTypeName()).c_str());
@@ -30,7 +30,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(0));
     }
 
-    ExecutionResult Class::forName0(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::forName0(const VariableSpan &param_vars) {
         auto class_name_v = param_vars[0];
         const auto class_name = jutil::GetStringValue(class_name_v);
         auto init_v = param_vars[1];
@@ -58,7 +58,7 @@ namespace javm::native::impl::java::lang {
         }
     }
 
-    ExecutionResult Class::getDeclaredFields0(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::getDeclaredFields0(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Class.getDeclaredFields0] called...");
         auto public_only_v = param_vars[0];
 
@@ -122,7 +122,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(MakeNull());
     }
 
-    ExecutionResult Class::isInterface(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::isInterface(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Class.isInterface] called...");
 
         auto ref_type = GetReflectionTypeFromClassVariable(this_var);
@@ -139,7 +139,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(MakeFalse());
     }
 
-    ExecutionResult Class::isPrimitive(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::isPrimitive(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Class.isPrimitive] called...");
 
         auto ref_type = GetReflectionTypeFromClassVariable(this_var);
@@ -153,7 +153,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(MakeFalse());
     }
 
-    ExecutionResult Class::isAssignableFrom(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::isAssignableFrom(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Class.isAssignableFrom] called...");
 
         auto ref_type_1 = GetReflectionTypeFromClassVariable(this_var);
@@ -165,7 +165,8 @@ namespace javm::native::impl::java::lang {
                 if(ref_type_1->IsClassInstance() && ref_type_2->IsClassInstance()) {
                     auto class_1 = ref_type_1->GetClassType();
                     auto class_2 = ref_type_2->GetClassType();
-                    if(class_1->CanCastTo(class_2->GetClassName())) {
+                    // Assignable from the other class if that one is a subtype of this one
+                    if(class_2->IsSubtypeOf(*class_1)) {
                         return ExecutionResult::ReturnVariable(MakeTrue());
                     }
                 }
@@ -175,7 +176,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(MakeFalse());
     }
 
-    ExecutionResult Class::getModifiers(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Class::getModifiers(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Class.getModifiers] called");
         return GetClassModifiers(this_var);
     }
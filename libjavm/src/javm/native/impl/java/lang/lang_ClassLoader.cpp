@@ -5,7 +5,7 @@ namespace javm::native::impl::java::lang {
 
     using namespace vm;
 
-    ExecutionResult ClassLoader::registerNatives(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult ClassLoader::registerNatives(const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.ClassLoader.registerNatives] called...");
         return ExecutionResult::Void();
     }
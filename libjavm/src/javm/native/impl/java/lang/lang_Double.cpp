@@ -5,35 +5,28 @@ namespace javm::native::impl::java::lang {
 
     using namespace vm;
 
-    ExecutionResult Double::doubleToRawLongBits(const std::vector<Ptr<Variable>> &param_vars) {
-        auto d_v = param_vars[0];
-        const auto d_dbl = d_v->GetValue<type::Double>();
-        JAVM_LOG("[java.lang.Double.doubleToRawLongBits] called - double: %f", d_dbl);
-        
-        
+    type::Long Double::doubleToRawLongBits(const type::Double d) {
+        JAVM_LOG("[java.lang.Double.doubleToRawLongBits] called - double: %f", d);
+
         union {
             long l;
             double dbl;
         } double_conv{};
-        double_conv.dbl = d_dbl;
+        double_conv.dbl = d;
 
-        const auto res_l = double_conv.l;
-        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(res_l));
+        return double_conv.l;
     }
 
-    ExecutionResult Double::longBitsToDouble(const std::vector<Ptr<Variable>> &param_vars) {
-        auto l_v = param_vars[0];
-        const auto l_long = l_v->GetValue<type::Long>();
-        JAVM_LOG("[java.lang.Double.longBitsToDouble] called - long: %ld", l_long);
+    type::Double Double::longBitsToDouble(const type::Long l) {
+        JAVM_LOG("[java.lang.Double.longBitsToDouble] called - long: %ld", l);
 
         union {
             long l;
             double dbl;
         } double_conv{};
-        double_conv.l = l_long;
+        double_conv.l = l;
 
-        const auto res_d = double_conv.dbl;
-        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Double>(res_d));
+        return double_conv.dbl;
     }
 
 }
\ No newline at end of file
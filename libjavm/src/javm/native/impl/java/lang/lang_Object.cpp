@@ -6,16 +6,16 @@ namespace javm::native::impl::java::lang {
 
     using namespace vm;
 
-    ExecutionResult Object::registerNatives(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Object::registerNatives(const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Object.registerNatives] called...");
         return ExecutionResult::Void();
     }
 
-    ExecutionResult Object::getClass(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Object::getClass(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Object.getClass] called - array type name: '%s'", str::ToUtf8(FormatVariableType(this_var)).c_str());
         if(this_var->CanGetAs<VariableType::ClassInstance>()) {
             auto this_obj = this_var->GetAs<type::ClassInstance>();
-            auto ref_type = ref::FindReflectionTypeByName(this_obj->GetClassType()->GetClassName());
+            auto ref_type = ref::GetReflectionType(this_obj->GetClassType());
             JAVM_LOG("[java.lang.Object.getClass] reflection type name: '%s'", str::ToUtf8(ref_type->GetTypeName()).c_str());
             return ExecutionResult::ReturnVariable(NewClassTypeVariable(ref_type));
         }
@@ -30,71 +30,69 @@ namespace javm::native::impl::java::lang {
         return ThrowInternal(str::Format("Invalid this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str()));
     }
 
-    ExecutionResult Object::hashCode(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Object::hashCode(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         return GetObjectHashCode(this_var);
     }
 
-    ExecutionResult Object::notify(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
-        if(this_var->CanGetAs<VariableType::ClassInstance>()) {
-            auto this_obj = this_var->GetAs<type::ClassInstance>();
-            auto monitor = this_obj->GetMonitor();
-            monitor->Notify();
-            JAVM_LOG("[java.lang.Object.notify] called...");
-            return ExecutionResult::Void();
-        }
-        else if(this_var->CanGetAs<VariableType::Array>()) {
-            auto this_array = this_var->GetAs<type::Array>();
-            auto array_obj = this_array->GetObjectInstance();
-            auto monitor = array_obj->GetMonitor();
-            monitor->Notify();
-            JAVM_LOG("[java.lang.Object.notify] called on array...");
-            return ExecutionResult::Void();
+    ExecutionResult Object::notify(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto obj_lock = GetObjectLock(this_var);
+        if(obj_lock == nullptr) {
+            return ThrowInternal(str::Format("Invalid this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str()));
         }
 
-        return ThrowInternal(str::Format("Invalid this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str()));
+        JAVM_LOG("[java.lang.Object.notify] called...");
+        if(!obj_lock->Notify()) {
+            return Throw(u"java/lang/IllegalMonitorStateException");
+        }
+        return ExecutionResult::Void();
     }
 
-    ExecutionResult Object::notifyAll(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
-        if(this_var->CanGetAs<VariableType::ClassInstance>()) {
-            auto this_obj = this_var->GetAs<type::ClassInstance>();
-            auto monitor = this_obj->GetMonitor();
-            monitor->NotifyAll();
-            JAVM_LOG("[java.lang.Object.notifyAll] called...");
-            return ExecutionResult::Void();
-        }
-        else if(this_var->CanGetAs<VariableType::Array>()) {
-            auto this_array = this_var->GetAs<type::Array>();
-            auto array_obj = this_array->GetObjectInstance();
-            auto monitor = array_obj->GetMonitor();
-            monitor->NotifyAll();
-            JAVM_LOG("[java.lang.Object.notifyAll] called on array...");
-            return ExecutionResult::Void();
+    ExecutionResult Object::notifyAll(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto obj_lock = GetObjectLock(this_var);
+        if(obj_lock == nullptr) {
+            return ThrowInternal(str::Format("Invalid this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str()));
         }
 
-        return ThrowInternal(str::Format("Invalid this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str()));
+        JAVM_LOG("[java.lang.Object.notifyAll] called...");
+        if(!obj_lock->NotifyAll()) {
+            return Throw(u"java/lang/IllegalMonitorStateException");
+        }
+        return ExecutionResult::Void();
     }
 
-    ExecutionResult Object::wait(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Object::wait(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         auto timeout_v = param_vars[0];
         const auto timeout = timeout_v->GetValue<type::Long>();
 
-        if(this_var->CanGetAs<VariableType::ClassInstance>()) {
-            auto this_obj = this_var->GetAs<type::ClassInstance>();
-            auto monitor = this_obj->GetMonitor();
-            monitor->WaitFor(timeout);
-            JAVM_LOG("[java.lang.Object.wait] called...");
-            return ExecutionResult::Void();
+        auto obj_lock = GetObjectLock(this_var);
+        if(obj_lock == nullptr) {
+            return ThrowInternal(str::Format("Invalid this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str()));
         }
-        else if(this_var->CanGetAs<VariableType::Array>()) {
-            auto this_array = this_var->GetAs<type::Array>();
-            auto array_obj = this_array->GetObjectInstance();
-            auto monitor = array_obj->GetMonitor();
-            monitor->WaitFor(timeout);
-            JAVM_LOG("[java.lang.Object.wait] called on array...");
-            return ExecutionResult::Void();
+
+        if(!obj_lock->IsHeldByCurrentThread()) {
+            return Throw(u"java/lang/IllegalMonitorStateException");
         }
 
-        return ThrowInternal(str::Format("Invalid this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str()));
+        // Interrupting a waiting thread wakes up the monitor (see ThreadAccessor::Interrupt), the exception is thrown once it is reacquired
+        auto cur_accessor = GetCurrentThread();
+        if(cur_accessor && cur_accessor->ClearInterrupted()) {
+            return Throw(u"java/lang/InterruptedException");
+        }
+
+        // A timeout of 0 means waiting until notified
+        JAVM_LOG("[java.lang.Object.wait] called...");
+        bool waited;
+        {
+            ScopedBlockedState blocked(cur_accessor);
+            waited = obj_lock->Wait(timeout, cur_accessor ? cur_accessor->GetMonitorWaiter() : nullptr);
+        }
+        if(!waited) {
+            return Throw(u"java/lang/IllegalMonitorStateException");
+        }
+        if(cur_accessor && cur_accessor->ClearInterrupted()) {
+            return Throw(u"java/lang/InterruptedException");
+        }
+        return ExecutionResult::Void();
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,43 @@
+#include <javm/javm_VM.hpp>
+#include <javm/native/impl/java/lang/lang_Runtime.hpp> 
+#include <limits>
+
+namespace javm::native::impl::java::lang {
+
+    using namespace vm;
+
+    ExecutionResult Runtime::gc(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        // Just a hint in Java, so it's fine if the collection can't take place right now
+        [[maybe_unused]] const auto collected = CollectGarbage();
+        JAVM_LOG("[java.lang.Runtime.gc] called - collected: %d", collected);
+        return ExecutionResult::Void();
+    }
+
+    namespace {
+
+        // Without a limit, the heap is just as big as what's being used
+        inline type::Long GetTotalMemory(Heap &heap) {
+            const auto max_size = heap.GetMaxSize();
+            return static_cast<type::Long>((max_size > 0) ? max_size : heap.GetUsedSize());
+        }
+
+    }
+
+    ExecutionResult Runtime::totalMemory(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto &heap = rt::GetCurrentInstance().heap;
+        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(GetTotalMemory(heap)));
+    }
+
+    ExecutionResult Runtime::freeMemory(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto &heap = rt::GetCurrentInstance().heap;
+        const auto used_size = static_cast<type::Long>(heap.GetUsedSize());
+        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(std::max(GetTotalMemory(heap) - used_size, static_cast<type::Long>(0))));
+    }
+
+    ExecutionResult Runtime::maxMemory(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        // Like Java, Long.MAX_VALUE means there's no limit
+        const auto max_size = rt::GetCurrentInstance().heap.GetMaxSize();
+        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>((max_size > 0) ? static_cast<type::Long>(max_size) : std::numeric_limits<type::Long>::max()));
+    }
+
+}
@@ -7,12 +7,12 @@ namespace javm::native::impl::java::lang {
 
     using namespace vm;
 
-    ExecutionResult System::registerNatives(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::registerNatives(const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.System.registerNatives] called...");
         return ExecutionResult::Void();
     }
 
-    ExecutionResult System::initProperties(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::initProperties(const VariableSpan &param_vars) {
         auto props_v = param_vars[0];
         auto props_obj = props_v->GetAs<type::ClassInstance>();
 
@@ -33,7 +33,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(props_v);
     }
 
-    ExecutionResult System::arraycopy(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::arraycopy(const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.System.arraycopy] called");
         
         // TODO: handle invalid param types/count
@@ -53,6 +53,15 @@ namespace javm::native::impl::java::lang {
                             const auto dstpos = dstpos_v->GetValue<type::Integer>();
                             if(len_v->CanGetAs<VariableType::Integer>()) {
                                 const auto len = len_v->GetValue<type::Integer>();
+                                const auto in_bounds = (srcpos >= 0) && (dstpos >= 0) && (len >= 0) && ((static_cast<u64>(srcpos) + len) <= src->GetLength()) && ((static_cast<u64>(dstpos) + len) <= dst->GetLength());
+                                const auto src_data = src->PinPrimitiveData();
+                                const auto dst_data = dst->PinPrimitiveData();
+                                if(in_bounds && src_data.IsValid() && dst_data.IsValid() && (src_data.GetVariableType() == dst_data.GetVariableType())) {
+                                    // Same element storage, so just move the raw memory (both might be the same array)
+                                    const auto elem_size = Array::GetElementSize(src_data.GetVariableType());
+                                    std::memmove(dst_data.GetData<u8>() + dstpos * elem_size, src_data.GetData<u8>() + srcpos * elem_size, static_cast<size_t>(len) * elem_size);
+                                    return ExecutionResult::Void();
+                                }
                                 // Create a temporary array, push values there, then move them to the dst array
                                 std::vector<Ptr<Variable>> tmp_values;
                                 tmp_values.reserve(len);
@@ -72,7 +81,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::Void();
     }
 
-    ExecutionResult System::setIn0(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::setIn0(const VariableSpan &param_vars) {
         auto stream_v = param_vars[0];
         JAVM_LOG("[java.lang.System.setIn0] called - in stream: '%s'...", str::ToUtf8(FormatVariableType(stream_v)).c_str());
         auto system_class_type = rt::LocateClassType(u"java/lang/System");
@@ -80,7 +89,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::Void();
     }
 
-    ExecutionResult System::setOut0(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::setOut0(const VariableSpan &param_vars) {
         auto stream_v = param_vars[0];
         JAVM_LOG("[java.lang.System.setOut0] called - out stream: '%s'...", str::ToUtf8(FormatVariableType(stream_v)).c_str());
         auto system_class_type = rt::LocateClassType(u"java/lang/System");
@@ -88,7 +97,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::Void();
     }
 
-    ExecutionResult System::setErr0(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::setErr0(const VariableSpan &param_vars) {
         auto stream_v = param_vars[0];
         JAVM_LOG("[java.lang.System.setErr0] called - err stream: '%s'...", str::ToUtf8(FormatVariableType(stream_v)).c_str());
         auto system_class_type = rt::LocateClassType(u"java/lang/System");
@@ -96,31 +105,107 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::Void();
     }
 
-    // TODO: lib load support
+    namespace {
+
+        ExecutionResult GetSystemProperty(const String &key, String &out_value) {
+            auto system_class_type = rt::LocateClassType(u"java/lang/System");
+            const auto res = system_class_type->CallClassMethod(u"getProperty", u"(Ljava/lang/String;)Ljava/lang/String;", jutil::NewString(key));
+            if(res.IsInvalidOrThrown()) {
+                return res;
+            }
+            out_value = res.var->IsNull() ? u"" : jutil::GetStringValue(res.var);
+            return ExecutionResult::Void();
+        }
 
-    ExecutionResult System::mapLibraryName(const std::vector<Ptr<Variable>> &param_vars) {
+    }
+
+    ExecutionResult System::mapLibraryName(const VariableSpan &param_vars) {
         auto lib_v = param_vars[0];
+        if(lib_v->IsNull()) {
+            return Throw(u"java/lang/NullPointerException");
+        }
         const auto lib = jutil::GetStringValue(lib_v);
         JAVM_LOG("[java.lang.System.mapLibraryName] called - library name: '%s'...", str::ToUtf8(lib).c_str());
-        return ExecutionResult::ReturnVariable(lib_v);
+        return ExecutionResult::ReturnVariable(jutil::NewString(native::MapLibraryName(lib)));
     }
 
-    ExecutionResult System::loadLibrary(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::loadLibrary(const VariableSpan &param_vars) {
         auto lib_v = param_vars[0];
+        if(lib_v->IsNull()) {
+            return Throw(u"java/lang/NullPointerException");
+        }
         const auto lib = jutil::GetStringValue(lib_v);
         JAVM_LOG("[java.lang.System.loadLibrary] called - library name: '%s'...", str::ToUtf8(lib).c_str());
-        return ExecutionResult::Void();
+
+        String lib_paths;
+        auto res = GetSystemProperty(u"java.library.path", lib_paths);
+        if(res.IsInvalidOrThrown()) {
+            return res;
+        }
+        String path_sep;
+        res = GetSystemProperty(u"path.separator", path_sep);
+        if(res.IsInvalidOrThrown()) {
+            return res;
+        }
+        if(path_sep.empty()) {
+            path_sep = u":";
+        }
+
+        // Without a library path, leave it to the platform's own search
+        const auto lib_name = native::MapLibraryName(lib);
+        std::vector<String> lib_files;
+        if(lib_paths.empty()) {
+            lib_files.push_back(lib_name);
+        }
+        else {
+            size_t start = 0;
+            while(start <= lib_paths.length()) {
+                auto end = lib_paths.find(path_sep, start);
+                if(end == String::npos) {
+                    end = lib_paths.length();
+                }
+                if(end > start) {
+                    lib_files.push_back(lib_paths.substr(start, end - start) + u"/" + lib_name);
+                }
+                start = end + path_sep.length();
+            }
+        }
+
+        for(const auto &lib_file: lib_files) {
+            auto found = false;
+            const auto load_res = native::LoadNativeLibrary(lib_file, found);
+            if(found) {
+                return load_res;
+            }
+        }
+        return Throw(u"java/lang/UnsatisfiedLinkError", u"no " + lib + u" in java.library.path");
+    }
+
+    ExecutionResult System::load(const VariableSpan &param_vars) {
+        auto path_v = param_vars[0];
+        if(path_v->IsNull()) {
+            return Throw(u"java/lang/NullPointerException");
+        }
+        const auto path = jutil::GetStringValue(path_v);
+        JAVM_LOG("[java.lang.System.load] called - library path: '%s'...", str::ToUtf8(path).c_str());
+
+        auto found = false;
+        const auto res = native::LoadNativeLibrary(path, found);
+        if(!found) {
+            return Throw(u"java/lang/UnsatisfiedLinkError", u"Can't load library: " + path);
+        }
+        return res;
     }
 
-    ExecutionResult System::currentTimeMillis(const std::vector<Ptr<Variable>> &param_vars) {
+    type::Long System::currentTimeMillis() {
         timeval time = {};
         gettimeofday(&time, nullptr);
         const auto time_ms = time.tv_sec * 1000 + time.tv_usec / 1000;
         JAVM_LOG("[java.lang.System.currentTimeMillis] called - time ms: %ld", time_ms);
-        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(time_ms));
+        return time_ms;
     }
 
-    ExecutionResult System::identityHashCode(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult System::identityHashCode(const VariableSpan &param_vars) {
         return GetObjectHashCode(param_vars[0]);
     }
 
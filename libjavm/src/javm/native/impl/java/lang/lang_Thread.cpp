@@ -1,23 +1,24 @@
 #include <javm/javm_VM.hpp>
 #include <javm/native/impl/java/lang/lang_Thread.hpp> 
+#include <chrono>
 
 namespace javm::native::impl::java::lang {
 
     using namespace vm;
 
-    ExecutionResult Thread::registerNatives(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Thread::registerNatives(const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Thread.registerNatives] called");
         return ExecutionResult::Void();
     }
     
-    ExecutionResult Thread::currentThread(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Thread::currentThread(const VariableSpan &param_vars) {
         auto thread_v = GetCurrentThreadVariable();
         JAVM_LOG("[java.lang.Thread.currentThread] called");
 
         return ExecutionResult::ReturnVariable(thread_v);
     }
 
-    ExecutionResult Thread::setPriority0(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Thread::setPriority0(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         auto prio_v = param_vars[0];
         const auto prio = prio_v->GetValue<type::Integer>();
         JAVM_LOG("[java.lang.Thread.setPriority0] called - priority: %d", prio);
@@ -31,7 +32,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::Void();
     }
 
-    ExecutionResult Thread::isAlive(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Thread::isAlive(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         auto thread_obj = this_var->GetAs<type::ClassInstance>();
         const auto name_ret = thread_obj->CallInstanceMethod(u"getName", u"()Ljava/lang/String;", this_var);
         if(name_ret.IsInvalidOrThrown()) {
@@ -57,7 +58,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(MakeFalse());
     }
 
-    ExecutionResult Thread::start0(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Thread::start0(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         auto thr_obj = this_var->GetAs<type::ClassInstance>();
         const auto name_ret = thr_obj->CallInstanceMethod(u"getName", u"()Ljava/lang/String;", this_var);
         if(name_ret.IsInvalidOrThrown()) {
@@ -71,4 +72,61 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::Void();
     }
 
-}
\ No newline at end of file
+    ExecutionResult Thread::sleep(const VariableSpan &param_vars) {
+        auto ms_v = param_vars[0];
+        const auto ms = ms_v->GetValue<type::Long>();
+        JAVM_LOG("[java.lang.Thread.sleep] called - ms: %ld", ms);
+        if(ms < 0) {
+            return Throw(u"java/lang/IllegalArgumentException");
+        }
+
+        auto cur_accessor = GetCurrentThread();
+        if(!cur_accessor) {
+            return ThrowInternal(u"Unable to get current thread");
+        }
+
+        // Park on the sleep parker until the deadline, so that interrupting the thread wakes it right away
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+        while(true) {
+            if(cur_accessor->ClearInterrupted()) {
+                return Throw(u"java/lang/InterruptedException");
+            }
+
+            const auto remaining_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if(remaining_ns <= 0) {
+                break;
+            }
+            ScopedBlockedState blocked(cur_accessor);
+            cur_accessor->GetSleepParker()->Park(false, remaining_ns);
+        }
+        return ExecutionResult::Void();
+    }
+
+    ExecutionResult Thread::yield(const VariableSpan &param_vars) {
+        native::YieldCurrentThread();
+        return ExecutionResult::Void();
+    }
+
+    ExecutionResult Thread::interrupt0(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        JAVM_LOG("[java.lang.Thread.interrupt0] called");
+        auto accessor = GetThreadByVariable(this_var);
+        if(accessor) {
+            accessor->Interrupt();
+        }
+        return ExecutionResult::Void();
+    }
+
+    ExecutionResult Thread::isInterrupted(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto clear_v = param_vars[0];
+        const auto clear = clear_v->GetValue<type::Boolean>();
+
+        auto accessor = GetThreadByVariable(this_var);
+        if(!accessor) {
+            return ExecutionResult::ReturnVariable(MakeFalse());
+        }
+
+        const auto interrupted = clear ? accessor->ClearInterrupted() : accessor->IsInterrupted();
+        return ExecutionResult::ReturnVariable(interrupted ? MakeTrue() : MakeFalse());
+    }
+
+}
@@ -32,7 +32,7 @@ namespace javm::native::impl::java::lang {
 
     }
 
-    ExecutionResult Throwable::fillInStackTrace(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Throwable::fillInStackTrace(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Throwable.fillInStackTrace] called");
 
         auto call_stack = GetCurrentThread()->GetInvertedCallStack();
@@ -58,7 +58,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(this_var);
     }
 
-    ExecutionResult Throwable::getStackTraceDepth(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Throwable::getStackTraceDepth(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[java.lang.Throwable.getStackTraceDepth] called");
 
         auto this_obj = this_var->GetAs<type::ClassInstance>();
@@ -70,7 +70,7 @@ namespace javm::native::impl::java::lang {
         return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(stack_trace_elem_arr->GetLength()));
     }
 
-    ExecutionResult Throwable::getStackTraceElement(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Throwable::getStackTraceElement(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         auto idx_v = param_vars[0];
         const auto idx = idx_v->GetValue<type::Integer>();
 
@@ -0,0 +1,17 @@
+#include <javm/javm_VM.hpp>
+#include <javm/native/impl/java/lang/ref/ref_Reference.hpp>
+
+namespace javm::native::impl::java::lang::ref {
+
+    using namespace vm;
+
+    // Not native in Java, but the collector needs to know about referents being loaded:
+    // while a concurrent mark runs, a loaded referent might become strongly reachable from somewhere the marker already went through, so it's logged as if it had been overwritten
+    ExecutionResult Reference::get(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto this_obj = this_var->GetAs<type::ClassInstance>();
+        auto referent_v = this_obj->GetField(u"referent", u"Ljava/lang/Object;");
+        LogOverwrittenHeapSlot(referent_v);
+        return ExecutionResult::ReturnVariable(referent_v);
+    }
+
+}
\ No newline at end of file
@@ -5,7 +5,7 @@ namespace javm::native::impl::java::security {
 
     using namespace vm;
 
-    ExecutionResult AccessController::doPrivileged(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult AccessController::doPrivileged(const VariableSpan &param_vars) {
         auto action_v = param_vars[0];
         JAVM_LOG("[java.security.AccessController.doPrivileged] called - action type: '%s'", str::ToUtf8(FormatVariableType(action_v)).c_str());
         auto action_obj = action_v->GetAs<type::ClassInstance>();
@@ -14,7 +14,7 @@ namespace javm::native::impl::java::security {
         return res;
     }
 
-    ExecutionResult AccessController::getStackAccessControlContext(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult AccessController::getStackAccessControlContext(const VariableSpan &param_vars) {
         JAVM_LOG("[java.security.AccessController.getStackAccessControlContext] called");
         return ExecutionResult::ReturnVariable(MakeNull());
     }
@@ -5,7 +5,7 @@ namespace javm::native::impl::java::util::concurrent::atomic {
 
     using namespace vm;
 
-    ExecutionResult AtomicLong::VMSupportsCS8(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult AtomicLong::VMSupportsCS8(const VariableSpan &param_vars) {
         JAVM_LOG("[java.util.concurrent.atomic.AtomicLong.VMSupportsCS8] called");
         return ExecutionResult::ReturnVariable(MakeFalse());
     }
@@ -5,7 +5,7 @@ namespace javm::native::impl::sun::io {
 
     using namespace vm;
 
-    ExecutionResult Win32ErrorMode::setErrorMode(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Win32ErrorMode::setErrorMode(const VariableSpan &param_vars) {
         JAVM_LOG("[sun.misc.Signal.handle0] setErrorMode...");
         return ExecutionResult::ReturnVariable(param_vars[0]);
     }
@@ -8,182 +8,451 @@ namespace javm::native::impl::sun::misc {
 
     namespace {
 
-        template<typename T>
-        inline type::Boolean DoCompareAndSwap(Ptr<T> ptr, const T old_v, const T new_v) {
-            if(ptr::GetValue(ptr) == old_v) {
-                ptr::SetValue(ptr, new_v);
-                return true;
+        // Array "offsets" are just element indexes scaled by this
+        constexpr type::Integer ArrayIndexScale = sizeof(intptr_t);
+
+        union UnsafeOffset {
+            struct {
+                type::Integer offset;
+                // Instance field offsets are relative to the declaring class, so its depth in the super class chain is kept too
+                u16 class_depth;
+                u16 is_static;
+            };
+            type::Long raw_offset;
+        };
+
+        struct DecodedUnsafeOffset {
+            type::Integer offset;
+            u32 class_depth;
+            bool is_static;
+        };
+
+        constexpr inline DecodedUnsafeOffset DecodeUnsafeOffset(const type::Long raw_off) {
+            UnsafeOffset offset{};
+            offset.raw_offset = raw_off;
+            return { offset.offset, offset.class_depth, static_cast<bool>(offset.is_static) };
+        }
+
+        constexpr inline type::Long EncodeUnsafeOffset(const type::Integer off, const u32 class_depth, const bool is_static) {
+            UnsafeOffset offset{};
+            offset.offset = off;
+            offset.class_depth = static_cast<u16>(class_depth);
+            offset.is_static = static_cast<u16>(is_static);
+            return offset.raw_offset;
+        }
+
+        u32 GetClassTypeDepth(Ptr<ClassType> class_type) {
+            u32 depth = 0;
+            auto super_class_type = class_type->GetSuperClassType();
+            while(super_class_type) {
+                depth++;
+                super_class_type = super_class_type->GetSuperClassType();
+            }
+            return depth;
+        }
+
+        Ptr<ClassType> GetFieldClassType(Ptr<Variable> field_v) {
+            auto field_obj = field_v->GetAs<type::ClassInstance>();
+            auto class_type_v = field_obj->GetField(u"clazz", u"Ljava/lang/Class;");
+            auto ref_type = GetReflectionTypeFromClassVariable(class_type_v);
+            if(ref_type && ref_type->IsClassInstance()) {
+                return ref_type->GetClassType();
+            }
+            return nullptr;
+        }
+
+        type::Long GetFieldUnsafeOffset(Ptr<Variable> field_v) {
+            auto field_obj = field_v->GetAs<type::ClassInstance>();
+            auto field_name_v = field_obj->GetField(u"name", u"Ljava/lang/String;");
+            const auto field_name = jutil::GetStringValue(field_name_v);
+            auto field_desc_v = field_obj->GetField(u"signature", u"Ljava/lang/String;");
+            const auto field_desc = jutil::GetStringValue(field_desc_v);
+            auto class_type = GetFieldClassType(field_v);
+            if(class_type) {
+                const auto offset = class_type->GetRawFieldUnsafeOffset(field_name, field_desc);
+                const auto is_static = class_type->IsRawFieldStatic(field_name, field_desc);
+                const auto class_depth = is_static ? 0 : GetClassTypeDepth(class_type);
+                JAVM_LOG("[sun.misc.Unsafe] field: '%s' - '%s', offset: %d, depth: %d", str::ToUtf8(field_name).c_str(), str::ToUtf8(field_desc).c_str(), offset, class_depth);
+                return EncodeUnsafeOffset(offset, class_depth, is_static);
+            }
+            return -1;
+        }
+
+        // Either a variable slot, or the raw element of a primitive array
+        struct UnsafeSlot {
+            VariableSlot *slot;
+            void *element;
+            VariableType type;
+
+            inline bool IsValid() const {
+                return (this->slot != nullptr) || (this->element != nullptr);
+            }
+        };
+
+        // Find the actual storage an (object, offset) pair refers to: an array element, an instance field or a static field
+        UnsafeSlot ResolveUnsafeSlot(Ptr<Variable> obj_v, const type::Long raw_off) {
+            if(obj_v->CanGetAs<VariableType::Array>()) {
+                auto obj_arr = obj_v->GetAs<type::Array>();
+                const auto idx = raw_off / ArrayIndexScale;
+                if((idx >= 0) && (idx < obj_arr->GetLength())) {
+                    if(obj_arr->IsPrimitiveArray()) {
+                        return { nullptr, obj_arr->GetElementAddressAt(static_cast<u32>(idx)), obj_arr->GetVariableType() };
+                    }
+                    return { &obj_arr->GetSlotAt(static_cast<u32>(idx)), nullptr, obj_arr->GetVariableType() };
+                }
+            }
+            else if(obj_v->CanGetAs<VariableType::ClassInstance>()) {
+                auto obj = obj_v->GetAs<type::ClassInstance>();
+                const auto [off, class_depth, is_static] = DecodeUnsafeOffset(raw_off);
+                ClassField *field = nullptr;
+                if(is_static) {
+                    // The base of static fields is the java.lang.Class object (see staticFieldBase)
+                    auto class_type = obj->GetClassType();
+                    if(EqualClassNames(class_type->GetClassName(), u"java/lang/Class")) {
+                        auto ref_type = GetReflectionTypeFromClassVariable(obj_v);
+                        if(ref_type && ref_type->IsClassInstance()) {
+                            class_type = ref_type->GetClassType();
+                        }
+                    }
+                    const auto ret = class_type->EnsureStaticInitializerCalled();
+                    if(!ret.IsInvalidOrThrown() && (off >= 0) && (static_cast<u32>(off) < class_type->GetStaticFieldCount())) {
+                        const auto slot = static_cast<u32>(off);
+                        return { &class_type->GetStaticFieldSlot(slot), nullptr, class_type->GetStaticFieldType(slot) };
+                    }
+                }
+                else {
+                    // Go up to the sub-instance of the class declaring the field
+                    u32 obj_depth = 0;
+                    for(auto super_obj = obj->GetSuperClassInstance(); super_obj; super_obj = super_obj->GetSuperClassInstance()) {
+                        obj_depth++;
+                    }
+                    auto field_obj = obj;
+                    for(u32 i = class_depth; (i < obj_depth) && field_obj; i++) {
+                        field_obj = field_obj->GetSuperClassInstance();
+                    }
+                    if(field_obj) {
+                        field = field_obj->GetFieldByUnsafeOffset(off);
+                    }
+                }
+                if(field != nullptr) {
+                    return { &field->GetVariableSlot(), nullptr, field->GetVariableType() };
+                }
+            }
+
+            return { nullptr, nullptr, VariableType::Invalid };
+        }
+
+        // Primitive array elements are plain memory, accessed through the compiler's atomic builtins instead
+
+        Ptr<Variable> UnsafeLoad(const UnsafeSlot &slot) {
+            if(slot.element != nullptr) {
+                Ptr<Variable> elem_v;
+                VisitPrimitiveArrayData(slot.type, slot.element, [&](auto *elem) {
+                    std::remove_pointer_t<decltype(elem)> val;
+                    __atomic_load(elem, &val, __ATOMIC_SEQ_CST);
+                    elem_v = NewArrayElementVariable(val);
+                });
+                return elem_v;
+            }
+            return AtomicLoadSlot(*slot.slot, slot.type);
+        }
+
+        void UnsafeStore(const UnsafeSlot &slot, Ptr<Variable> new_v, const bool ordered) {
+            if(slot.element != nullptr) {
+                VisitPrimitiveArrayData(slot.type, slot.element, [&](auto *elem) {
+                    auto val = GetArrayElementValue<std::remove_pointer_t<decltype(elem)>>(new_v);
+                    __atomic_store(elem, &val, ordered ? __ATOMIC_RELEASE : __ATOMIC_SEQ_CST);
+                });
             }
             else {
-                ptr::SetValue(ptr, old_v);
-                return false;
+                AtomicStoreSlot(*slot.slot, new_v);
             }
         }
 
-        constexpr inline std::pair<type::Integer, bool> DecodeUnsafeOffset(const type::Long raw_off) {
-            union {
-                struct {
-                    type::Integer is_static;
-                    type::Integer offset;
-                };
-                type::Long raw_offset;
-            } offset{};
-            offset.raw_offset = raw_off;
-            return { offset.offset, static_cast<bool>(offset.is_static) };
+        // Same semantics as AtomicUpdateSlot
+        template<typename Fn>
+        Ptr<Variable> UnsafeUpdate(const UnsafeSlot &slot, Fn update_fn) {
+            if(slot.element != nullptr) {
+                Ptr<Variable> old_v;
+                VisitPrimitiveArrayData(slot.type, slot.element, [&](auto *elem) {
+                    using E = std::remove_pointer_t<decltype(elem)>;
+                    E cur_val;
+                    __atomic_load(elem, &cur_val, __ATOMIC_SEQ_CST);
+                    while(true) {
+                        old_v = NewArrayElementVariable(cur_val);
+                        auto new_v = update_fn(old_v);
+                        if(!new_v) {
+                            return;
+                        }
+                        // On failure cur_val gets updated with the actual current value, so just retry
+                        auto new_val = GetArrayElementValue<E>(new_v);
+                        if(__atomic_compare_exchange(elem, &cur_val, &new_val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+                            return;
+                        }
+                    }
+                });
+                return old_v;
+            }
+            return AtomicUpdateSlot(*slot.slot, slot.type, update_fn);
         }
 
-        constexpr inline type::Long EncodeUnsafeOffset(const type::Integer off, const bool is_static) {
-            union {
-                struct {
-                    type::Integer is_static;
-                    type::Integer offset;
-                };
-                type::Long raw_offset;
-            } offset{};
-            offset.offset = off;
-            offset.is_static = static_cast<type::Integer>(is_static);
-            return offset.raw_offset;
+        inline ExecutionResult ThrowInvalidUnsafeAccess(Ptr<Variable> obj_v, const type::Long raw_off) {
+            return ThrowInternal(str::Format("Invalid Unsafe access - object: %s, offset: 0x%lX", str::ToUtf8(FormatVariableType(obj_v)).c_str(), raw_off));
+        }
+
+        // (Object o, long offset)
+        ExecutionResult DoGetVolatile(const VariableSpan &param_vars) {
+            auto obj_v = param_vars[0];
+            const auto raw_off = param_vars[1]->GetValue<type::Long>();
+            const auto slot = ResolveUnsafeSlot(obj_v, raw_off);
+            if(!slot.IsValid()) {
+                return ThrowInvalidUnsafeAccess(obj_v, raw_off);
+            }
+            return ExecutionResult::ReturnVariable(UnsafeLoad(slot));
+        }
+
+        // (Object o, long offset, <type> x)
+        ExecutionResult DoPutVolatile(const VariableSpan &param_vars, const bool ordered) {
+            auto obj_v = param_vars[0];
+            const auto raw_off = param_vars[1]->GetValue<type::Long>();
+            auto new_v = param_vars[2];
+            const auto slot = ResolveUnsafeSlot(obj_v, raw_off);
+            if(!slot.IsValid()) {
+                return ThrowInvalidUnsafeAccess(obj_v, raw_off);
+            }
+            UnsafeStore(slot, new_v, ordered);
+            return ExecutionResult::Void();
+        }
+
+        // (Object o, long offset, <type> expected, <type> x)
+        template<typename T>
+        ExecutionResult DoCompareAndSwap(const VariableSpan &param_vars) {
+            auto obj_v = param_vars[0];
+            const auto raw_off = param_vars[1]->GetValue<type::Long>();
+            auto expected_v = param_vars[2];
+            auto new_v = param_vars[3];
+            const auto slot = ResolveUnsafeSlot(obj_v, raw_off);
+            if(!slot.IsValid()) {
+                return ThrowInvalidUnsafeAccess(obj_v, raw_off);
+            }
+
+            bool swapped = false;
+            UnsafeUpdate(slot, [&](Ptr<Variable> cur_v) -> Ptr<Variable> {
+                if constexpr(std::is_same_v<T, type::ClassInstance>) {
+                    // Objects are compared by reference
+                    swapped = IsSameObject(cur_v, expected_v);
+                }
+                else {
+                    swapped = cur_v->GetValue<T>() == expected_v->GetValue<T>();
+                }
+                return swapped ? new_v : nullptr;
+            });
+            return ExecutionResult::ReturnVariable(swapped ? MakeTrue() : MakeFalse());
+        }
+
+        // (Object o, long offset, <type> x), returns the old value
+        template<typename T>
+        ExecutionResult DoGetAndAdd(const VariableSpan &param_vars) {
+            auto obj_v = param_vars[0];
+            const auto raw_off = param_vars[1]->GetValue<type::Long>();
+            const auto delta = param_vars[2]->GetValue<T>();
+            const auto slot = ResolveUnsafeSlot(obj_v, raw_off);
+            if(!slot.IsValid()) {
+                return ThrowInvalidUnsafeAccess(obj_v, raw_off);
+            }
+
+            auto old_v = UnsafeUpdate(slot, [&](Ptr<Variable> cur_v) -> Ptr<Variable> {
+                // Java integer overflow wraps around
+                using U = std::make_unsigned_t<T>;
+                return NewPrimitiveVariable<T>(static_cast<T>(static_cast<U>(cur_v->GetValue<T>()) + static_cast<U>(delta)));
+            });
+            return ExecutionResult::ReturnVariable(old_v);
+        }
+
+        // (Object o, long offset, <type> x), returns the old value
+        ExecutionResult DoGetAndSet(const VariableSpan &param_vars) {
+            auto obj_v = param_vars[0];
+            const auto raw_off = param_vars[1]->GetValue<type::Long>();
+            auto new_v = param_vars[2];
+            const auto slot = ResolveUnsafeSlot(obj_v, raw_off);
+            if(!slot.IsValid()) {
+                return ThrowInvalidUnsafeAccess(obj_v, raw_off);
+            }
+
+            auto old_v = UnsafeUpdate(slot, [&](Ptr<Variable>) -> Ptr<Variable> {
+                return new_v;
+            });
+            return ExecutionResult::ReturnVariable(old_v);
         }
 
     }
 
-    ExecutionResult Unsafe::registerNatives(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Unsafe::registerNatives(const VariableSpan &param_vars) {
         JAVM_LOG("[sun.misc.Unsafe.registerNatives] called");
         return ExecutionResult::Void();
     }
 
-    ExecutionResult Unsafe::arrayBaseOffset(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Unsafe::arrayBaseOffset(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[sun.misc.Unsafe.arrayBaseOffset] called");
         return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(0));
     }
 
-    ExecutionResult Unsafe::arrayIndexScale(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Unsafe::arrayIndexScale(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[sun.misc.Unsafe.arrayIndexScale] called");
-        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(sizeof(intptr_t)));
+        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(ArrayIndexScale));
     }
 
-    ExecutionResult Unsafe::addressSize(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    type::Integer Unsafe::addressSize(const Ptr<Variable> &this_var) {
         JAVM_LOG("[sun.misc.Unsafe.addressSize] called");
-        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(sizeof(intptr_t)));
+        return sizeof(intptr_t);
     }
 
-    ExecutionResult Unsafe::objectFieldOffset(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Unsafe::objectFieldOffset(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[sun.misc.Unsafe.objectFieldOffset] called");
-        auto field_v = param_vars[0];
-        auto field_obj = field_v->GetAs<type::ClassInstance>();
-        auto field_name_v = field_obj->GetField(u"name", u"Ljava/lang/String;");
-        const auto field_name = jutil::GetStringValue(field_name_v);
-        auto field_desc_v = field_obj->GetField(u"signature", u"Ljava/lang/String;");
-        const auto field_desc = jutil::GetStringValue(field_desc_v);
-        auto class_type_v = field_obj->GetField(u"clazz", u"Ljava/lang/Class;");
-        auto ref_type = GetReflectionTypeFromClassVariable(class_type_v);
-        if(ref_type) {
-            JAVM_LOG("[sun.misc.Unsafe.objectFieldOffset] reflection type name: '%s'", str::ToUtf8(ref_type->GetTypeName()).c_str());
-            if(ref_type->IsClassInstance()) {
-                auto class_type = ref_type->GetClassType();
-                const auto offset = class_type->GetRawFieldUnsafeOffset(field_name, field_desc);
-                const auto is_static = class_type->IsRawFieldStatic(field_name, field_desc);
-                const auto raw_offset = EncodeUnsafeOffset(offset, is_static);
-                JAVM_LOG("[sun.misc.Unsafe.objectFieldOffset] field: '%s' - '%s', offset: %d", str::ToUtf8(field_name).c_str(), str::ToUtf8(field_desc).c_str(), offset);
-                ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(raw_offset));
-            }
-        }
+        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(GetFieldUnsafeOffset(param_vars[0])));
+    }
 
-        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(0));
+    ExecutionResult Unsafe::staticFieldOffset(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        JAVM_LOG("[sun.misc.Unsafe.staticFieldOffset] called");
+        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Long>(GetFieldUnsafeOffset(param_vars[0])));
     }
 
-    ExecutionResult Unsafe::getIntVolatile(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
-        auto obj_v = param_vars[0];
-        auto obj_obj = obj_v->GetAs<type::ClassInstance>();
-        auto obj_type = obj_obj->GetClassType();
-        auto raw_off_v = param_vars[1];
-        const auto raw_off = raw_off_v->GetValue<type::Long>();
-        const auto [off, is_static] = DecodeUnsafeOffset(raw_off);
-        JAVM_LOG("[sun.misc.Unsafe.getIntVolatile] called - offset: %d, static: %s", off, is_static ? "true" : "false");
+    ExecutionResult Unsafe::staticFieldBase(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        JAVM_LOG("[sun.misc.Unsafe.staticFieldBase] called");
+        auto field_obj = param_vars[0]->GetAs<type::ClassInstance>();
+        return ExecutionResult::ReturnVariable(field_obj->GetField(u"clazz", u"Ljava/lang/Class;"));
+    }
 
-        if(is_static) {
-            auto var = obj_type->GetStaticFieldByUnsafeOffset(off);
-            JAVM_LOG("[sun.misc.Unsafe.getIntVolatile] returning '%s'...", str::ToUtf8(FormatVariableType(var)).c_str());
-            return ExecutionResult::ReturnVariable(var);
-        }
-        else {
-            auto var = obj_obj->GetFieldByUnsafeOffset(off);
-            JAVM_LOG("[sun.misc.Unsafe.getIntVolatile] returning '%s'...", str::ToUtf8(FormatVariableType(var)).c_str());
-            return ExecutionResult::ReturnVariable(var);
-        }
+    // All of these work the same way, since variables already hold their type
+
+    #define _JAVM_UNSAFE_GET_PUT_IMPL(type_name) \
+    ExecutionResult Unsafe::get##type_name(Ptr<Variable> this_var, const VariableSpan &param_vars) { \
+        return DoGetVolatile(param_vars); \
+    } \
+    ExecutionResult Unsafe::put##type_name(Ptr<Variable> this_var, const VariableSpan &param_vars) { \
+        return DoPutVolatile(param_vars, false); \
+    } \
+    ExecutionResult Unsafe::get##type_name##Volatile(Ptr<Variable> this_var, const VariableSpan &param_vars) { \
+        return DoGetVolatile(param_vars); \
+    } \
+    ExecutionResult Unsafe::put##type_name##Volatile(Ptr<Variable> this_var, const VariableSpan &param_vars) { \
+        return DoPutVolatile(param_vars, false); \
+    }
+
+    _JAVM_UNSAFE_GET_PUT_IMPL(Object)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Int)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Long)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Boolean)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Byte)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Short)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Char)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Float)
+    _JAVM_UNSAFE_GET_PUT_IMPL(Double)
+
+    #undef _JAVM_UNSAFE_GET_PUT_IMPL
+
+    ExecutionResult Unsafe::putOrderedObject(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoPutVolatile(param_vars, true);
+    }
 
-        return ExecutionResult::ReturnVariable(NewPrimitiveVariable<type::Integer>(sizeof(intptr_t)));
+    ExecutionResult Unsafe::putOrderedInt(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoPutVolatile(param_vars, true);
     }
 
-    ExecutionResult Unsafe::compareAndSwapInt(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Unsafe::putOrderedLong(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoPutVolatile(param_vars, true);
+    }
+
+    ExecutionResult Unsafe::compareAndSwapObject(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        JAVM_LOG("[sun.misc.Unsafe.compareAndSwapObject] called");
+        return DoCompareAndSwap<type::ClassInstance>(param_vars);
+    }
+
+    ExecutionResult Unsafe::compareAndSwapInt(Ptr<Variable> this_var, const VariableSpan &param_vars) {
         JAVM_LOG("[sun.misc.Unsafe.compareAndSwapInt] called");
-        auto var_v = param_vars[0];
-        auto var_obj = var_v->GetAs<type::ClassInstance>();
-        auto raw_off_v = param_vars[1];
-        const auto raw_off = raw_off_v->GetValue<type::Long>();
-        auto expected_v = param_vars[2];
-        const auto expected = expected_v->GetValue<type::Integer>();
-        auto newv_v = param_vars[3];
-        const auto newv = newv_v->GetValue<type::Integer>();
-        const auto [off, is_static] = DecodeUnsafeOffset(raw_off);
-        Ptr<Variable> field_v;
-        if(is_static) {
-            field_v = var_obj->GetClassType()->GetStaticFieldByUnsafeOffset(off);
-        }
-        else {
-            field_v = var_obj->GetFieldByUnsafeOffset(off);
-        }
-        if(field_v) {
-            auto field_ref = field_v->GetAs<type::Integer>();
-            JAVM_LOG("[sun.misc.Unsafe.compareAndSwapInt] Offset: %d, Static: %s, Value: %d, Expected: %d, New: %d", off, is_static ? "true" : "false", ptr::GetValue(field_ref), expected, newv);
-            const auto ret = DoCompareAndSwap(field_ref, expected, newv);
-            field_v->SetAs<type::Integer>(field_ref);
-            if(ret) {
-                return ExecutionResult::ReturnVariable(MakeTrue());
-            }
-        }
+        return DoCompareAndSwap<type::Integer>(param_vars);
+    }
+
+    ExecutionResult Unsafe::compareAndSwapLong(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        JAVM_LOG("[sun.misc.Unsafe.compareAndSwapLong] called");
+        return DoCompareAndSwap<type::Long>(param_vars);
+    }
+
+    ExecutionResult Unsafe::getAndAddInt(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoGetAndAdd<type::Integer>(param_vars);
+    }
+
+    ExecutionResult Unsafe::getAndAddLong(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoGetAndAdd<type::Long>(param_vars);
+    }
 
-        return ExecutionResult::ReturnVariable(MakeFalse());
+    ExecutionResult Unsafe::getAndSetInt(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoGetAndSet(param_vars);
     }
 
-    ExecutionResult Unsafe::allocateMemory(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
-        auto size_v = param_vars[0];
-        const auto size = size_v->GetValue<type::Long>();
+    ExecutionResult Unsafe::getAndSetLong(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoGetAndSet(param_vars);
+    }
+
+    ExecutionResult Unsafe::getAndSetObject(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        return DoGetAndSet(param_vars);
+    }
+
+    type::Long Unsafe::allocateMemory(const Ptr<Variable> &this_var, const type::Long size) {
         auto ptr = new u8[size]();
         JAVM_LOG("[sun.misc.Unsafe.allocateMemory] called - Size: %ld, Ptr: %p", size, ptr);
-        const auto ptr_val = reinterpret_cast<intptr_t>(ptr);
-        auto ptr_v = NewPrimitiveVariable<type::Long>(ptr_val);
-        return ExecutionResult::ReturnVariable(ptr_v);
+        return reinterpret_cast<intptr_t>(ptr);
     }
 
-    ExecutionResult Unsafe::putLong(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
-        auto addr_v = param_vars[0];
-        const auto addr = addr_v->GetValue<type::Long>();
-        auto val_v = param_vars[1];
-        const auto val = val_v->GetValue<type::Long>();
+    void Unsafe::putLongAddress(const Ptr<Variable> &this_var, const type::Long addr, const type::Long val) {
         auto ptr = reinterpret_cast<type::Long*>(addr);
         JAVM_LOG("[sun.misc.Unsafe.putLong] called - Addr: %p, Value: %ld", ptr, val);
         *ptr = val;
-        return ExecutionResult::Void();
     }
 
-    ExecutionResult Unsafe::getByte(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
-        auto addr_v = param_vars[0];
-        const auto addr = addr_v->GetValue<type::Long>();
-        auto ptr = reinterpret_cast<u8*>(addr);
+    i8 Unsafe::getByteAddress(const Ptr<Variable> &this_var, const type::Long addr) {
+        auto ptr = reinterpret_cast<i8*>(addr);
         JAVM_LOG("[sun.misc.Unsafe.getByte] called - Addr: %p", ptr);
-        const auto byte = *ptr;
-        auto byte_v = NewPrimitiveVariable<type::Byte>(static_cast<type::Byte>(byte));
-        return ExecutionResult::ReturnVariable(byte_v);
+        return *ptr;
     }
 
-    ExecutionResult Unsafe::freeMemory(Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
-        auto addr_v = param_vars[0];
-        const auto addr = addr_v->GetValue<type::Long>();
+    void Unsafe::freeMemory(const Ptr<Variable> &this_var, const type::Long addr) {
         auto ptr = reinterpret_cast<u8*>(addr);
         JAVM_LOG("[sun.misc.Unsafe.freeMemory] called - Addr: %p", ptr);
         delete[] ptr;
+    }
+
+    ExecutionResult Unsafe::park(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto is_absolute_v = param_vars[0];
+        const auto is_absolute = is_absolute_v->GetValue<type::Boolean>();
+        auto time_v = param_vars[1];
+        const auto time = time_v->GetValue<type::Long>();
+
+        auto cur_accessor = GetCurrentThread();
+        if(!cur_accessor) {
+            return ThrowInternal(u"Unable to get current thread");
+        }
+
+        // Interrupted threads don't park (and the interrupt status is kept)
+        if(!cur_accessor->IsInterrupted()) {
+            ScopedBlockedState blocked(cur_accessor);
+            cur_accessor->GetParker()->Park(is_absolute, time);
+        }
+        return ExecutionResult::Void();
+    }
+
+    ExecutionResult Unsafe::unpark(Ptr<Variable> this_var, const VariableSpan &param_vars) {
+        auto thread_v = param_vars[0];
+        if(thread_v->IsNull()) {
+            return ExecutionResult::Void();
+        }
+
+        // Unparking a thread which isn't alive has no effect
+        auto accessor = GetThreadByVariable(thread_v);
+        if(accessor) {
+            accessor->GetParker()->Unpark();
+        }
         return ExecutionResult::Void();
     }
 
-}
\ No newline at end of file
+}
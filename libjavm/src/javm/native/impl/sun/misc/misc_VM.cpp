@@ -5,7 +5,7 @@ namespace javm::native::impl::sun::misc {
 
     using namespace vm;
 
-    ExecutionResult VM::initialize(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult VM::initialize(const VariableSpan &param_vars) {
         JAVM_LOG("[sun.misc.VM.initialize] called");
         return ExecutionResult::Void();
     }
@@ -5,7 +5,7 @@ namespace javm::native::impl::sun::nio::cs {
 
     using namespace vm;
 
-    ExecutionResult StreamEncoder::forOutputStreamWriter(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult StreamEncoder::forOutputStreamWriter(const VariableSpan &param_vars) {
         auto stream_v = param_vars[0];
         auto obj_v = param_vars[1];
         auto cs_name_v = param_vars[2];
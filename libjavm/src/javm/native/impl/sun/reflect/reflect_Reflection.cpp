@@ -6,7 +6,7 @@ namespace javm::native::impl::sun::reflect {
 
     using namespace vm;
 
-    ExecutionResult Reflection::getCallerClass(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Reflection::getCallerClass(const VariableSpan &param_vars) {
         auto accessor = GetCurrentThread();
         JAVM_LOG("[sun.reflect.Reflection.getCallerClass] called...");
 
@@ -22,7 +22,7 @@ namespace javm::native::impl::sun::reflect {
                 // This one is a valid one
                 JAVM_LOG("[sun.reflect.Reflection.getCallerClass] called - caller class type: '%s'...", str::ToUtf8(call_info.caller_type->GetClassName()).c_str());
 
-                auto dummy_ref_type = ref::FindReflectionTypeByName(call_info.caller_type->GetClassName());
+                auto dummy_ref_type = ref::GetReflectionType(call_info.caller_type);
                 return ExecutionResult::ReturnVariable(NewClassTypeVariable(dummy_ref_type));
             }
         }
@@ -30,7 +30,7 @@ namespace javm::native::impl::sun::reflect {
         return ExecutionResult::ReturnVariable(MakeNull());
     }
 
-    ExecutionResult Reflection::getClassAccessFlags(const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult Reflection::getClassAccessFlags(const VariableSpan &param_vars) {
         JAVM_LOG("[sun.reflect.Reflection.getClassAccessFlags] called");
         return GetClassModifiers(param_vars[0]);
     }
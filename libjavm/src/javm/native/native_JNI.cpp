@@ -0,0 +1,1975 @@
+#include <javm/javm_VM.hpp>
+#include <javm/native/native_JNI.hpp>
+#include <deque>
+#include <cstddef>
+
+namespace javm::native::jni {
+
+    namespace {
+
+        // JNI references point to these: local ones live in the current thread's local frame, global ones are allocated until deleted
+        // Weak global ones don't keep the object alive
+
+        enum class ReferenceKind : u8 {
+            Local,
+            Global,
+            WeakGlobal
+        };
+
+        struct Reference {
+            ReferenceKind kind;
+            Ptr<vm::Variable> var;
+            std::weak_ptr<vm::type::ClassInstance> weak_obj;
+            std::weak_ptr<vm::type::Array> weak_arr;
+        };
+
+        const JNINativeInterface &GetFunctionTable();
+
+        // Every thread has its own env (natives only ever use the one they were given)
+        // Local references are kept in a deque, so that pushing/popping some never moves the others
+
+        struct ThreadEnv {
+            JNIEnv env;
+            std::deque<Reference> local_refs;
+            std::vector<size_t> local_frames;
+            std::vector<vm::PinnedArrayData> pinned_arrays;
+            Ptr<vm::Variable> pending_throwable;
+            // Set while native code runs (see ScopedNativeState)
+            Ptr<vm::ThreadAccessor> native_accessor;
+
+            ThreadEnv() : env({ &GetFunctionTable() }) {}
+        };
+
+        thread_local ThreadEnv g_ThreadEnv;
+
+        inline ThreadEnv &GetThreadEnv() {
+            return g_ThreadEnv;
+        }
+
+        void PushLocalFrameImpl() {
+            auto &thr_env = GetThreadEnv();
+            thr_env.local_frames.push_back(thr_env.local_refs.size());
+        }
+
+        void PopLocalFrameImpl() {
+            auto &thr_env = GetThreadEnv();
+            if(thr_env.local_frames.empty()) {
+                return;
+            }
+            const auto frame_start = thr_env.local_frames.back();
+            thr_env.local_frames.pop_back();
+            while(thr_env.local_refs.size() > frame_start) {
+                thr_env.local_refs.pop_back();
+            }
+        }
+
+        // Every call into native code (and JNI_OnLoad) runs in its own local frame, so that its local references are released once it returns
+
+        class ScopedLocalFrame {
+            public:
+                ScopedLocalFrame() {
+                    PushLocalFrameImpl();
+                }
+
+                ~ScopedLocalFrame() {
+                    PopLocalFrameImpl();
+                }
+        };
+
+        // Native code might block for as long as it wants, so it runs in the blocked state, like any other blocking call (see ScopedBlockedState)
+        // JNI functions do touch the heap though, so they go back to running (stopping at a pending safepoint first) until they return (see ScopedVMEntry)
+
+        class ScopedNativeState {
+            private:
+                Ptr<vm::ThreadAccessor> prev_accessor;
+                vm::ScopedBlockedState blocked;
+
+            public:
+                ScopedNativeState(Ptr<vm::ThreadAccessor> accessor) : prev_accessor(GetThreadEnv().native_accessor), blocked(accessor) {
+                    GetThreadEnv().native_accessor = accessor;
+                }
+
+                ~ScopedNativeState() {
+                    GetThreadEnv().native_accessor = this->prev_accessor;
+                }
+        };
+
+        // Nested JNI calls (through Java code called from JNI functions) find no accessor, so they leave the state alone
+        class ScopedVMEntry {
+            private:
+                Ptr<vm::ThreadAccessor> accessor;
+
+            public:
+                ScopedVMEntry() {
+                    this->accessor.swap(GetThreadEnv().native_accessor);
+                    if(this->accessor) {
+                        this->accessor->LeaveBlockedState();
+                    }
+                }
+
+                ~ScopedVMEntry() {
+                    if(this->accessor) {
+                        this->accessor->EnterBlockedState();
+                        GetThreadEnv().native_accessor.swap(this->accessor);
+                    }
+                }
+        };
+
+        // Null objects are always null references
+
+        jobject MakeLocalRef(Ptr<vm::Variable> var) {
+            if(!var || var->IsNull()) {
+                return nullptr;
+            }
+            auto &thr_env = GetThreadEnv();
+            thr_env.local_refs.push_back({ ReferenceKind::Local, var, {}, {} });
+            return reinterpret_cast<jobject>(&thr_env.local_refs.back());
+        }
+
+        jobject MakeGlobalRef(Ptr<vm::Variable> var, const bool weak) {
+            if(!var || var->IsNull()) {
+                return nullptr;
+            }
+            auto ref = new Reference();
+            if(weak) {
+                ref->kind = ReferenceKind::WeakGlobal;
+                if(var->CanGetAs<vm::VariableType::ClassInstance>()) {
+                    ref->weak_obj = var->GetAs<vm::type::ClassInstance>();
+                }
+                else if(var->CanGetAs<vm::VariableType::Array>()) {
+                    ref->weak_arr = var->GetAs<vm::type::Array>();
+                }
+            }
+            else {
+                ref->kind = ReferenceKind::Global;
+                ref->var = var;
+            }
+            return reinterpret_cast<jobject>(ref);
+        }
+
+        inline Reference *GetReference(jobject ref) {
+            return reinterpret_cast<Reference*>(ref);
+        }
+
+        // Null, deleted and cleared (weak) references are null objects
+        Ptr<vm::Variable> GetVariable(jobject ref) {
+            if(ref == nullptr) {
+                return vm::MakeNull();
+            }
+            auto reference = GetReference(ref);
+            if(reference->kind == ReferenceKind::WeakGlobal) {
+                if(auto obj = reference->weak_obj.lock()) {
+                    return ptr::New<vm::Variable>(obj);
+                }
+                if(auto arr = reference->weak_arr.lock()) {
+                    return ptr::New<vm::Variable>(arr);
+                }
+                return vm::MakeNull();
+            }
+            if(!reference->var) {
+                return vm::MakeNull();
+            }
+            return reference->var;
+        }
+
+        inline void SetPendingThrowable(Ptr<vm::Variable> throwable_v) {
+            GetThreadEnv().pending_throwable = throwable_v;
+        }
+
+        inline void ThrowPending(const String &type, const String &msg = u"") {
+            SetPendingThrowable(vm::jutil::NewThrowable(type, msg));
+        }
+
+        inline Ptr<vm::Variable> TakePendingThrowable() {
+            auto &thr_env = GetThreadEnv();
+            auto throwable_v = thr_env.pending_throwable;
+            thr_env.pending_throwable = nullptr;
+            return throwable_v;
+        }
+
+        // Java code called from natives: whatever it throws becomes the pending exception, which the native might handle
+        // Thus, the VM's thrown state is reset (it's thrown again once the native returns, if still pending)
+        // Returns the returned variable (nullptr if nothing was returned or if it threw)
+        Ptr<vm::Variable> HandleResult(const vm::ExecutionResult &res) {
+            if(res.Is<vm::ExecutionStatus::Thrown>()) {
+                SetPendingThrowable(res.var);
+                vm::ResetThrown();
+                return nullptr;
+            }
+            else if(res.Is<vm::ExecutionStatus::Invalid>()) {
+                SetPendingThrowable(vm::jutil::NewInternalThrowable(u"Invalid execution from JNI"));
+                return nullptr;
+            }
+            else if(res.Is<vm::ExecutionStatus::VariableReturn>()) {
+                return res.var;
+            }
+            return nullptr;
+        }
+
+        inline bool HandleInitialization(Ptr<vm::ClassType> class_type) {
+            const auto res = class_type->EnsureStaticInitializerCalled();
+            if(res.IsInvalidOrThrown()) {
+                HandleResult(res);
+                return false;
+            }
+            return true;
+        }
+
+        Ptr<vm::ref::ReflectionType> GetReflectionType(jclass clazz) {
+            auto class_v = GetVariable(clazz);
+            if(class_v->IsNull()) {
+                return nullptr;
+            }
+            return vm::ref::FindReflectionTypeByClassVariable(class_v);
+        }
+
+        // Class type of a (non-array, non-primitive) class
+        Ptr<vm::ClassType> GetClassType(jclass clazz) {
+            auto ref_type = GetReflectionType(clazz);
+            if(ref_type && ref_type->IsClassInstance() && !ref_type->IsArray()) {
+                return ref_type->GetClassType();
+            }
+            return nullptr;
+        }
+
+        inline jclass MakeClassRef(Ptr<vm::ref::ReflectionType> ref_type) {
+            if(!ref_type) {
+                return nullptr;
+            }
+            return MakeLocalRef(vm::NewClassTypeVariable(ref_type));
+        }
+
+        Ptr<vm::ref::ReflectionType> GetObjectReflectionType(Ptr<vm::Variable> var) {
+            if(var->CanGetAs<vm::VariableType::ClassInstance>()) {
+                return vm::ref::GetReflectionType(var->GetAs<vm::type::ClassInstance>()->GetClassType());
+            }
+            else if(var->CanGetAs<vm::VariableType::Array>()) {
+                auto arr = var->GetAs<vm::type::Array>();
+                return vm::ref::FindArrayReflectionType(arr);
+            }
+            return nullptr;
+        }
+
+        // Whether a value of the first type can be assigned to the second type
+        bool IsAssignable(Ptr<vm::ref::ReflectionType> from_type, Ptr<vm::ref::ReflectionType> to_type) {
+            if(vm::ref::EqualTypes(from_type, to_type)) {
+                return true;
+            }
+            if(from_type->IsArray()) {
+                if(!to_type->IsArray()) {
+                    // Arrays are objects, and are cloneable and serializable
+                    const auto to_name = to_type->GetTypeName();
+                    return (to_name == u"java.lang.Object") || (to_name == u"java.lang.Cloneable") || (to_name == u"java.io.Serializable");
+                }
+                if(from_type->IsClassInstance() && to_type->IsClassInstance() && (from_type->GetArrayDimensions() == to_type->GetArrayDimensions())) {
+                    return from_type->GetClassType()->IsSubtypeOf(*to_type->GetClassType());
+                }
+                return false;
+            }
+            if(from_type->IsClassInstance() && to_type->IsClassInstance() && !to_type->IsArray()) {
+                return from_type->GetClassType()->IsSubtypeOf(*to_type->GetClassType());
+            }
+            return false;
+        }
+
+        // Descriptor parsing: the function gets the kind of every parameter (as its descriptor's first char, 'L' for any reference, arrays included)
+        // Returns the kind of the return type
+
+        template<typename Fn>
+        char16_t VisitDescriptorTypes(const String &descriptor, Fn fn) {
+            const auto read_kind = [&](size_t &i) -> char16_t {
+                auto kind = descriptor[i];
+                if(kind == u'[') {
+                    while((i < descriptor.length()) && (descriptor[i] == u'[')) {
+                        i++;
+                    }
+                    if((i < descriptor.length()) && (descriptor[i] == u'L')) {
+                        i = descriptor.find(u';', i);
+                    }
+                    kind = u'L';
+                }
+                else if(kind == u'L') {
+                    i = descriptor.find(u';', i);
+                }
+                return kind;
+            };
+
+            auto i = descriptor.find(u'(') + 1;
+            while((i < descriptor.length()) && (descriptor[i] != u')')) {
+                fn(read_kind(i));
+                i++;
+            }
+            i++;
+            if(i >= descriptor.length()) {
+                return u'V';
+            }
+            return read_kind(i);
+        }
+
+        // JNI values <-> variables
+
+        template<typename T>
+        inline T GetValue(Ptr<vm::Variable> var) {
+            if constexpr(std::is_same_v<T, jobject>) {
+                return MakeLocalRef(var);
+            }
+            else {
+                if(!var) {
+                    return T();
+                }
+                if constexpr(std::is_same_v<T, jlong>) {
+                    return var->PeekValue<vm::type::Long>();
+                }
+                else if constexpr(std::is_same_v<T, jfloat>) {
+                    return var->PeekValue<vm::type::Float>();
+                }
+                else if constexpr(std::is_same_v<T, jdouble>) {
+                    return var->PeekValue<vm::type::Double>();
+                }
+                else if constexpr(std::is_same_v<T, jboolean>) {
+                    return (var->PeekValue<vm::type::Integer>() != 0) ? JNI_TRUE : JNI_FALSE;
+                }
+                else {
+                    return static_cast<T>(var->PeekValue<vm::type::Integer>());
+                }
+            }
+        }
+
+        template<typename T>
+        inline Ptr<vm::Variable> MakeVariable(const T val) {
+            if constexpr(std::is_same_v<T, jobject>) {
+                return GetVariable(val);
+            }
+            else if constexpr(std::is_same_v<T, jlong>) {
+                return vm::NewPrimitiveVariable<vm::type::Long>(val);
+            }
+            else if constexpr(std::is_same_v<T, jfloat>) {
+                return vm::NewPrimitiveVariable<vm::type::Float>(val);
+            }
+            else if constexpr(std::is_same_v<T, jdouble>) {
+                return vm::NewPrimitiveVariable<vm::type::Double>(val);
+            }
+            else if constexpr(std::is_same_v<T, jboolean>) {
+                return vm::NewPrimitiveVariable<vm::type::Boolean>((val != JNI_FALSE) ? 1 : 0);
+            }
+            else {
+                return vm::NewPrimitiveVariable<vm::type::Integer>(static_cast<vm::type::Integer>(val));
+            }
+        }
+
+        template<typename R>
+        inline R GetResult(Ptr<vm::Variable> var) {
+            if constexpr(!std::is_void_v<R>) {
+                return GetValue<R>(var);
+            }
+        }
+
+        // Variadic arguments follow C's default promotions (float to double, smaller integers to int)
+
+        std::vector<Ptr<vm::Variable>> ReadArguments(const JNIMemberId &id, va_list args) {
+            std::vector<Ptr<vm::Variable>> param_vars;
+            VisitDescriptorTypes(id.descriptor, [&](const char16_t kind) {
+                switch(kind) {
+                    case u'Z':
+                    case u'B':
+                    case u'C':
+                    case u'S':
+                    case u'I': {
+                        param_vars.push_back(vm::NewPrimitiveVariable<vm::type::Integer>(va_arg(args, jint)));
+                        break;
+                    }
+                    case u'J': {
+                        param_vars.push_back(vm::NewPrimitiveVariable<vm::type::Long>(va_arg(args, jlong)));
+                        break;
+                    }
+                    case u'F': {
+                        param_vars.push_back(vm::NewPrimitiveVariable<vm::type::Float>(static_cast<jfloat>(va_arg(args, jdouble))));
+                        break;
+                    }
+                    case u'D': {
+                        param_vars.push_back(vm::NewPrimitiveVariable<vm::type::Double>(va_arg(args, jdouble)));
+                        break;
+                    }
+                    default: {
+                        param_vars.push_back(GetVariable(va_arg(args, jobject)));
+                        break;
+                    }
+                }
+            });
+            return param_vars;
+        }
+
+        std::vector<Ptr<vm::Variable>> ReadArguments(const JNIMemberId &id, const jvalue *args) {
+            std::vector<Ptr<vm::Variable>> param_vars;
+            u32 i = 0;
+            VisitDescriptorTypes(id.descriptor, [&](const char16_t kind) {
+                const auto &arg = args[i++];
+                switch(kind) {
+                    case u'Z': {
+                        param_vars.push_back(MakeVariable(arg.z));
+                        break;
+                    }
+                    case u'B': {
+                        param_vars.push_back(MakeVariable(arg.b));
+                        break;
+                    }
+                    case u'C': {
+                        param_vars.push_back(MakeVariable(arg.c));
+                        break;
+                    }
+                    case u'S': {
+                        param_vars.push_back(MakeVariable(arg.s));
+                        break;
+                    }
+                    case u'I': {
+                        param_vars.push_back(MakeVariable(arg.i));
+                        break;
+                    }
+                    case u'J': {
+                        param_vars.push_back(MakeVariable(arg.j));
+                        break;
+                    }
+                    case u'F': {
+                        param_vars.push_back(MakeVariable(arg.f));
+                        break;
+                    }
+                    case u'D': {
+                        param_vars.push_back(MakeVariable(arg.d));
+                        break;
+                    }
+                    default: {
+                        param_vars.push_back(MakeVariable(arg.l));
+                        break;
+                    }
+                }
+            });
+            return param_vars;
+        }
+
+        // Field/method IDs
+
+        JNIMemberId *GetMemberId(NativeTable<std::unique_ptr<JNIMemberId>> &table, Ptr<vm::ClassType> class_type, const String &name, const String &descriptor, const bool is_static, const u32 static_slot) {
+            auto &instance = rt::GetCurrentInstance();
+            vm::ScopedMonitorLock lk(instance.native_lock);
+
+            auto &id = table[{ class_type->GetClassName(), name, descriptor }];
+            if(!id) {
+                id.reset(new JNIMemberId({ class_type, name, descriptor, is_static, static_slot }));
+            }
+            return id.get();
+        }
+
+        inline JNIMemberId &GetMemberId(jmethodID method_id) {
+            return *reinterpret_cast<JNIMemberId*>(method_id);
+        }
+
+        inline JNIMemberId &GetMemberId(jfieldID field_id) {
+            return *reinterpret_cast<JNIMemberId*>(field_id);
+        }
+
+        // Looks in the class, its super classes and their interfaces (for default/abstract methods)
+        bool HasMethod(Ptr<vm::ClassType> class_type, const String &name, const String &descriptor, const bool is_static) {
+            if(!class_type) {
+                return false;
+            }
+            for(const auto &fn: class_type->GetRawInvokables()) {
+                if((fn.GetName() == name) && (fn.GetDescriptor() == descriptor) && (fn.HasFlag<vm::AccessFlags::Static>() == is_static)) {
+                    return true;
+                }
+            }
+            if(name == u"<init>") {
+                return false;
+            }
+            if(class_type->HasSuperClass() && HasMethod(class_type->GetSuperClassType(), name, descriptor, is_static)) {
+                return true;
+            }
+            if(!is_static) {
+                for(const auto &intf_name: class_type->GetInterfaceClassNames()) {
+                    if(HasMethod(rt::LocateClassType(intf_name), name, descriptor, is_static)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        Ptr<vm::ClassType> FindInstanceFieldClassType(Ptr<vm::ClassType> class_type, const String &name, const String &descriptor) {
+            while(class_type) {
+                for(const auto &field: class_type->GetRawFields()) {
+                    if(!field.HasFlag<vm::AccessFlags::Static>() && (field.GetName() == name) && (field.GetDescriptor() == descriptor)) {
+                        return class_type;
+                    }
+                }
+                if(!class_type->HasSuperClass()) {
+                    break;
+                }
+                class_type = class_type->GetSuperClassType();
+            }
+            return nullptr;
+        }
+
+        jmethodID GetMethodIdImpl(jclass clazz, const char *name, const char *sig, const bool is_static) {
+            auto class_type = GetClassType(clazz);
+            const auto name_str = str::FromUtf8(name);
+            const auto desc_str = str::FromUtf8(sig);
+            if(!class_type || !HasMethod(class_type, name_str, desc_str, is_static)) {
+                ThrowPending(u"java/lang/NoSuchMethodError", name_str);
+                return nullptr;
+            }
+            if(!HandleInitialization(class_type)) {
+                return nullptr;
+            }
+            auto &instance = rt::GetCurrentInstance();
+            return reinterpret_cast<jmethodID>(GetMemberId(instance.jni_method_ids, class_type, name_str, desc_str, is_static, 0));
+        }
+
+        jfieldID GetFieldIdImpl(jclass clazz, const char *name, const char *sig, const bool is_static) {
+            auto class_type = GetClassType(clazz);
+            const auto name_str = str::FromUtf8(name);
+            const auto desc_str = str::FromUtf8(sig);
+            if(!class_type) {
+                ThrowPending(u"java/lang/NoSuchFieldError", name_str);
+                return nullptr;
+            }
+            if(!HandleInitialization(class_type)) {
+                return nullptr;
+            }
+
+            u32 static_slot = 0;
+            auto field_class_type = is_static ? class_type->ResolveStaticField(name_str, desc_str, static_slot) : FindInstanceFieldClassType(class_type, name_str, desc_str);
+            if(!field_class_type) {
+                ThrowPending(u"java/lang/NoSuchFieldError", name_str);
+                return nullptr;
+            }
+            auto &instance = rt::GetCurrentInstance();
+            return reinterpret_cast<jfieldID>(GetMemberId(instance.jni_field_ids, field_class_type, name_str, desc_str, is_static, static_slot));
+        }
+
+        // Method calls: nonvirtual calls give the class to call the method of, static calls don't use the object
+
+        Ptr<vm::Variable> InvokeMethod(const JNIMemberId &id, Ptr<vm::Variable> this_var, Ptr<vm::ClassType> nonvirtual_class_type, const std::vector<Ptr<vm::Variable>> &param_vars) {
+            if(id.is_static) {
+                return HandleResult(id.class_type->CallClassMethod(id.name, id.descriptor, param_vars));
+            }
+
+            if(this_var->CanGetAs<vm::VariableType::ClassInstance>()) {
+                auto this_obj = this_var->GetAs<vm::type::ClassInstance>();
+                Ptr<vm::ClassInstance> this_obj_c;
+                if(nonvirtual_class_type) {
+                    this_obj_c = this_obj->GetInstanceByClassTypeAndMethodSpecial(this_obj, nonvirtual_class_type->GetClassName(), id.name, id.descriptor);
+                }
+                else {
+                    this_obj_c = this_obj->GetInstanceByClassTypeAndMethodVirtualInterface(this_obj, id.class_type->GetClassName(), id.name, id.descriptor);
+                }
+                if(!this_obj_c) {
+                    ThrowPending(u"java/lang/AbstractMethodError", id.name);
+                    return nullptr;
+                }
+                return HandleResult(this_obj_c->CallInstanceMethod(id.name, id.descriptor, this_var, param_vars));
+            }
+            else if(this_var->CanGetAs<vm::VariableType::Array>()) {
+                auto this_arr = this_var->GetAs<vm::type::Array>();
+                return HandleResult(this_arr->CallInstanceMethod(id.name, id.descriptor, this_var, param_vars));
+            }
+
+            ThrowPending(u"java/lang/NullPointerException");
+            return nullptr;
+        }
+
+        template<typename R>
+        R CallMethodImpl(jobject obj, jmethodID method_id, const std::vector<Ptr<vm::Variable>> &param_vars) {
+            return GetResult<R>(InvokeMethod(GetMemberId(method_id), GetVariable(obj), nullptr, param_vars));
+        }
+
+        template<typename R>
+        R CallNonvirtualMethodImpl(jobject obj, jclass clazz, jmethodID method_id, const std::vector<Ptr<vm::Variable>> &param_vars) {
+            auto class_type = GetClassType(clazz);
+            if(!class_type) {
+                ThrowPending(u"java/lang/NoClassDefFoundError");
+                return GetResult<R>(nullptr);
+            }
+            return GetResult<R>(InvokeMethod(GetMemberId(method_id), GetVariable(obj), class_type, param_vars));
+        }
+
+        jobject NewObjectImpl(jclass clazz, jmethodID method_id, const std::vector<Ptr<vm::Variable>> &param_vars) {
+            auto class_type = GetClassType(clazz);
+            if(!class_type || class_type->IsInterface() || class_type->HasFlag<vm::AccessFlags::Abstract>()) {
+                ThrowPending(u"java/lang/InstantiationException");
+                return nullptr;
+            }
+            if(!HandleInitialization(class_type)) {
+                return nullptr;
+            }
+
+            const auto &id = GetMemberId(method_id);
+            auto obj_v = vm::NewClassVariable(class_type);
+            auto obj = obj_v->GetAs<vm::type::ClassInstance>();
+            const auto res = obj->CallInstanceMethod(id.name, id.descriptor, obj_v, param_vars);
+            if(res.IsInvalidOrThrown()) {
+                HandleResult(res);
+                return nullptr;
+            }
+            return MakeLocalRef(obj_v);
+        }
+
+        // Instance fields are accessed through the sub-instance of the class declaring them
+
+        Ptr<vm::ClassInstance> GetFieldInstance(jobject obj, const JNIMemberId &id) {
+            auto obj_v = GetVariable(obj);
+            if(!obj_v->CanGetAs<vm::VariableType::ClassInstance>()) {
+                ThrowPending(u"java/lang/NullPointerException");
+                return nullptr;
+            }
+            auto class_obj = obj_v->GetAs<vm::type::ClassInstance>();
+            auto field_obj = class_obj->GetInstanceByClassType(class_obj, id.class_type->GetClassName());
+            if(!field_obj) {
+                ThrowPending(u"java/lang/NoSuchFieldError", id.name);
+            }
+            return field_obj;
+        }
+
+        // Arrays
+
+        Ptr<vm::Array> GetArray(jarray array) {
+            auto arr_v = GetVariable(array);
+            if(!arr_v->CanGetAs<vm::VariableType::Array>()) {
+                ThrowPending(u"java/lang/NullPointerException");
+                return nullptr;
+            }
+            return arr_v->GetAs<vm::type::Array>();
+        }
+
+        Ptr<vm::Array> GetPrimitiveArray(jarray array) {
+            auto arr = GetArray(array);
+            if(arr && !arr->IsPrimitiveArray()) {
+                ThrowPending(u"java/lang/IllegalArgumentException", u"Not a primitive array");
+                return nullptr;
+            }
+            return arr;
+        }
+
+        inline bool CheckRegion(const jsize start, const jsize len, const u64 length) {
+            if((start < 0) || (len < 0) || ((static_cast<u64>(start) + static_cast<u64>(len)) > length)) {
+                ThrowPending(u"java/lang/ArrayIndexOutOfBoundsException");
+                return false;
+            }
+            return true;
+        }
+
+        // Array elements handed to natives stay pinned until released (natives might even keep them across calls, as JNI allows)
+
+        void *PinArray(jarray array, jboolean *is_copy) {
+            auto arr = GetPrimitiveArray(array);
+            if(!arr) {
+                return nullptr;
+            }
+            auto pinned_data = arr->PinPrimitiveData();
+            auto data = pinned_data.GetData<void>();
+            GetThreadEnv().pinned_arrays.push_back(std::move(pinned_data));
+            if(is_copy != nullptr) {
+                *is_copy = JNI_FALSE;
+            }
+            return data;
+        }
+
+        void UnpinArray(void *data, const jint mode) {
+            // Elements are never copies, so there is nothing to commit
+            if(mode == JNI_COMMIT) {
+                return;
+            }
+            auto &pinned_arrays = GetThreadEnv().pinned_arrays;
+            for(auto it = pinned_arrays.rbegin(); it != pinned_arrays.rend(); it++) {
+                if(it->GetData<void>() == data) {
+                    pinned_arrays.erase(std::next(it).base());
+                    return;
+                }
+            }
+        }
+
+        template<typename T>
+        constexpr vm::VariableType GetArrayElementType() {
+            if constexpr(std::is_same_v<T, jboolean>) {
+                return vm::VariableType::Boolean;
+            }
+            else if constexpr(std::is_same_v<T, jbyte>) {
+                return vm::VariableType::Byte;
+            }
+            else if constexpr(std::is_same_v<T, jchar>) {
+                return vm::VariableType::Character;
+            }
+            else if constexpr(std::is_same_v<T, jshort>) {
+                return vm::VariableType::Short;
+            }
+            else if constexpr(std::is_same_v<T, jint>) {
+                return vm::VariableType::Integer;
+            }
+            else if constexpr(std::is_same_v<T, jlong>) {
+                return vm::VariableType::Long;
+            }
+            else if constexpr(std::is_same_v<T, jfloat>) {
+                return vm::VariableType::Float;
+            }
+            else {
+                return vm::VariableType::Double;
+            }
+        }
+
+        Ptr<vm::Variable> GetStringVariable(jstring str) {
+            auto str_v = GetVariable(str);
+            if(str_v->IsNull()) {
+                ThrowPending(u"java/lang/NullPointerException");
+                return nullptr;
+            }
+            return str_v;
+        }
+
+        // JNI functions
+
+        jint GetVersion(JNIEnv *env) {
+            return JNI_VERSION_1_8;
+        }
+
+        jclass DefineClass(JNIEnv *env, const char *name, jobject loader, const jbyte *buf, jsize len) {
+            ScopedVMEntry vm_entry;
+            ThrowPending(u"java/lang/UnsupportedOperationException", u"DefineClass");
+            return nullptr;
+        }
+
+        jclass FindClass(JNIEnv *env, const char *name) {
+            ScopedVMEntry vm_entry;
+            const auto name_str = str::FromUtf8(name);
+            Ptr<vm::ref::ReflectionType> ref_type;
+            if(!name_str.empty() && (name_str.front() == u'[')) {
+                ref_type = vm::ref::FindReflectionTypeByName(name_str);
+            }
+            else {
+                auto class_type = rt::LocateClassType(name_str);
+                if(class_type) {
+                    if(!HandleInitialization(class_type)) {
+                        return nullptr;
+                    }
+                    ref_type = vm::ref::GetReflectionType(class_type);
+                }
+            }
+            if(!ref_type) {
+                ThrowPending(u"java/lang/NoClassDefFoundError", name_str);
+                return nullptr;
+            }
+            return MakeClassRef(ref_type);
+        }
+
+        // Reflection objects aren't supported
+
+        jmethodID FromReflectedMethod(JNIEnv *env, jobject method) {
+            ScopedVMEntry vm_entry;
+            ThrowPending(u"java/lang/UnsupportedOperationException", u"FromReflectedMethod");
+            return nullptr;
+        }
+
+        jfieldID FromReflectedField(JNIEnv *env, jobject field) {
+            ScopedVMEntry vm_entry;
+            ThrowPending(u"java/lang/UnsupportedOperationException", u"FromReflectedField");
+            return nullptr;
+        }
+
+        jobject ToReflectedMethod(JNIEnv *env, jclass cls, jmethodID method_id, jboolean is_static) {
+            ScopedVMEntry vm_entry;
+            ThrowPending(u"java/lang/UnsupportedOperationException", u"ToReflectedMethod");
+            return nullptr;
+        }
+
+        jclass GetSuperclass(JNIEnv *env, jclass clazz) {
+            ScopedVMEntry vm_entry;
+            auto ref_type = GetReflectionType(clazz);
+            if(!ref_type || ref_type->IsPrimitive()) {
+                return nullptr;
+            }
+            if(ref_type->IsArray()) {
+                return MakeClassRef(vm::ref::GetReflectionType(rt::LocateObjectClassType()));
+            }
+            auto class_type = ref_type->GetClassType();
+            if(!class_type || class_type->IsInterface() || !class_type->HasSuperClass()) {
+                return nullptr;
+            }
+            return MakeClassRef(vm::ref::GetReflectionType(class_type->GetSuperClassType()));
+        }
+
+        jboolean IsAssignableFrom(JNIEnv *env, jclass clazz1, jclass clazz2) {
+            ScopedVMEntry vm_entry;
+            auto ref_type_1 = GetReflectionType(clazz1);
+            auto ref_type_2 = GetReflectionType(clazz2);
+            if(!ref_type_1 || !ref_type_2) {
+                return JNI_FALSE;
+            }
+            return IsAssignable(ref_type_1, ref_type_2) ? JNI_TRUE : JNI_FALSE;
+        }
+
+        jobject ToReflectedField(JNIEnv *env, jclass cls, jfieldID field_id, jboolean is_static) {
+            ScopedVMEntry vm_entry;
+            ThrowPending(u"java/lang/UnsupportedOperationException", u"ToReflectedField");
+            return nullptr;
+        }
+
+        jint Throw(JNIEnv *env, jthrowable obj) {
+            ScopedVMEntry vm_entry;
+            auto throwable_v = GetVariable(obj);
+            if(throwable_v->IsNull()) {
+                return JNI_ERR;
+            }
+            SetPendingThrowable(throwable_v);
+            return JNI_OK;
+        }
+
+        jint ThrowNew(JNIEnv *env, jclass clazz, const char *msg) {
+            ScopedVMEntry vm_entry;
+            auto class_type = GetClassType(clazz);
+            if(!class_type) {
+                return JNI_ERR;
+            }
+            ThrowPending(class_type->GetClassName(), (msg != nullptr) ? str::FromUtf8(msg) : u"");
+            return JNI_OK;
+        }
+
+        jthrowable ExceptionOccurred(JNIEnv *env) {
+            ScopedVMEntry vm_entry;
+            return MakeLocalRef(GetThreadEnv().pending_throwable);
+        }
+
+        void ExceptionDescribe(JNIEnv *env) {
+            ScopedVMEntry vm_entry;
+            auto throwable_v = TakePendingThrowable();
+            if(!throwable_v) {
+                return;
+            }
+            auto throwable_obj = throwable_v->GetAs<vm::type::ClassInstance>();
+            auto throwable_obj_c = throwable_obj->GetInstanceByClassTypeAndMethodVirtualInterface(throwable_obj, u"java/lang/Throwable", u"printStackTrace", u"()V");
+            if(throwable_obj_c) {
+                const auto res = throwable_obj_c->CallInstanceMethod(u"printStackTrace", u"()V", throwable_v);
+                if(res.Is<vm::ExecutionStatus::Thrown>()) {
+                    vm::ResetThrown();
+                }
+            }
+        }
+
+        void ExceptionClear(JNIEnv *env) {
+            ScopedVMEntry vm_entry;
+            TakePendingThrowable();
+        }
+
+        void FatalError(JNIEnv *env, const char *msg) {
+            ScopedVMEntry vm_entry;
+            fprintf(stderr, "JNI fatal error: %s\n", msg);
+            std::abort();
+        }
+
+        jint PushLocalFrame(JNIEnv *env, jint capacity) {
+            ScopedVMEntry vm_entry;
+            PushLocalFrameImpl();
+            return JNI_OK;
+        }
+
+        jobject PopLocalFrame(JNIEnv *env, jobject result) {
+            ScopedVMEntry vm_entry;
+            auto result_v = GetVariable(result);
+            PopLocalFrameImpl();
+            return MakeLocalRef(result_v);
+        }
+
+        jobject NewGlobalRef(JNIEnv *env, jobject obj) {
+            ScopedVMEntry vm_entry;
+            return MakeGlobalRef(GetVariable(obj), false);
+        }
+
+        void DeleteGlobalRef(JNIEnv *env, jobject global_ref) {
+            ScopedVMEntry vm_entry;
+            if((global_ref != nullptr) && (GetReference(global_ref)->kind == ReferenceKind::Global)) {
+                delete GetReference(global_ref);
+            }
+        }
+
+        void DeleteLocalRef(JNIEnv *env, jobject local_ref) {
+            ScopedVMEntry vm_entry;
+            // The slot stays in its frame, it's just emptied
+            if((local_ref != nullptr) && (GetReference(local_ref)->kind == ReferenceKind::Local)) {
+                GetReference(local_ref)->var.reset();
+            }
+        }
+
+        jboolean IsSameObject(JNIEnv *env, jobject ref1, jobject ref2) {
+            ScopedVMEntry vm_entry;
+            return vm::IsSameObject(GetVariable(ref1), GetVariable(ref2)) ? JNI_TRUE : JNI_FALSE;
+        }
+
+        jobject NewLocalRef(JNIEnv *env, jobject ref) {
+            ScopedVMEntry vm_entry;
+            return MakeLocalRef(GetVariable(ref));
+        }
+
+        jint EnsureLocalCapacity(JNIEnv *env, jint capacity) {
+            ScopedVMEntry vm_entry;
+            return JNI_OK;
+        }
+
+        jobject AllocObject(JNIEnv *env, jclass clazz) {
+            ScopedVMEntry vm_entry;
+            auto class_type = GetClassType(clazz);
+            if(!class_type || class_type->IsInterface() || class_type->HasFlag<vm::AccessFlags::Abstract>()) {
+                ThrowPending(u"java/lang/InstantiationException");
+                return nullptr;
+            }
+            if(!HandleInitialization(class_type)) {
+                return nullptr;
+            }
+            return MakeLocalRef(vm::NewClassVariable(class_type));
+        }
+
+        jobject NewObject(JNIEnv *env, jclass clazz, jmethodID method_id, ...) {
+            ScopedVMEntry vm_entry;
+            va_list args;
+            va_start(args, method_id);
+            const auto param_vars = ReadArguments(GetMemberId(method_id), args);
+            va_end(args);
+            return NewObjectImpl(clazz, method_id, param_vars);
+        }
+
+        jobject NewObjectV(JNIEnv *env, jclass clazz, jmethodID method_id, va_list args) {
+            ScopedVMEntry vm_entry;
+            return NewObjectImpl(clazz, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        jobject NewObjectA(JNIEnv *env, jclass clazz, jmethodID method_id, const jvalue *args) {
+            ScopedVMEntry vm_entry;
+            return NewObjectImpl(clazz, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        jclass GetObjectClass(JNIEnv *env, jobject obj) {
+            ScopedVMEntry vm_entry;
+            return MakeClassRef(GetObjectReflectionType(GetVariable(obj)));
+        }
+
+        jboolean IsInstanceOf(JNIEnv *env, jobject obj, jclass clazz) {
+            ScopedVMEntry vm_entry;
+            auto obj_v = GetVariable(obj);
+            if(obj_v->IsNull()) {
+                return JNI_TRUE;
+            }
+            auto obj_ref_type = GetObjectReflectionType(obj_v);
+            auto class_ref_type = GetReflectionType(clazz);
+            if(!obj_ref_type || !class_ref_type) {
+                return JNI_FALSE;
+            }
+            return IsAssignable(obj_ref_type, class_ref_type) ? JNI_TRUE : JNI_FALSE;
+        }
+
+        jmethodID GetMethodID(JNIEnv *env, jclass clazz, const char *name, const char *sig) {
+            ScopedVMEntry vm_entry;
+            return GetMethodIdImpl(clazz, name, sig, false);
+        }
+
+        template<typename R>
+        R CallMethod(JNIEnv *env, jobject obj, jmethodID method_id, ...) {
+            ScopedVMEntry vm_entry;
+            va_list args;
+            va_start(args, method_id);
+            const auto param_vars = ReadArguments(GetMemberId(method_id), args);
+            va_end(args);
+            return CallMethodImpl<R>(obj, method_id, param_vars);
+        }
+
+        template<typename R>
+        R CallMethodV(JNIEnv *env, jobject obj, jmethodID method_id, va_list args) {
+            ScopedVMEntry vm_entry;
+            return CallMethodImpl<R>(obj, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        template<typename R>
+        R CallMethodA(JNIEnv *env, jobject obj, jmethodID method_id, const jvalue *args) {
+            ScopedVMEntry vm_entry;
+            return CallMethodImpl<R>(obj, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        template<typename R>
+        R CallNonvirtualMethod(JNIEnv *env, jobject obj, jclass clazz, jmethodID method_id, ...) {
+            ScopedVMEntry vm_entry;
+            va_list args;
+            va_start(args, method_id);
+            const auto param_vars = ReadArguments(GetMemberId(method_id), args);
+            va_end(args);
+            return CallNonvirtualMethodImpl<R>(obj, clazz, method_id, param_vars);
+        }
+
+        template<typename R>
+        R CallNonvirtualMethodV(JNIEnv *env, jobject obj, jclass clazz, jmethodID method_id, va_list args) {
+            ScopedVMEntry vm_entry;
+            return CallNonvirtualMethodImpl<R>(obj, clazz, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        template<typename R>
+        R CallNonvirtualMethodA(JNIEnv *env, jobject obj, jclass clazz, jmethodID method_id, const jvalue *args) {
+            ScopedVMEntry vm_entry;
+            return CallNonvirtualMethodImpl<R>(obj, clazz, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        jfieldID GetFieldID(JNIEnv *env, jclass clazz, const char *name, const char *sig) {
+            ScopedVMEntry vm_entry;
+            return GetFieldIdImpl(clazz, name, sig, false);
+        }
+
+        template<typename T>
+        T GetField(JNIEnv *env, jobject obj, jfieldID field_id) {
+            ScopedVMEntry vm_entry;
+            const auto &id = GetMemberId(field_id);
+            auto field_obj = GetFieldInstance(obj, id);
+            if(!field_obj) {
+                return T();
+            }
+            return GetValue<T>(field_obj->GetField(id.name, id.descriptor));
+        }
+
+        template<typename T>
+        void SetField(JNIEnv *env, jobject obj, jfieldID field_id, T val) {
+            ScopedVMEntry vm_entry;
+            const auto &id = GetMemberId(field_id);
+            auto field_obj = GetFieldInstance(obj, id);
+            if(field_obj) {
+                field_obj->SetField(id.name, id.descriptor, MakeVariable(val));
+            }
+        }
+
+        jmethodID GetStaticMethodID(JNIEnv *env, jclass clazz, const char *name, const char *sig) {
+            ScopedVMEntry vm_entry;
+            return GetMethodIdImpl(clazz, name, sig, true);
+        }
+
+        template<typename R>
+        R CallStaticMethod(JNIEnv *env, jclass clazz, jmethodID method_id, ...) {
+            ScopedVMEntry vm_entry;
+            va_list args;
+            va_start(args, method_id);
+            const auto param_vars = ReadArguments(GetMemberId(method_id), args);
+            va_end(args);
+            return CallMethodImpl<R>(nullptr, method_id, param_vars);
+        }
+
+        template<typename R>
+        R CallStaticMethodV(JNIEnv *env, jclass clazz, jmethodID method_id, va_list args) {
+            ScopedVMEntry vm_entry;
+            return CallMethodImpl<R>(nullptr, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        template<typename R>
+        R CallStaticMethodA(JNIEnv *env, jclass clazz, jmethodID method_id, const jvalue *args) {
+            ScopedVMEntry vm_entry;
+            return CallMethodImpl<R>(nullptr, method_id, ReadArguments(GetMemberId(method_id), args));
+        }
+
+        jfieldID GetStaticFieldID(JNIEnv *env, jclass clazz, const char *name, const char *sig) {
+            ScopedVMEntry vm_entry;
+            return GetFieldIdImpl(clazz, name, sig, true);
+        }
+
+        // The declaring class was already initialized when the ID was looked up
+
+        template<typename T>
+        T GetStaticField(JNIEnv *env, jclass clazz, jfieldID field_id) {
+            ScopedVMEntry vm_entry;
+            const auto &id = GetMemberId(field_id);
+            return GetValue<T>(id.class_type->GetStaticFieldAt(id.static_slot));
+        }
+
+        template<typename T>
+        void SetStaticField(JNIEnv *env, jclass clazz, jfieldID field_id, T val) {
+            ScopedVMEntry vm_entry;
+            const auto &id = GetMemberId(field_id);
+            id.class_type->SetStaticFieldAt(id.static_slot, MakeVariable(val));
+        }
+
+        // Strings
+
+        jstring NewString(JNIEnv *env, const jchar *unicode_chars, jsize len) {
+            ScopedVMEntry vm_entry;
+            return MakeLocalRef(vm::jutil::NewStringFromChars(reinterpret_cast<const char16_t*>(unicode_chars), len));
+        }
+
+        jsize GetStringLength(JNIEnv *env, jstring str) {
+            ScopedVMEntry vm_entry;
+            auto str_v = GetStringVariable(str);
+            if(!str_v) {
+                return 0;
+            }
+            return static_cast<jsize>(vm::jutil::GetStringView(str_v).length());
+        }
+
+        // Copies are null-terminated, for convenience
+
+        const jchar *GetStringChars(JNIEnv *env, jstring str, jboolean *is_copy) {
+            ScopedVMEntry vm_entry;
+            auto str_v = GetStringVariable(str);
+            if(!str_v) {
+                return nullptr;
+            }
+            const auto str_view = vm::jutil::GetStringView(str_v);
+            auto chars = new jchar[str_view.length() + 1]();
+            std::copy(str_view.begin(), str_view.end(), chars);
+            if(is_copy != nullptr) {
+                *is_copy = JNI_TRUE;
+            }
+            return chars;
+        }
+
+        void ReleaseStringChars(JNIEnv *env, jstring str, const jchar *chars) {
+            ScopedVMEntry vm_entry;
+            delete[] chars;
+        }
+
+        jstring NewStringUTF(JNIEnv *env, const char *bytes) {
+            ScopedVMEntry vm_entry;
+            if(bytes == nullptr) {
+                return nullptr;
+            }
+            return MakeLocalRef(vm::jutil::NewUtf8String(bytes));
+        }
+
+        jsize GetStringUTFLength(JNIEnv *env, jstring str) {
+            ScopedVMEntry vm_entry;
+            auto str_v = GetStringVariable(str);
+            if(!str_v) {
+                return 0;
+            }
+            return static_cast<jsize>(str::ToUtf8(String(vm::jutil::GetStringView(str_v))).length());
+        }
+
+        const char *GetStringUTFChars(JNIEnv *env, jstring str, jboolean *is_copy) {
+            ScopedVMEntry vm_entry;
+            auto str_v = GetStringVariable(str);
+            if(!str_v) {
+                return nullptr;
+            }
+            const auto utf8_str = str::ToUtf8(String(vm::jutil::GetStringView(str_v)));
+            auto chars = new char[utf8_str.length() + 1]();
+            std::copy(utf8_str.begin(), utf8_str.end(), chars);
+            if(is_copy != nullptr) {
+                *is_copy = JNI_TRUE;
+            }
+            return chars;
+        }
+
+        void ReleaseStringUTFChars(JNIEnv *env, jstring str, const char *chars) {
+            ScopedVMEntry vm_entry;
+            delete[] chars;
+        }
+
+        // Arrays
+
+        jsize GetArrayLength(JNIEnv *env, jarray array) {
+            ScopedVMEntry vm_entry;
+            auto arr = GetArray(array);
+            if(!arr) {
+                return 0;
+            }
+            return static_cast<jsize>(arr->GetLength());
+        }
+
+        jobjectArray NewObjectArray(JNIEnv *env, jsize len, jclass element_class, jobject initial_element) {
+            ScopedVMEntry vm_entry;
+            if(len < 0) {
+                ThrowPending(u"java/lang/NegativeArraySizeException");
+                return nullptr;
+            }
+            auto elem_ref_type = GetReflectionType(element_class);
+            if(!elem_ref_type || elem_ref_type->IsPrimitive()) {
+                ThrowPending(u"java/lang/IllegalArgumentException");
+                return nullptr;
+            }
+
+            // Arrays of arrays are just arrays with one more dimension
+            const auto dimensions = elem_ref_type->GetArrayDimensions() + 1;
+            Ptr<vm::Variable> arr_v;
+            if(elem_ref_type->IsClassInstance()) {
+                arr_v = vm::NewArrayVariable(len, elem_ref_type->GetClassType(), dimensions);
+            }
+            else {
+                arr_v = vm::NewArrayVariable(len, elem_ref_type->GetPrimitiveType(), dimensions);
+            }
+
+            auto init_v = GetVariable(initial_element);
+            if(!init_v->IsNull()) {
+                auto arr = arr_v->GetAs<vm::type::Array>();
+                for(jsize i = 0; i < len; i++) {
+                    arr->SetAt(i, init_v);
+                }
+            }
+            return MakeLocalRef(arr_v);
+        }
+
+        jobject GetObjectArrayElement(JNIEnv *env, jobjectArray array, jsize index) {
+            ScopedVMEntry vm_entry;
+            auto arr = GetArray(array);
+            if(!arr || !CheckRegion(index, 1, arr->GetLength())) {
+                return nullptr;
+            }
+            return MakeLocalRef(arr->GetAt(index));
+        }
+
+        void SetObjectArrayElement(JNIEnv *env, jobjectArray array, jsize index, jobject val) {
+            ScopedVMEntry vm_entry;
+            auto arr = GetArray(array);
+            if(!arr || !CheckRegion(index, 1, arr->GetLength())) {
+                return;
+            }
+            if(!arr->SetAt(index, GetVariable(val))) {
+                ThrowPending(u"java/lang/ArrayStoreException");
+            }
+        }
+
+        template<typename T>
+        jarray NewArray(JNIEnv *env, jsize len) {
+            ScopedVMEntry vm_entry;
+            if(len < 0) {
+                ThrowPending(u"java/lang/NegativeArraySizeException");
+                return nullptr;
+            }
+            return MakeLocalRef(vm::NewArrayVariable(len, GetArrayElementType<T>()));
+        }
+
+        // Primitive arrays keep their elements in flat storage which never moves, so natives get it directly instead of copies
+
+        template<typename T>
+        T *GetArrayElements(JNIEnv *env, jarray array, jboolean *is_copy) {
+            ScopedVMEntry vm_entry;
+            return reinterpret_cast<T*>(PinArray(array, is_copy));
+        }
+
+        template<typename T>
+        void ReleaseArrayElements(JNIEnv *env, jarray array, T *elems, jint mode) {
+            ScopedVMEntry vm_entry;
+            UnpinArray(elems, mode);
+        }
+
+        template<typename T>
+        void GetArrayRegion(JNIEnv *env, jarray array, jsize start, jsize len, T *buf) {
+            ScopedVMEntry vm_entry;
+            auto arr = GetPrimitiveArray(array);
+            if(!arr || !CheckRegion(start, len, arr->GetLength())) {
+                return;
+            }
+            memcpy(buf, arr->GetPrimitiveData<T>() + start, static_cast<size_t>(len) * sizeof(T));
+        }
+
+        template<typename T>
+        void SetArrayRegion(JNIEnv *env, jarray array, jsize start, jsize len, const T *buf) {
+            ScopedVMEntry vm_entry;
+            auto arr = GetPrimitiveArray(array);
+            if(!arr || !CheckRegion(start, len, arr->GetLength())) {
+                return;
+            }
+            memcpy(arr->GetPrimitiveData<T>() + start, buf, static_cast<size_t>(len) * sizeof(T));
+        }
+
+        jint RegisterNatives(JNIEnv *env, jclass clazz, const JNINativeMethod *methods, jint count) {
+            ScopedVMEntry vm_entry;
+            auto class_type = GetClassType(clazz);
+            if(!class_type) {
+                ThrowPending(u"java/lang/NoClassDefFoundError");
+                return JNI_ERR;
+            }
+
+            std::vector<std::pair<NativeLocation, void*>> natives;
+            for(jint i = 0; i < count; i++) {
+                NativeLocation location = { vm::MakeSlashClassName(class_type->GetClassName()), str::FromUtf8(methods[i].name), str::FromUtf8(methods[i].signature) };
+                auto is_native = false;
+                for(const auto &fn: class_type->GetRawInvokables()) {
+                    if((fn.GetName() == location.name) && (fn.GetDescriptor() == location.descriptor)) {
+                        is_native = fn.HasFlag<vm::AccessFlags::Native>();
+                        break;
+                    }
+                }
+                if(!is_native) {
+                    ThrowPending(u"java/lang/NoSuchMethodError", location.name);
+                    return JNI_ERR;
+                }
+                natives.push_back({ std::move(location), methods[i].fnPtr });
+            }
+
+            auto &instance = rt::GetCurrentInstance();
+            vm::ScopedMonitorLock lk(instance.native_lock);
+            for(auto &[location, fn_ptr]: natives) {
+                instance.jni_natives[std::move(location)] = fn_ptr;
+            }
+            instance.native_version.fetch_add(1, std::memory_order_acq_rel);
+            return JNI_OK;
+        }
+
+        jint UnregisterNatives(JNIEnv *env, jclass clazz) {
+            ScopedVMEntry vm_entry;
+            auto class_type = GetClassType(clazz);
+            if(!class_type) {
+                return JNI_ERR;
+            }
+
+            auto &instance = rt::GetCurrentInstance();
+            vm::ScopedMonitorLock lk(instance.native_lock);
+            const auto class_name = vm::MakeSlashClassName(class_type->GetClassName());
+            for(auto it = instance.jni_natives.begin(); it != instance.jni_natives.end();) {
+                if(it->first.class_name == class_name) {
+                    it = instance.jni_natives.erase(it);
+                }
+                else {
+                    it++;
+                }
+            }
+            instance.native_version.fetch_add(1, std::memory_order_acq_rel);
+            return JNI_OK;
+        }
+
+        jint MonitorEnter(JNIEnv *env, jobject obj) {
+            ScopedVMEntry vm_entry;
+            auto lock = vm::GetObjectLock(GetVariable(obj));
+            if(lock == nullptr) {
+                ThrowPending(u"java/lang/NullPointerException");
+                return JNI_ERR;
+            }
+            vm::EnterObjectLock(*lock);
+            return JNI_OK;
+        }
+
+        jint MonitorExit(JNIEnv *env, jobject obj) {
+            ScopedVMEntry vm_entry;
+            auto lock = vm::GetObjectLock(GetVariable(obj));
+            if(lock == nullptr) {
+                ThrowPending(u"java/lang/NullPointerException");
+                return JNI_ERR;
+            }
+            if(!lock->Leave()) {
+                ThrowPending(u"java/lang/IllegalMonitorStateException");
+                return JNI_ERR;
+            }
+            return JNI_OK;
+        }
+
+        jint GetJavaVMImpl(JNIEnv *env, JavaVM **vm);
+
+        void GetStringRegion(JNIEnv *env, jstring str, jsize start, jsize len, jchar *buf) {
+            ScopedVMEntry vm_entry;
+            auto str_v = GetStringVariable(str);
+            if(!str_v) {
+                return;
+            }
+            const auto str_view = vm::jutil::GetStringView(str_v);
+            if((start < 0) || (len < 0) || ((static_cast<u64>(start) + static_cast<u64>(len)) > str_view.length())) {
+                ThrowPending(u"java/lang/StringIndexOutOfBoundsException");
+                return;
+            }
+            std::copy(str_view.begin() + start, str_view.begin() + start + len, buf);
+        }
+
+        void GetStringUTFRegion(JNIEnv *env, jstring str, jsize start, jsize len, char *buf) {
+            ScopedVMEntry vm_entry;
+            auto str_v = GetStringVariable(str);
+            if(!str_v) {
+                return;
+            }
+            const auto str_view = vm::jutil::GetStringView(str_v);
+            if((start < 0) || (len < 0) || ((static_cast<u64>(start) + static_cast<u64>(len)) > str_view.length())) {
+                ThrowPending(u"java/lang/StringIndexOutOfBoundsException");
+                return;
+            }
+            const auto utf8_str = str::ToUtf8(String(str_view.substr(start, len)));
+            memcpy(buf, utf8_str.c_str(), utf8_str.length() + 1);
+        }
+
+        void *GetPrimitiveArrayCritical(JNIEnv *env, jarray array, jboolean *is_copy) {
+            ScopedVMEntry vm_entry;
+            return PinArray(array, is_copy);
+        }
+
+        void ReleasePrimitiveArrayCritical(JNIEnv *env, jarray array, void *carray, jint mode) {
+            ScopedVMEntry vm_entry;
+            UnpinArray(carray, mode);
+        }
+
+        // The string's own chars (not null-terminated), valid while the string is referenced
+
+        const jchar *GetStringCritical(JNIEnv *env, jstring str, jboolean *is_copy) {
+            ScopedVMEntry vm_entry;
+            auto str_v = GetStringVariable(str);
+            if(!str_v) {
+                return nullptr;
+            }
+            if(is_copy != nullptr) {
+                *is_copy = JNI_FALSE;
+            }
+            return reinterpret_cast<const jchar*>(vm::jutil::GetStringView(str_v).data());
+        }
+
+        void ReleaseStringCritical(JNIEnv *env, jstring str, const jchar *carray) {}
+
+        jweak NewWeakGlobalRef(JNIEnv *env, jobject obj) {
+            ScopedVMEntry vm_entry;
+            return MakeGlobalRef(GetVariable(obj), true);
+        }
+
+        void DeleteWeakGlobalRef(JNIEnv *env, jweak ref) {
+            ScopedVMEntry vm_entry;
+            if((ref != nullptr) && (GetReference(ref)->kind == ReferenceKind::WeakGlobal)) {
+                delete GetReference(ref);
+            }
+        }
+
+        jboolean ExceptionCheck(JNIEnv *env) {
+            ScopedVMEntry vm_entry;
+            return GetThreadEnv().pending_throwable ? JNI_TRUE : JNI_FALSE;
+        }
+
+        // Direct buffers aren't supported, which JNI allows by returning these
+
+        jobject NewDirectByteBuffer(JNIEnv *env, void *address, jlong capacity) {
+            ScopedVMEntry vm_entry;
+            return nullptr;
+        }
+
+        void *GetDirectBufferAddress(JNIEnv *env, jobject buf) {
+            ScopedVMEntry vm_entry;
+            return nullptr;
+        }
+
+        jlong GetDirectBufferCapacity(JNIEnv *env, jobject buf) {
+            ScopedVMEntry vm_entry;
+            return -1;
+        }
+
+        jobjectRefType GetObjectRefType(JNIEnv *env, jobject obj) {
+            ScopedVMEntry vm_entry;
+            if(obj == nullptr) {
+                return JNIInvalidRefType;
+            }
+            switch(GetReference(obj)->kind) {
+                case ReferenceKind::Local:
+                    return JNILocalRefType;
+                case ReferenceKind::Global:
+                    return JNIGlobalRefType;
+                case ReferenceKind::WeakGlobal:
+                    return JNIWeakGlobalRefType;
+            }
+            return JNIInvalidRefType;
+        }
+
+        // Invocation interface: threads are only known to the VM if it started them, so attaching just hands out the thread's env
+
+        inline bool IsSupportedVersion(const jint version) {
+            return (version == JNI_VERSION_1_1) || (version == JNI_VERSION_1_2) || (version == JNI_VERSION_1_4) || (version == JNI_VERSION_1_6) || (version == JNI_VERSION_1_8);
+        }
+
+        jint DestroyJavaVM(JavaVM *vm) {
+            return JNI_ERR;
+        }
+
+        jint AttachCurrentThread(JavaVM *vm, void **penv, void *args) {
+            *penv = &GetThreadEnv().env;
+            return JNI_OK;
+        }
+
+        jint DetachCurrentThread(JavaVM *vm) {
+            return JNI_OK;
+        }
+
+        jint GetEnv(JavaVM *vm, void **penv, jint version) {
+            if(!IsSupportedVersion(version)) {
+                *penv = nullptr;
+                return JNI_EVERSION;
+            }
+            *penv = &GetThreadEnv().env;
+            return JNI_OK;
+        }
+
+        const JNIInvokeInterface g_InvokeInterface = {
+            nullptr,
+            nullptr,
+            nullptr,
+            &DestroyJavaVM,
+            &AttachCurrentThread,
+            &DetachCurrentThread,
+            &GetEnv,
+            &AttachCurrentThread
+        };
+
+        JavaVM g_JavaVM = { &g_InvokeInterface };
+
+        jint GetJavaVMImpl(JNIEnv *env, JavaVM **vm) {
+            *vm = &g_JavaVM;
+            return JNI_OK;
+        }
+
+        // Entries must be at the same positions as in jni.h
+        static_assert(offsetof(JNINativeInterface, GetVersion) == 4 * sizeof(void*));
+        static_assert(offsetof(JNINativeInterface, CallObjectMethod) == 34 * sizeof(void*));
+        static_assert(offsetof(JNINativeInterface, GetStaticMethodID) == 113 * sizeof(void*));
+        static_assert(offsetof(JNINativeInterface, NewString) == 163 * sizeof(void*));
+        static_assert(offsetof(JNINativeInterface, RegisterNatives) == 215 * sizeof(void*));
+        static_assert(offsetof(JNINativeInterface, GetObjectRefType) == 232 * sizeof(void*));
+
+        JNINativeInterface MakeFunctionTable() {
+            JNINativeInterface table = {};
+
+            table.GetVersion = &GetVersion;
+            table.DefineClass = &DefineClass;
+            table.FindClass = &FindClass;
+            table.FromReflectedMethod = &FromReflectedMethod;
+            table.FromReflectedField = &FromReflectedField;
+            table.ToReflectedMethod = &ToReflectedMethod;
+            table.GetSuperclass = &GetSuperclass;
+            table.IsAssignableFrom = &IsAssignableFrom;
+            table.ToReflectedField = &ToReflectedField;
+            table.Throw = &Throw;
+            table.ThrowNew = &ThrowNew;
+            table.ExceptionOccurred = &ExceptionOccurred;
+            table.ExceptionDescribe = &ExceptionDescribe;
+            table.ExceptionClear = &ExceptionClear;
+            table.FatalError = &FatalError;
+            table.PushLocalFrame = &PushLocalFrame;
+            table.PopLocalFrame = &PopLocalFrame;
+            table.NewGlobalRef = &NewGlobalRef;
+            table.DeleteGlobalRef = &DeleteGlobalRef;
+            table.DeleteLocalRef = &DeleteLocalRef;
+            table.IsSameObject = &IsSameObject;
+            table.NewLocalRef = &NewLocalRef;
+            table.EnsureLocalCapacity = &EnsureLocalCapacity;
+            table.AllocObject = &AllocObject;
+            table.NewObject = &NewObject;
+            table.NewObjectV = &NewObjectV;
+            table.NewObjectA = &NewObjectA;
+            table.GetObjectClass = &GetObjectClass;
+            table.IsInstanceOf = &IsInstanceOf;
+            table.GetMethodID = &GetMethodID;
+            table.GetFieldID = &GetFieldID;
+            table.GetStaticMethodID = &GetStaticMethodID;
+            table.GetStaticFieldID = &GetStaticFieldID;
+
+            #define _JAVM_JNI_SET_CALL_ENTRIES(type, name) \
+            table.Call##name##Method = &CallMethod<type>; \
+            table.Call##name##MethodV = &CallMethodV<type>; \
+            table.Call##name##MethodA = &CallMethodA<type>; \
+            table.CallNonvirtual##name##Method = &CallNonvirtualMethod<type>; \
+            table.CallNonvirtual##name##MethodV = &CallNonvirtualMethodV<type>; \
+            table.CallNonvirtual##name##MethodA = &CallNonvirtualMethodA<type>; \
+            table.CallStatic##name##Method = &CallStaticMethod<type>; \
+            table.CallStatic##name##MethodV = &CallStaticMethodV<type>; \
+            table.CallStatic##name##MethodA = &CallStaticMethodA<type>;
+
+            #define _JAVM_JNI_SET_FIELD_ENTRIES(type, name) \
+            table.Get##name##Field = &GetField<type>; \
+            table.Set##name##Field = &SetField<type>; \
+            table.GetStatic##name##Field = &GetStaticField<type>; \
+            table.SetStatic##name##Field = &SetStaticField<type>;
+
+            #define _JAVM_JNI_SET_ARRAY_ENTRIES(type, name) \
+            table.New##name##Array = &NewArray<type>; \
+            table.Get##name##ArrayElements = &GetArrayElements<type>; \
+            table.Release##name##ArrayElements = &ReleaseArrayElements<type>; \
+            table.Get##name##ArrayRegion = &GetArrayRegion<type>; \
+            table.Set##name##ArrayRegion = &SetArrayRegion<type>;
+
+            _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_SET_CALL_ENTRIES)
+            _JAVM_JNI_SET_CALL_ENTRIES(void, Void)
+            _JAVM_JNI_FOR_EACH_TYPE(_JAVM_JNI_SET_FIELD_ENTRIES)
+            _JAVM_JNI_FOR_EACH_PRIMITIVE_TYPE(_JAVM_JNI_SET_ARRAY_ENTRIES)
+
+            #undef _JAVM_JNI_SET_CALL_ENTRIES
+            #undef _JAVM_JNI_SET_FIELD_ENTRIES
+            #undef _JAVM_JNI_SET_ARRAY_ENTRIES
+
+            table.NewString = &NewString;
+            table.GetStringLength = &GetStringLength;
+            table.GetStringChars = &GetStringChars;
+            table.ReleaseStringChars = &ReleaseStringChars;
+            table.NewStringUTF = &NewStringUTF;
+            table.GetStringUTFLength = &GetStringUTFLength;
+            table.GetStringUTFChars = &GetStringUTFChars;
+            table.ReleaseStringUTFChars = &ReleaseStringUTFChars;
+            table.GetArrayLength = &GetArrayLength;
+            table.NewObjectArray = &NewObjectArray;
+            table.GetObjectArrayElement = &GetObjectArrayElement;
+            table.SetObjectArrayElement = &SetObjectArrayElement;
+            table.RegisterNatives = &RegisterNatives;
+            table.UnregisterNatives = &UnregisterNatives;
+            table.MonitorEnter = &MonitorEnter;
+            table.MonitorExit = &MonitorExit;
+            table.GetJavaVM = &GetJavaVMImpl;
+            table.GetStringRegion = &GetStringRegion;
+            table.GetStringUTFRegion = &GetStringUTFRegion;
+            table.GetPrimitiveArrayCritical = &GetPrimitiveArrayCritical;
+            table.ReleasePrimitiveArrayCritical = &ReleasePrimitiveArrayCritical;
+            table.GetStringCritical = &GetStringCritical;
+            table.ReleaseStringCritical = &ReleaseStringCritical;
+            table.NewWeakGlobalRef = &NewWeakGlobalRef;
+            table.DeleteWeakGlobalRef = &DeleteWeakGlobalRef;
+            table.ExceptionCheck = &ExceptionCheck;
+            table.NewDirectByteBuffer = &NewDirectByteBuffer;
+            table.GetDirectBufferAddress = &GetDirectBufferAddress;
+            table.GetDirectBufferCapacity = &GetDirectBufferCapacity;
+            table.GetObjectRefType = &GetObjectRefType;
+
+            return table;
+        }
+
+        const JNINativeInterface &GetFunctionTable() {
+            static const auto table = MakeFunctionTable();
+            return table;
+        }
+
+        // Calls into native code are made without libffi or assembly: arguments are laid out like the platform's calling convention does, and the function is called through a prototype with a fixed amount of integer registers, floating point registers and stack slots
+        // With the x86-64 (System V) and AArch64 (except Apple's) conventions, a function reads exactly the registers/slots its own parameters get assigned to:
+        // integer-like arguments (references included) take the next integer register, float/double ones the next floating point register, and the rest take 8-byte stack slots in argument order
+
+        #if defined(__x86_64__) && !defined(_WIN32)
+        constexpr bool NativeCallsSupported = true;
+        constexpr u32 IntegerRegisterCount = 6;
+        #elif defined(__aarch64__) && !defined(__APPLE__)
+        constexpr bool NativeCallsSupported = true;
+        constexpr u32 IntegerRegisterCount = 8;
+        #else
+        constexpr bool NativeCallsSupported = false;
+        constexpr u32 IntegerRegisterCount = 6;
+        #endif
+
+        constexpr u32 FloatRegisterCount = 8;
+        constexpr u32 StackSlotCount = 16;
+
+        template<size_t>
+        struct IntegerSlot {
+            using Type = u64;
+        };
+
+        template<size_t>
+        struct FloatSlot {
+            using Type = double;
+        };
+
+        class NativeCall {
+            private:
+                std::array<u64, IntegerRegisterCount> int_regs;
+                std::array<double, FloatRegisterCount> float_regs;
+                std::array<u64, StackSlotCount> stack_slots;
+                u32 int_reg_count;
+                u32 float_reg_count;
+                u32 stack_slot_count;
+
+                inline bool PushStackSlot(const u64 val) {
+                    if(this->stack_slot_count < StackSlotCount) {
+                        this->stack_slots[this->stack_slot_count++] = val;
+                        return true;
+                    }
+                    return false;
+                }
+
+                template<typename R, size_t ...Is, size_t ...Fs, size_t ...Ss>
+                inline R CallImpl(void *fn_ptr, std::index_sequence<Is...>, std::index_sequence<Fs...>, std::index_sequence<Ss...>) {
+                    using Fn = R(*)(typename IntegerSlot<Is>::Type..., typename FloatSlot<Fs>::Type..., typename IntegerSlot<Ss>::Type...);
+                    return reinterpret_cast<Fn>(fn_ptr)(this->int_regs[Is]..., this->float_regs[Fs]..., this->stack_slots[Ss]...);
+                }
+
+            public:
+                NativeCall() : int_regs(), float_regs(), stack_slots(), int_reg_count(0), float_reg_count(0), stack_slot_count(0) {}
+
+                // Smaller integers must already be sign/zero-extended
+                inline bool PushInteger(const u64 val) {
+                    if(this->int_reg_count < IntegerRegisterCount) {
+                        this->int_regs[this->int_reg_count++] = val;
+                        return true;
+                    }
+                    return this->PushStackSlot(val);
+                }
+
+                inline bool PushDouble(const double val) {
+                    if(this->float_reg_count < FloatRegisterCount) {
+                        this->float_regs[this->float_reg_count++] = val;
+                        return true;
+                    }
+                    u64 val_bits;
+                    memcpy(&val_bits, &val, sizeof(val_bits));
+                    return this->PushStackSlot(val_bits);
+                }
+
+                // Floats go in the low 32 bits of their register/slot
+                inline bool PushFloat(const float val) {
+                    u32 float_bits;
+                    memcpy(&float_bits, &val, sizeof(float_bits));
+                    const u64 val_bits = float_bits;
+                    if(this->float_reg_count < FloatRegisterCount) {
+                        memcpy(&this->float_regs[this->float_reg_count++], &val_bits, sizeof(val_bits));
+                        return true;
+                    }
+                    return this->PushStackSlot(val_bits);
+                }
+
+                // Integer-like results are returned as u64 (only the low bits of smaller types are meaningful), floating point ones as double (a float being in the low 32 bits)
+                template<typename R>
+                inline R Call(void *fn_ptr) {
+                    return this->CallImpl<R>(fn_ptr, std::make_index_sequence<IntegerRegisterCount>{}, std::make_index_sequence<FloatRegisterCount>{}, std::make_index_sequence<StackSlotCount>{});
+                }
+        };
+
+        // The this object (or the class, for static methods) goes right after the env
+        vm::ExecutionResult CallNativeMethod(void *fn_ptr, const String &descriptor, Ptr<vm::Variable> this_or_class_var, const vm::VariableSpan &param_vars) {
+            if constexpr(!NativeCallsSupported) {
+                return vm::Throw(u"java/lang/UnsatisfiedLinkError", u"JNI calls are not supported on this platform");
+            }
+
+            auto &thr_env = GetThreadEnv();
+            ScopedLocalFrame frame;
+            NativeCall call;
+            call.PushInteger(reinterpret_cast<u64>(&thr_env.env));
+            call.PushInteger(reinterpret_cast<u64>(MakeLocalRef(this_or_class_var)));
+
+            auto args_fit = true;
+            u32 i = 0;
+            const auto ret_kind = VisitDescriptorTypes(descriptor, [&](const char16_t kind) {
+                if(i >= param_vars.size()) {
+                    args_fit = false;
+                    return;
+                }
+                const auto &param_var = param_vars[i++];
+                switch(kind) {
+                    case u'Z':
+                    case u'B':
+                    case u'C':
+                    case u'S':
+                    case u'I': {
+                        // Byte/short values are already sign-extended, boolean/char ones are never negative
+                        args_fit &= call.PushInteger(static_cast<u64>(static_cast<i64>(param_var->PeekValue<vm::type::Integer>())));
+                        break;
+                    }
+                    case u'J': {
+                        args_fit &= call.PushInteger(static_cast<u64>(param_var->PeekValue<vm::type::Long>()));
+                        break;
+                    }
+                    case u'F': {
+                        args_fit &= call.PushFloat(param_var->PeekValue<vm::type::Float>());
+                        break;
+                    }
+                    case u'D': {
+                        args_fit &= call.PushDouble(param_var->PeekValue<vm::type::Double>());
+                        break;
+                    }
+                    default: {
+                        args_fit &= call.PushInteger(reinterpret_cast<u64>(MakeLocalRef(param_var)));
+                        break;
+                    }
+                }
+            });
+            if(!args_fit) {
+                return vm::Throw(u"java/lang/UnsatisfiedLinkError", u"Unsupported JNI method parameters: " + descriptor);
+            }
+
+            // Results are only converted once back from native code
+            const auto is_fp_ret = (ret_kind == u'F') || (ret_kind == u'D');
+            double fp_ret = 0;
+            u64 int_ret = 0;
+            {
+                ScopedNativeState native_state(vm::GetCurrentThread());
+                if(is_fp_ret) {
+                    fp_ret = call.Call<double>(fn_ptr);
+                }
+                else {
+                    int_ret = call.Call<u64>(fn_ptr);
+                }
+            }
+
+            // Returned references must be resolved before the local frame is gone
+            Ptr<vm::Variable> ret_var;
+            if(is_fp_ret) {
+                const auto ret = fp_ret;
+                if(ret_kind == u'F') {
+                    u64 ret_bits;
+                    memcpy(&ret_bits, &ret, sizeof(ret_bits));
+                    const auto float_bits = static_cast<u32>(ret_bits);
+                    jfloat ret_float;
+                    memcpy(&ret_float, &float_bits, sizeof(ret_float));
+                    ret_var = vm::NewPrimitiveVariable<vm::type::Float>(ret_float);
+                }
+                else {
+                    ret_var = vm::NewPrimitiveVariable<vm::type::Double>(ret);
+                }
+            }
+            else {
+                const auto ret = int_ret;
+                switch(ret_kind) {
+                    case u'Z': {
+                        ret_var = MakeVariable(static_cast<jboolean>(ret));
+                        break;
+                    }
+                    case u'B': {
+                        ret_var = MakeVariable(static_cast<jbyte>(ret));
+                        break;
+                    }
+                    case u'C': {
+                        ret_var = MakeVariable(static_cast<jchar>(ret));
+                        break;
+                    }
+                    case u'S': {
+                        ret_var = MakeVariable(static_cast<jshort>(ret));
+                        break;
+                    }
+                    case u'I': {
+                        ret_var = MakeVariable(static_cast<jint>(ret));
+                        break;
+                    }
+                    case u'J': {
+                        ret_var = MakeVariable(static_cast<jlong>(ret));
+                        break;
+                    }
+                    case u'V': {
+                        break;
+                    }
+                    default: {
+                        ret_var = GetVariable(reinterpret_cast<jobject>(ret));
+                        break;
+                    }
+                }
+            }
+
+            auto throwable_v = TakePendingThrowable();
+            if(throwable_v) {
+                return vm::ThrowExisting(throwable_v);
+            }
+            if(ret_kind == u'V') {
+                return vm::ExecutionResult::Void();
+            }
+            return vm::ExecutionResult::ReturnVariable(ret_var);
+        }
+
+        // JNI name mangling: '/' becomes '_', and '_', ';', '[' and non-alphanumeric chars get escaped
+
+        std::string MangleName(const String &name) {
+            std::string mangled;
+            for(const auto ch: name) {
+                if(ch == u'/') {
+                    mangled += '_';
+                }
+                else if(ch == u'_') {
+                    mangled += "_1";
+                }
+                else if(ch == u';') {
+                    mangled += "_2";
+                }
+                else if(ch == u'[') {
+                    mangled += "_3";
+                }
+                else if(((ch >= u'a') && (ch <= u'z')) || ((ch >= u'A') && (ch <= u'Z')) || ((ch >= u'0') && (ch <= u'9'))) {
+                    mangled += static_cast<char>(ch);
+                }
+                else {
+                    char escaped[8] = {};
+                    snprintf(escaped, sizeof(escaped), "_0%04x", static_cast<u32>(ch));
+                    mangled += escaped;
+                }
+            }
+            return mangled;
+        }
+
+        // Libraries might export the short name (Java_<class>_<method>) or, for overloaded methods, the long one (adding __<mangled parameter descriptor>)
+        void *FindLibraryMethod(std::vector<NativeLibrary> &libraries, const String &class_name, const String &fn_name, const String &fn_descriptor) {
+            const auto short_name = "Java_" + MangleName(class_name) + "_" + MangleName(fn_name);
+            const auto params_start = fn_descriptor.find(u'(') + 1;
+            const auto params_end = fn_descriptor.find(u')');
+            const auto long_name = short_name + "__" + MangleName(fn_descriptor.substr(params_start, params_end - params_start));
+            for(auto &library: libraries) {
+                auto fn_ptr = FindLibrarySymbol(library.handle, short_name);
+                if(fn_ptr == nullptr) {
+                    fn_ptr = FindLibrarySymbol(library.handle, long_name);
+                }
+                if(fn_ptr != nullptr) {
+                    return fn_ptr;
+                }
+            }
+            return nullptr;
+        }
+
+    }
+
+}
+
+namespace javm::native {
+
+    vm::ExecutionResult LoadNativeLibrary(const String &path, bool &out_found) {
+        auto &instance = rt::GetCurrentInstance();
+        {
+            vm::ScopedMonitorLock lk(instance.native_lock);
+            for(const auto &library: instance.native_libraries) {
+                if(library.path == path) {
+                    out_found = true;
+                    return vm::ExecutionResult::Void();
+                }
+            }
+        }
+
+        auto handle = OpenLibrary(path);
+        out_found = handle != nullptr;
+        if(!out_found) {
+            return vm::ExecutionResult::Void();
+        }
+
+        auto on_load_fn = reinterpret_cast<jni::JNIOnLoadFunction>(FindLibrarySymbol(handle, "JNI_OnLoad"));
+        if(on_load_fn != nullptr) {
+            jni::ScopedLocalFrame frame;
+            jni::jint version;
+            {
+                jni::ScopedNativeState native_state(vm::GetCurrentThread());
+                version = on_load_fn(&jni::g_JavaVM, nullptr);
+            }
+            auto throwable_v = jni::TakePendingThrowable();
+            if(throwable_v) {
+                return vm::ThrowExisting(throwable_v);
+            }
+            if(!jni::IsSupportedVersion(version)) {
+                return vm::Throw(u"java/lang/UnsatisfiedLinkError", str::Format("Unsupported JNI version 0x%X required by ", version) + path);
+            }
+        }
+
+        vm::ScopedMonitorLock lk(instance.native_lock);
+        instance.native_libraries.push_back({ path, handle });
+        instance.native_version.fetch_add(1, std::memory_order_acq_rel);
+        return vm::ExecutionResult::Void();
+    }
+
+    void *GetBoundJNIMethod(NativeBinding &binding, const String &class_name, const String &fn_name, const String &fn_descriptor) {
+        auto &instance = rt::GetCurrentInstance();
+        if(binding.jni_version.load(std::memory_order_acquire) == instance.native_version.load(std::memory_order_acquire)) {
+            return binding.jni_method.load(std::memory_order_relaxed);
+        }
+
+        // Same as binding regular natives (see GetBoundNativeMethod)
+        vm::ScopedMonitorLock lk(instance.native_lock);
+        const auto version = instance.native_version.load(std::memory_order_acquire);
+        const auto slash_class_name = vm::MakeSlashClassName(class_name);
+        void *fn_ptr = nullptr;
+        auto it = instance.jni_natives.find({ slash_class_name, fn_name, fn_descriptor });
+        if(it != instance.jni_natives.end()) {
+            fn_ptr = it->second;
+        }
+        else {
+            fn_ptr = jni::FindLibraryMethod(instance.native_libraries, slash_class_name, fn_name, fn_descriptor);
+        }
+        binding.jni_method.store(fn_ptr, std::memory_order_relaxed);
+        binding.jni_version.store(version, std::memory_order_release);
+        return fn_ptr;
+    }
+
+    vm::ExecutionResult CallJNIClassMethod(Ptr<vm::ClassType> class_type, NativeBinding &binding, const String &fn_name, const String &fn_descriptor, const vm::VariableSpan &param_vars) {
+        auto fn_ptr = GetBoundJNIMethod(binding, class_type->GetClassName(), fn_name, fn_descriptor);
+        if(fn_ptr == nullptr) {
+            return vm::Throw(u"java/lang/UnsatisfiedLinkError", vm::MakeDotClassName(class_type->GetClassName()) + u"." + fn_name + fn_descriptor);
+        }
+        auto class_v = vm::NewClassTypeVariable(vm::ref::GetReflectionType(class_type));
+        return jni::CallNativeMethod(fn_ptr, fn_descriptor, class_v, param_vars);
+    }
+
+    vm::ExecutionResult CallJNIInstanceMethod(Ptr<vm::ClassType> class_type, NativeBinding &binding, const String &method_name, const String &method_descriptor, Ptr<vm::Variable> this_var, const vm::VariableSpan &param_vars) {
+        auto fn_ptr = GetBoundJNIMethod(binding, class_type->GetClassName(), method_name, method_descriptor);
+        if(fn_ptr == nullptr) {
+            return vm::Throw(u"java/lang/UnsatisfiedLinkError", vm::MakeDotClassName(class_type->GetClassName()) + u"." + method_name + method_descriptor);
+        }
+        return jni::CallNativeMethod(fn_ptr, method_descriptor, this_var, param_vars);
+    }
+
+}
@@ -4,123 +4,81 @@ namespace javm::native {
 
     namespace {
 
-        struct NativeLocation {
-            String class_name;
-            String name;
-            String descriptor;
-        };
-
         template<typename Fn>
-        using NativeTable = std::vector<std::pair<NativeLocation, Fn>>;
-
-        NativeTable<NativeInstanceMethod> g_NativeMethodList;
-        NativeTable<NativeClassMethod> g_NativeStaticFnList;
-        vm::Monitor g_NativeLock;
-
-        bool SameLocation(const NativeLocation a, const NativeLocation b) {
-            if(vm::EqualClassNames(a.class_name, b.class_name)) {
-                if((a.name == b.name) && (a.descriptor == b.descriptor)) {
-                    return true;
-                }
-            }
-
-            return false;
-        }
-
-        void RegisterNativeInstanceMethod(const NativeLocation method_location, NativeInstanceMethod method) {
-            vm::ScopedMonitorLock lk(g_NativeLock);
-
-            for(auto &[location, cur_method] : g_NativeMethodList) {
-                if(SameLocation(location, method_location)) {
-                    // Change the currently registered native method
-                    cur_method = method;
-                    return;
-                }
-            }
-            g_NativeMethodList.push_back({ method_location, method });
+        void RegisterNativeMethod(NativeTable<Fn> &table, NativeLocation location, Fn fn) {
+            auto &instance = rt::GetCurrentInstance();
+            vm::ScopedMonitorLock lk(instance.native_lock);
+
+            // Registering again just changes the currently registered native method
+            table[std::move(location)] = fn;
+            // Every binding made so far needs to be checked again
+            instance.native_version.fetch_add(1, std::memory_order_acq_rel);
         }
 
-        bool HasNativeInstanceMethod(const NativeLocation method_location) {
-            vm::ScopedMonitorLock lk(g_NativeLock);
-
-            for(const auto &[location, _method] : g_NativeMethodList) {
-                if(SameLocation(location, method_location)) {
-                    return true;
-                }
-            }
-            return false;
-        }
-
-        NativeInstanceMethod FindNativeInstanceMethod(const NativeLocation method_location) {
-            vm::ScopedMonitorLock lk(g_NativeLock);
+        template<typename Fn>
+        Fn FindNativeMethod(NativeTable<Fn> &table, const NativeLocation &location) {
+            auto &instance = rt::GetCurrentInstance();
+            vm::ScopedMonitorLock lk(instance.native_lock);
 
-            for(const auto &[location, method] : g_NativeMethodList) {
-                if(SameLocation(location, method_location)) {
-                    return method;
-                }
+            auto it = table.find(location);
+            if(it != table.end()) {
+                return it->second;
             }
             return nullptr;
         }
 
-        void RegisterNativeClassMethod(const NativeLocation fn_location, NativeClassMethod fn) {
-            vm::ScopedMonitorLock lk(g_NativeLock);
-
-            for(auto &[location, cur_fn] : g_NativeStaticFnList) {
-                if(SameLocation(location, fn_location)) {
-                    // Change the currently registered native fn
-                    cur_fn = fn;
-                    return;
-                }
+        template<typename Fn>
+        Fn GetBoundNativeMethod(NativeBinding &binding, std::atomic<Fn> &bound_fn, NativeTable<Fn> &table, const String &class_name, const String &name, const String &descriptor) {
+            auto &instance = rt::GetCurrentInstance();
+            if(binding.version.load(std::memory_order_acquire) == instance.native_version.load(std::memory_order_acquire)) {
+                return bound_fn.load(std::memory_order_relaxed);
             }
-            g_NativeStaticFnList.push_back({ fn_location, fn });
-        }
-
-        bool HasNativeClassMethod(const NativeLocation fn_location) {
-            vm::ScopedMonitorLock lk(g_NativeLock);
 
-            for(const auto &[location, _fn] : g_NativeStaticFnList) {
-                if(SameLocation(location, fn_location)) {
-                    return true;
-                }
+            // Binding under the registry lock, so that racing binders (and registrations) can't leave a stale method with an up to date version
+            vm::ScopedMonitorLock lk(instance.native_lock);
+            const auto version = instance.native_version.load(std::memory_order_acquire);
+            Fn fn = nullptr;
+            auto it = table.find({ vm::MakeSlashClassName(class_name), name, descriptor });
+            if(it != table.end()) {
+                fn = it->second;
             }
-            return false;
-        }
-
-        NativeClassMethod FindNativeClassMethod(const NativeLocation fn_location) {
-            vm::ScopedMonitorLock lk(g_NativeLock);
-
-            for(const auto &[location, fn] : g_NativeStaticFnList) {
-                if(SameLocation(location, fn_location)) {
-                    return fn;
-                }
-            }
-            return nullptr;
+            bound_fn.store(fn, std::memory_order_relaxed);
+            binding.version.store(version, std::memory_order_release);
+            return fn;
         }
 
     }
 
     void RegisterNativeInstanceMethod(const String &class_name, const String &method_name, const String &method_descriptor, NativeInstanceMethod method) {
-        RegisterNativeInstanceMethod({ vm::MakeSlashClassName(class_name), method_name, method_descriptor }, method);
+        RegisterNativeMethod(rt::GetCurrentInstance().native_instance_methods, { vm::MakeSlashClassName(class_name), method_name, method_descriptor }, method);
     }
 
     bool HasNativeInstanceMethod(const String &class_name, const String &method_name, const String &method_descriptor) {
-        return HasNativeInstanceMethod({ vm::MakeSlashClassName(class_name), method_name, method_descriptor });
+        return FindNativeInstanceMethod(class_name, method_name, method_descriptor) != nullptr;
     }
 
     NativeInstanceMethod FindNativeInstanceMethod(const String &class_name, const String &method_name, const String &method_descriptor) {
-        return FindNativeInstanceMethod({ vm::MakeSlashClassName(class_name), method_name, method_descriptor });
+        return FindNativeMethod(rt::GetCurrentInstance().native_instance_methods, { vm::MakeSlashClassName(class_name), method_name, method_descriptor });
     }
 
     void RegisterNativeClassMethod(const String &class_name, const String &fn_name, const String &fn_descriptor, NativeClassMethod fn) {
-        RegisterNativeClassMethod({ vm::MakeSlashClassName(class_name), fn_name, fn_descriptor }, fn);
+        RegisterNativeMethod(rt::GetCurrentInstance().native_class_methods, { vm::MakeSlashClassName(class_name), fn_name, fn_descriptor }, fn);
     }
 
     bool HasNativeClassMethod(const String &class_name, const String &fn_name, const String &fn_descriptor) {
-        return HasNativeClassMethod({ vm::MakeSlashClassName(class_name), fn_name, fn_descriptor });
+        return FindNativeClassMethod(class_name, fn_name, fn_descriptor) != nullptr;
     }
 
     NativeClassMethod FindNativeClassMethod(const String &class_name, const String &fn_name, const String &fn_descriptor) {
-        return FindNativeClassMethod({ vm::MakeSlashClassName(class_name), fn_name, fn_descriptor });
+        return FindNativeMethod(rt::GetCurrentInstance().native_class_methods, { vm::MakeSlashClassName(class_name), fn_name, fn_descriptor });
+    }
+
+    NativeInstanceMethod GetBoundNativeInstanceMethod(NativeBinding &binding, const String &class_name, const String &method_name, const String &method_descriptor) {
+        return GetBoundNativeMethod(binding, binding.instance_method, rt::GetCurrentInstance().native_instance_methods, class_name, method_name, method_descriptor);
+    }
+
+    NativeClassMethod GetBoundNativeClassMethod(NativeBinding &binding, const String &class_name, const String &fn_name, const String &fn_descriptor) {
+        return GetBoundNativeMethod(binding, binding.class_method, rt::GetCurrentInstance().native_class_methods, class_name, fn_name, fn_descriptor);
     }
     
-}
\ No newline at end of file
+}
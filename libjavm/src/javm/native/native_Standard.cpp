@@ -1,4 +1,5 @@
 #include <javm/javm_VM.hpp>
+#include <javm/native/native_TypedNative.hpp>
 
 // TODO: order classes in better way
 
@@ -23,6 +24,8 @@
 #include <javm/native/impl/java/util/concurrent/atomic/atomic_AtomicLong.hpp>
 #include <javm/native/impl/sun/misc/misc_Signal.hpp>
 #include <javm/native/impl/sun/io/io_Win32ErrorMode.hpp>
+#include <javm/native/impl/java/lang/lang_Runtime.hpp>
+#include <javm/native/impl/java/lang/ref/ref_Reference.hpp>
 
 namespace javm::native {
 
@@ -41,8 +44,14 @@ namespace javm::native {
         RegisterNativeClassMethod(u"java/lang/System", u"setErr0", u"(Ljava/io/PrintStream;)V", &impl::java::lang::System::setErr0);
         RegisterNativeClassMethod(u"java/lang/System", u"mapLibraryName", u"(Ljava/lang/String;)Ljava/lang/String;", &impl::java::lang::System::mapLibraryName);
         RegisterNativeClassMethod(u"java/lang/System", u"loadLibrary", u"(Ljava/lang/String;)V", &impl::java::lang::System::loadLibrary);
-        RegisterNativeClassMethod(u"java/lang/System", u"currentTimeMillis", u"()J", &impl::java::lang::System::currentTimeMillis);
+        RegisterNativeClassMethod(u"java/lang/System", u"load", u"(Ljava/lang/String;)V", &impl::java::lang::System::load);
+        RegisterTypedNativeClassMethod<&impl::java::lang::System::currentTimeMillis>(u"java/lang/System", u"currentTimeMillis");
         RegisterNativeClassMethod(u"java/lang/System", u"identityHashCode", u"(Ljava/lang/Object;)I", &impl::java::lang::System::identityHashCode);
+        RegisterNativeInstanceMethod(u"java/lang/Runtime", u"gc", u"()V", &impl::java::lang::Runtime::gc);
+        RegisterNativeInstanceMethod(u"java/lang/Runtime", u"totalMemory", u"()J", &impl::java::lang::Runtime::totalMemory);
+        RegisterNativeInstanceMethod(u"java/lang/Runtime", u"freeMemory", u"()J", &impl::java::lang::Runtime::freeMemory);
+        RegisterNativeInstanceMethod(u"java/lang/Runtime", u"maxMemory", u"()J", &impl::java::lang::Runtime::maxMemory);
+        RegisterNativeInstanceMethod(u"java/lang/ref/Reference", u"get", u"()Ljava/lang/Object;", &impl::java::lang::ref::Reference::get);
         RegisterNativeClassMethod(u"java/lang/Class", u"registerNatives", u"()V", &impl::java::lang::Class::registerNatives);
         RegisterNativeClassMethod(u"java/lang/Class", u"getPrimitiveClass", u"(Ljava/lang/String;)Ljava/lang/Class;", &impl::java::lang::Class::getPrimitiveClass);
         RegisterNativeClassMethod(u"java/lang/Class", u"desiredAssertionStatus0", u"(Ljava/lang/Class;)Z", &impl::java::lang::Class::desiredAssertionStatus0);
@@ -55,23 +64,72 @@ namespace javm::native {
         RegisterNativeClassMethod(u"java/security/AccessController", u"doPrivileged", u"(Ljava/security/PrivilegedExceptionAction;)Ljava/lang/Object;", &impl::java::security::AccessController::doPrivileged);
         RegisterNativeClassMethod(u"java/security/AccessController", u"doPrivileged", u"(Ljava/security/PrivilegedAction;)Ljava/lang/Object;", &impl::java::security::AccessController::doPrivileged);
         RegisterNativeClassMethod(u"java/security/AccessController", u"getStackAccessControlContext", u"()Ljava/security/AccessControlContext;", &impl::java::security::AccessController::getStackAccessControlContext);
-        RegisterNativeClassMethod(u"java/lang/Float", u"floatToRawIntBits", u"(F)I", &impl::java::lang::Float::floatToRawIntBits);
-        RegisterNativeClassMethod(u"java/lang/Double", u"doubleToRawLongBits", u"(D)J", &impl::java::lang::Double::doubleToRawLongBits);
-        RegisterNativeClassMethod(u"java/lang/Double", u"longBitsToDouble", u"(J)D", &impl::java::lang::Double::longBitsToDouble);
+        RegisterTypedNativeClassMethod<&impl::java::lang::Float::floatToRawIntBits>(u"java/lang/Float", u"floatToRawIntBits");
+        RegisterTypedNativeClassMethod<&impl::java::lang::Double::doubleToRawLongBits>(u"java/lang/Double", u"doubleToRawLongBits");
+        RegisterTypedNativeClassMethod<&impl::java::lang::Double::longBitsToDouble>(u"java/lang/Double", u"longBitsToDouble");
         RegisterNativeClassMethod(u"sun/misc/VM", u"initialize", u"()V", &impl::sun::misc::VM::initialize);
         RegisterNativeClassMethod(u"sun/reflect/Reflection", u"getCallerClass", u"()Ljava/lang/Class;", &impl::sun::reflect::Reflection::getCallerClass);
         RegisterNativeClassMethod(u"sun/reflect/Reflection", u"getClassAccessFlags", u"(Ljava/lang/Class;)I", &impl::sun::reflect::Reflection::getClassAccessFlags);
         RegisterNativeClassMethod(u"sun/misc/Unsafe", u"registerNatives", u"()V", &impl::sun::misc::Unsafe::registerNatives);
         RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"arrayBaseOffset", u"(Ljava/lang/Class;)I", &impl::sun::misc::Unsafe::arrayBaseOffset);
         RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"arrayIndexScale", u"(Ljava/lang/Class;)I", &impl::sun::misc::Unsafe::arrayIndexScale);
-        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"addressSize", u"()I", &impl::sun::misc::Unsafe::addressSize);
+        RegisterTypedNativeInstanceMethod<&impl::sun::misc::Unsafe::addressSize>(u"sun/misc/Unsafe", u"addressSize");
         RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"objectFieldOffset", u"(Ljava/lang/reflect/Field;)J", &impl::sun::misc::Unsafe::objectFieldOffset);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"staticFieldOffset", u"(Ljava/lang/reflect/Field;)J", &impl::sun::misc::Unsafe::staticFieldOffset);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"staticFieldBase", u"(Ljava/lang/reflect/Field;)Ljava/lang/Object;", &impl::sun::misc::Unsafe::staticFieldBase);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getObject", u"(Ljava/lang/Object;J)Ljava/lang/Object;", &impl::sun::misc::Unsafe::getObject);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putObject", u"(Ljava/lang/Object;JLjava/lang/Object;)V", &impl::sun::misc::Unsafe::putObject);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getObjectVolatile", u"(Ljava/lang/Object;J)Ljava/lang/Object;", &impl::sun::misc::Unsafe::getObjectVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putObjectVolatile", u"(Ljava/lang/Object;JLjava/lang/Object;)V", &impl::sun::misc::Unsafe::putObjectVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getInt", u"(Ljava/lang/Object;J)I", &impl::sun::misc::Unsafe::getInt);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putInt", u"(Ljava/lang/Object;JI)V", &impl::sun::misc::Unsafe::putInt);
         RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getIntVolatile", u"(Ljava/lang/Object;J)I", &impl::sun::misc::Unsafe::getIntVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putIntVolatile", u"(Ljava/lang/Object;JI)V", &impl::sun::misc::Unsafe::putIntVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getLong", u"(Ljava/lang/Object;J)J", &impl::sun::misc::Unsafe::getLong);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putLong", u"(Ljava/lang/Object;JJ)V", &impl::sun::misc::Unsafe::putLong);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getLongVolatile", u"(Ljava/lang/Object;J)J", &impl::sun::misc::Unsafe::getLongVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putLongVolatile", u"(Ljava/lang/Object;JJ)V", &impl::sun::misc::Unsafe::putLongVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getBoolean", u"(Ljava/lang/Object;J)Z", &impl::sun::misc::Unsafe::getBoolean);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putBoolean", u"(Ljava/lang/Object;JZ)V", &impl::sun::misc::Unsafe::putBoolean);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getBooleanVolatile", u"(Ljava/lang/Object;J)Z", &impl::sun::misc::Unsafe::getBooleanVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putBooleanVolatile", u"(Ljava/lang/Object;JZ)V", &impl::sun::misc::Unsafe::putBooleanVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getByte", u"(Ljava/lang/Object;J)B", &impl::sun::misc::Unsafe::getByte);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putByte", u"(Ljava/lang/Object;JB)V", &impl::sun::misc::Unsafe::putByte);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getByteVolatile", u"(Ljava/lang/Object;J)B", &impl::sun::misc::Unsafe::getByteVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putByteVolatile", u"(Ljava/lang/Object;JB)V", &impl::sun::misc::Unsafe::putByteVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getShort", u"(Ljava/lang/Object;J)S", &impl::sun::misc::Unsafe::getShort);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putShort", u"(Ljava/lang/Object;JS)V", &impl::sun::misc::Unsafe::putShort);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getShortVolatile", u"(Ljava/lang/Object;J)S", &impl::sun::misc::Unsafe::getShortVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putShortVolatile", u"(Ljava/lang/Object;JS)V", &impl::sun::misc::Unsafe::putShortVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getChar", u"(Ljava/lang/Object;J)C", &impl::sun::misc::Unsafe::getChar);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putChar", u"(Ljava/lang/Object;JC)V", &impl::sun::misc::Unsafe::putChar);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getCharVolatile", u"(Ljava/lang/Object;J)C", &impl::sun::misc::Unsafe::getCharVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putCharVolatile", u"(Ljava/lang/Object;JC)V", &impl::sun::misc::Unsafe::putCharVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getFloat", u"(Ljava/lang/Object;J)F", &impl::sun::misc::Unsafe::getFloat);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putFloat", u"(Ljava/lang/Object;JF)V", &impl::sun::misc::Unsafe::putFloat);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getFloatVolatile", u"(Ljava/lang/Object;J)F", &impl::sun::misc::Unsafe::getFloatVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putFloatVolatile", u"(Ljava/lang/Object;JF)V", &impl::sun::misc::Unsafe::putFloatVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getDouble", u"(Ljava/lang/Object;J)D", &impl::sun::misc::Unsafe::getDouble);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putDouble", u"(Ljava/lang/Object;JD)V", &impl::sun::misc::Unsafe::putDouble);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getDoubleVolatile", u"(Ljava/lang/Object;J)D", &impl::sun::misc::Unsafe::getDoubleVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putDoubleVolatile", u"(Ljava/lang/Object;JD)V", &impl::sun::misc::Unsafe::putDoubleVolatile);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putOrderedObject", u"(Ljava/lang/Object;JLjava/lang/Object;)V", &impl::sun::misc::Unsafe::putOrderedObject);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putOrderedInt", u"(Ljava/lang/Object;JI)V", &impl::sun::misc::Unsafe::putOrderedInt);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putOrderedLong", u"(Ljava/lang/Object;JJ)V", &impl::sun::misc::Unsafe::putOrderedLong);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"compareAndSwapObject", u"(Ljava/lang/Object;JLjava/lang/Object;Ljava/lang/Object;)Z", &impl::sun::misc::Unsafe::compareAndSwapObject);
         RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"compareAndSwapInt", u"(Ljava/lang/Object;JII)Z", &impl::sun::misc::Unsafe::compareAndSwapInt);
-        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"allocateMemory", u"(J)J", &impl::sun::misc::Unsafe::allocateMemory);
-        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"putLong", u"(JJ)V", &impl::sun::misc::Unsafe::putLong);
-        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getByte", u"(J)B", &impl::sun::misc::Unsafe::getByte);
-        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"freeMemory", u"(J)V", &impl::sun::misc::Unsafe::freeMemory);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"compareAndSwapLong", u"(Ljava/lang/Object;JJJ)Z", &impl::sun::misc::Unsafe::compareAndSwapLong);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getAndAddInt", u"(Ljava/lang/Object;JI)I", &impl::sun::misc::Unsafe::getAndAddInt);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getAndAddLong", u"(Ljava/lang/Object;JJ)J", &impl::sun::misc::Unsafe::getAndAddLong);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getAndSetInt", u"(Ljava/lang/Object;JI)I", &impl::sun::misc::Unsafe::getAndSetInt);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getAndSetLong", u"(Ljava/lang/Object;JJ)J", &impl::sun::misc::Unsafe::getAndSetLong);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"getAndSetObject", u"(Ljava/lang/Object;JLjava/lang/Object;)Ljava/lang/Object;", &impl::sun::misc::Unsafe::getAndSetObject);
+        RegisterTypedNativeInstanceMethod<&impl::sun::misc::Unsafe::allocateMemory>(u"sun/misc/Unsafe", u"allocateMemory");
+        RegisterTypedNativeInstanceMethod<&impl::sun::misc::Unsafe::putLongAddress>(u"sun/misc/Unsafe", u"putLong");
+        RegisterTypedNativeInstanceMethod<&impl::sun::misc::Unsafe::getByteAddress>(u"sun/misc/Unsafe", u"getByte");
+        RegisterTypedNativeInstanceMethod<&impl::sun::misc::Unsafe::freeMemory>(u"sun/misc/Unsafe", u"freeMemory");
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"park", u"(ZJ)V", &impl::sun::misc::Unsafe::park);
+        RegisterNativeInstanceMethod(u"sun/misc/Unsafe", u"unpark", u"(Ljava/lang/Object;)V", &impl::sun::misc::Unsafe::unpark);
         RegisterNativeInstanceMethod(u"java/lang/Throwable", u"fillInStackTrace", u"(I)Ljava/lang/Throwable;", &impl::java::lang::Throwable::fillInStackTrace);
         RegisterNativeInstanceMethod(u"java/lang/Throwable", u"getStackTraceDepth", u"()I", &impl::java::lang::Throwable::getStackTraceDepth);
         RegisterNativeInstanceMethod(u"java/lang/Throwable", u"getStackTraceElement", u"(I)Ljava/lang/StackTraceElement;", &impl::java::lang::Throwable::getStackTraceElement);
@@ -83,7 +141,12 @@ namespace javm::native {
         RegisterNativeInstanceMethod(u"java/lang/Thread", u"setPriority0", u"(I)V", &impl::java::lang::Thread::setPriority0);
         RegisterNativeInstanceMethod(u"java/lang/Thread", u"isAlive", u"()Z", &impl::java::lang::Thread::isAlive);
         RegisterNativeInstanceMethod(u"java/lang/Thread", u"start0", u"()V", &impl::java::lang::Thread::start0);
+        RegisterNativeClassMethod(u"java/lang/Thread", u"sleep", u"(J)V", &impl::java::lang::Thread::sleep);
+        RegisterNativeClassMethod(u"java/lang/Thread", u"yield", u"()V", &impl::java::lang::Thread::yield);
+        RegisterNativeInstanceMethod(u"java/lang/Thread", u"interrupt0", u"()V", &impl::java::lang::Thread::interrupt0);
+        RegisterNativeInstanceMethod(u"java/lang/Thread", u"isInterrupted", u"(Z)Z", &impl::java::lang::Thread::isInterrupted);
         RegisterNativeClassMethod(u"java/io/FileInputStream", u"initIDs", u"()V", &impl::java::io::FileInputStream::initIDs);
+        RegisterNativeInstanceMethod(u"java/io/FileInputStream", u"readBytes", u"([BII)I", &impl::java::io::FileInputStream::readBytes);
         RegisterNativeClassMethod(u"java/io/FileOutputStream", u"initIDs", u"()V", &impl::java::io::FileOutputStream::initIDs);
         RegisterNativeInstanceMethod(u"java/io/FileOutputStream", u"writeBytes", u"([BIIZ)V", &impl::java::io::FileOutputStream::writeBytes);
         RegisterNativeClassMethod(u"sun/nio/cs/StreamEncoder", u"forOutputStreamWriter", u"(Ljava/io/OutputStream;Ljava/lang/Object;Ljava/lang/String;)Lsun/nio/cs/StreamEncoder;", &impl::sun::nio::cs::StreamEncoder::forOutputStreamWriter);
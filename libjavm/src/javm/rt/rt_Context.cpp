@@ -4,25 +4,42 @@ namespace javm::rt {
 
     namespace {
 
-        std::vector<Ptr<ClassSource>> g_ClassSourceList;
+        Ptr<vm::ClassType> LocateCachedClassType(Ptr<vm::ClassType> &cached_class_type, const String &class_name) {
+            auto class_type = std::atomic_load(&cached_class_type);
+            if(!class_type) {
+                // Racing threads would just locate the same class type
+                class_type = LocateClassType(class_name);
+                std::atomic_store(&cached_class_type, class_type);
+            }
+            return class_type;
+        }
+
+        void ResetCachedWellKnownClassTypes(VMInstance &instance) {
+            std::atomic_store(&instance.object_class_type, Ptr<vm::ClassType>());
+            std::atomic_store(&instance.string_class_type, Ptr<vm::ClassType>());
+        }
 
     }
 
     void AddClassSource(Ptr<ClassSource> cs) {
-        g_ClassSourceList.push_back(cs);
+        GetCurrentInstance().class_sources.push_back(cs);
     }
 
     void RemoveClassSource(Ptr<ClassSource> cs) {
-        g_ClassSourceList.erase(std::remove(g_ClassSourceList.begin(), g_ClassSourceList.end(), cs), g_ClassSourceList.end()); 
+        auto &class_sources = GetCurrentInstance().class_sources;
+        class_sources.erase(std::remove(class_sources.begin(), class_sources.end(), cs), class_sources.end());
+        ResetCachedWellKnownClassTypes(GetCurrentInstance());
     }
 
     void ResetClassSources() {
-        g_ClassSourceList.clear();
+        auto &instance = GetCurrentInstance();
+        instance.class_sources.clear();
+        ResetCachedWellKnownClassTypes(instance);
     }
 
     Ptr<vm::ClassType> LocateClassType(const String &class_name) {
         const auto slash_class_name = vm::MakeSlashClassName(class_name);
-        for(const auto &source: g_ClassSourceList) {
+        for(const auto &source: GetCurrentInstance().class_sources) {
             auto class_ptr = source->LocateClassType(slash_class_name);
             if(class_ptr) {
                 return class_ptr;
@@ -32,10 +49,30 @@ namespace javm::rt {
         return nullptr;
     }
 
+    Ptr<vm::ClassType> LocateObjectClassType() {
+        return LocateCachedClassType(GetCurrentInstance().object_class_type, u"java/lang/Object");
+    }
+
+    Ptr<vm::ClassType> LocateStringClassType() {
+        return LocateCachedClassType(GetCurrentInstance().string_class_type, u"java/lang/String");
+    }
+
     void ResetCachedClassTypes() {
-        for(auto &source: g_ClassSourceList) {
+        auto &instance = GetCurrentInstance();
+        ResetCachedWellKnownClassTypes(instance);
+        // Primitive types' class variables are instances of the previous java.lang.Class type
+        for(auto &ref_types: instance.primitive_ref_types) {
+            ref_types.Clear();
+        }
+        {
+            vm::ScopedMonitorLock lk(instance.class_var_lock);
+            instance.class_var_ref_types.clear();
+        }
+        for(auto &source: instance.class_sources) {
             source->ResetCachedClassTypes();
         }
+        // Class types get loaded (and accounted) again
+        instance.heap.ResetMetadataSize();
     }
 
 }
\ No newline at end of file
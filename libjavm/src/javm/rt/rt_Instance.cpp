@@ -0,0 +1,108 @@
+#include <javm/javm_VM.hpp>
+
+namespace javm::rt {
+
+    namespace {
+
+        thread_local Ptr<VMInstance> g_CurrentInstance;
+        thread_local VMInstance *g_CurrentInstanceRaw = nullptr;
+
+        Ptr<VMInstance> &GetDefaultInstance() {
+            static Ptr<VMInstance> default_instance = ptr::New<VMInstance>();
+            return default_instance;
+        }
+
+        inline void SetCurrentInstance(Ptr<VMInstance> instance) {
+            // Allocations recorded by this thread belong to the instance being left
+            vm::FlushThreadHeapBuffer();
+            g_CurrentInstance = instance;
+            g_CurrentInstanceRaw = instance.get();
+        }
+
+    }
+
+    Ptr<VMInstance> CreateInstance() {
+        return ptr::New<VMInstance>();
+    }
+
+    void EnterInstance(Ptr<VMInstance> instance) {
+        SetCurrentInstance(instance);
+    }
+
+    void ExitInstance() {
+        SetCurrentInstance(nullptr);
+    }
+
+    void DestroyInstance(Ptr<VMInstance> instance) {
+        {
+            ScopedInstance guard(instance);
+
+            vm::UnregisterAllThreads();
+            vm::ResetThrown();
+            {
+                vm::ScopedMonitorLock lk(instance->native_lock);
+                instance->native_instance_methods.clear();
+                instance->native_class_methods.clear();
+                // Libraries are never unloaded (as in Java), they are just forgotten
+                instance->native_libraries.clear();
+                instance->jni_natives.clear();
+                instance->jni_field_ids.clear();
+                instance->jni_method_ids.clear();
+                instance->native_version.fetch_add(1);
+            }
+            {
+                vm::ScopedMonitorLock lk(instance->class_var_lock);
+                instance->class_var_ref_types.clear();
+            }
+            for(auto &ref_types: instance->primitive_ref_types) {
+                ref_types.Clear();
+            }
+            instance->intern_strings.Clear();
+            std::atomic_store(&instance->object_class_type, Ptr<vm::ClassType>());
+            std::atomic_store(&instance->string_class_type, Ptr<vm::ClassType>());
+            instance->initial_system_props.clear();
+
+            // With statics gone too, only the caller's own references remain, so a last collection frees every cycle
+            for(auto &source: instance->class_sources) {
+                for(auto &class_type: source->GetClassTypes()) {
+                    class_type->ClearStaticFields();
+                    class_type->GetConstantPool().ClearResolvedItems();
+                }
+            }
+            instance->heap.CollectBlocking();
+            instance->heap.Reset();
+
+            for(auto &source: instance->class_sources) {
+                source->ResetCachedClassTypes();
+            }
+            instance->class_sources.clear();
+        }
+
+        if(g_CurrentInstanceRaw == instance.get()) {
+            ExitInstance();
+        }
+    }
+
+    VMInstance &GetCurrentInstance() {
+        if(g_CurrentInstanceRaw != nullptr) {
+            return *g_CurrentInstanceRaw;
+        }
+        return *GetDefaultInstance();
+    }
+
+    Ptr<VMInstance> GetCurrentInstancePtr() {
+        if(g_CurrentInstance) {
+            return g_CurrentInstance;
+        }
+        return GetDefaultInstance();
+    }
+
+    ScopedInstance::ScopedInstance(Ptr<VMInstance> instance) : prev_instance(g_CurrentInstance) {
+        EnterInstance(instance);
+    }
+
+    ScopedInstance::~ScopedInstance() {
+        SetCurrentInstance(this->prev_instance);
+    }
+
+}
@@ -21,8 +21,9 @@ namespace javm::rt {
             thread_obj->SetField(u"priority", u"I", NewPrimitiveVariable<type::Integer>(prio));
 
             thread->SetThreadVariable(thread_v);
+            thread->SetInstance(GetCurrentInstancePtr());
 
-            auto thr_accessor = RegisterThread(thread);
+            auto thr_accessor = RegisterThread(thread, ThreadState::Running);
             thr_accessor->SetThreadName(native::Thread::MainThreadName);
 
             return thread_v;
@@ -2,79 +2,98 @@
 
 namespace javm::vm::jutil {
 
-    namespace {
-
-        std::vector<Ptr<Variable>> g_InternStringList;
+    void StringInternTable::PruneExpiredEntries(Shard &shard) {
+        for(auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if(it->second.expired()) {
+                it = shard.entries.erase(it);
+            }
+            else {
+                it++;
+            }
+        }
+        // Pruning again only once the live entries have doubled keeps it amortized constant per insertion
+        shard.prune_threshold = std::max(MinPruneThreshold, shard.entries.size() * 2);
+    }
 
-        Ptr<Variable> TryFindInternString(const String &native_str) {
-            for(auto &var: g_InternStringList) {
-                const auto value_val = GetStringValue(var);
-                if(native_str == value_val) {
-                    return var;
-                }
+    Ptr<Variable> StringInternTable::Find(const String &native_str) {
+        auto &shard = this->GetShard(native_str);
+        ScopedMonitorLock lk(shard.lock);
+        auto it = shard.entries.find(native_str);
+        if(it != shard.entries.end()) {
+            auto str_obj = it->second.lock();
+            if(str_obj) {
+                return ptr::New<Variable>(str_obj);
             }
+        }
+        return nullptr;
+    }
 
-            return nullptr;
+    Ptr<Variable> StringInternTable::Insert(const String &native_str, Ptr<Variable> str_var) {
+        auto &shard = this->GetShard(native_str);
+        ScopedMonitorLock lk(shard.lock);
+        auto &entry = shard.entries[native_str];
+        auto str_obj = entry.lock();
+        if(str_obj) {
+            return ptr::New<Variable>(str_obj);
         }
-        
-        inline Ptr<Variable> TryFindInternVariable(const Ptr<Variable> &str_var) {
-            return TryFindInternString(GetStringValue(str_var));
+        entry = str_var->GetAs<type::ClassInstance>();
+        if(shard.entries.size() >= shard.prune_threshold) {
+            PruneExpiredEntries(shard);
         }
+        return str_var;
+    }
 
-        Ptr<Variable> NewStringVariable(const String &native_str) {
-            auto str_class_type = rt::LocateClassType(u"java/lang/String");
-            if(str_class_type) {
-                CallerSensitiveGuard guard;
-
-                Ptr<Variable> str_var;
-                if(native_str.empty()) {
-                    // Trick to avoid infinite loop of String creation:
-                    // Java's String <init> constructor assigns it the value of a "" String's value.
-                    // Always calling the constructor would also call it for the "" String, calling the same code indefinitely until a segfault happens.
-                    // Thus, we don't call the constructor here
-                    str_var = NewClassVariable(str_class_type);
-                }
-                else {
-                    str_var = NewClassVariable(str_class_type, u"()V");
-                }
-                SetStringValue(str_var, native_str);
-                return str_var;
-            }
+    void StringInternTable::Clear() {
+        for(auto &shard: this->shards) {
+            ScopedMonitorLock lk(shard.lock);
+            shard.entries.clear();
+            shard.prune_threshold = MinPruneThreshold;
+        }
+    }
+
+    namespace {
+
+        void SetStringChars(Ptr<type::ClassInstance> str_obj, const char16_t *chars, const size_t length) {
+            auto arr_var = NewArrayVariable(length, VariableType::Character);
+            auto arr_obj = arr_var->GetAs<type::Array>();
+            std::memcpy(arr_obj->GetPrimitiveData<u16>(), chars, length * sizeof(char16_t));
 
-            return nullptr;
+            str_obj->SetField(u"value", u"[C", arr_var);
+        }
+
+        inline Ptr<Variable> NewStringVariable(const String &native_str) {
+            return NewStringFromChars(native_str.data(), native_str.length());
         }
 
     }
 
-    Ptr<Variable> NewString(const String &native_str) {
-        auto interned_str_var = TryFindInternString(native_str);
-        if(interned_str_var) {
-            return interned_str_var;
+    Ptr<Variable> NewStringFromChars(const char16_t *chars, const size_t length) {
+        auto str_class_type = rt::LocateStringClassType();
+        if(str_class_type) {
+            // String() would just set the value (to the empty string's one) and the hash (to zero), so there's no need to run it
+            auto str_var = NewClassVariable(str_class_type);
+            SetStringChars(str_var->GetAs<type::ClassInstance>(), chars, length);
+            return str_var;
         }
 
-        auto str_var = NewStringVariable(native_str);
-        InternVariable(str_var);
-        return str_var;
+        return nullptr;
+    }
+
+    Ptr<Variable> NewString(const String &native_str) {
+        return NewStringVariable(native_str);
     }
 
     void SetStringValue(Ptr<Variable> str_var, const String &native_str) {
         if(str_var->CanGetAs<VariableType::ClassInstance>()) {
-            auto str_obj = str_var->GetAs<type::ClassInstance>();
-            const size_t str_len = native_str.length();
-
-            auto arr_var = NewArrayVariable(str_len, VariableType::Character);
-            auto arr_obj = arr_var->GetAs<type::Array>();
-
-            for(u32 i = 0; i < str_len; i++) {
-                auto char_var = NewPrimitiveVariable<type::Character>(native_str[i]);
-                arr_obj->SetAt(i, char_var);
-            }
-
-            str_obj->SetField(u"value", u"[C", arr_var);
+            SetStringChars(str_var->GetAs<type::ClassInstance>(), native_str.data(), native_str.length());
         }
     }
 
     String GetStringValue(Ptr<Variable> str_var) {
+        return String(GetStringView(str_var));
+    }
+
+    std::u16string_view GetStringView(Ptr<Variable> str_var) {
         if(!str_var) {
             // TODO
             return u"<invalid-str-var>";
@@ -83,39 +102,31 @@ namespace javm::vm::jutil {
             // TODO
             return u"<null>";
         }
-        
-        String ret_str;
+
         if(str_var->CanGetAs<VariableType::ClassInstance>()) {
             auto str_obj = str_var->GetAs<type::ClassInstance>();
 
             auto arr_var = str_obj->GetField(u"value", u"[C");
-            auto arr_obj = arr_var->GetAs<type::Array>();
-
-            for(u32 i = 0; i < arr_obj->GetLength(); i++) {
-                auto char_var = arr_obj->GetAt(i);
-                const auto char_val = char_var->GetValue<type::Character>();
-                ret_str += static_cast<char16_t>(char_val);
+            if(arr_var->CanGetAs<VariableType::Array>()) {
+                auto arr_obj = arr_var->GetAs<type::Array>();
+                return std::u16string_view(arr_obj->GetPrimitiveData<char16_t>(), arr_obj->GetLength());
             }
         }
-        return ret_str;
+        return {};
     }
 
-    void InternString(const String &native_str) {
-        // Check if it's already interned
-        auto interned_str_var = TryFindInternString(native_str);
-        if(!interned_str_var) {
-            // String isn't interned, so intern it
-            g_InternStringList.push_back(NewStringVariable(native_str));
+    Ptr<Variable> InternString(const String &native_str) {
+        auto &intern_table = rt::GetCurrentInstance().intern_strings;
+        auto interned_str_var = intern_table.Find(native_str);
+        if(interned_str_var) {
+            return interned_str_var;
         }
+        // Racing threads might both create the string, but only one of them gets interned
+        return intern_table.Insert(native_str, NewStringVariable(native_str));
     }
 
-    void InternVariable(Ptr<Variable> str_var) {
-        // Check if it's already interned
-        auto interned_str_var = TryFindInternVariable(str_var);
-        if(!interned_str_var) {
-            // String isn't interned, so intern it
-            g_InternStringList.push_back(str_var);
-        }
+    Ptr<Variable> InternVariable(Ptr<Variable> str_var) {
+        return rt::GetCurrentInstance().intern_strings.Insert(GetStringValue(str_var), str_var);
     }
 
 }
\ No newline at end of file
@@ -2,26 +2,8 @@
 
 namespace javm::vm::ref {
 
-    // TODO: cache reflection types?
-
     namespace {
 
-        Ptr<ReflectionType> CreateArrayType(const String &name, const u32 dimensions) {
-            // Try to find a primitive type
-            const auto primitive_type = GetPrimitiveVariableTypeByName(name);
-            if(primitive_type != VariableType::Invalid) {
-                return ptr::New<ReflectionType>(primitive_type, dimensions);
-            }
-            // Otherwise, search for a class type
-            else {
-                auto class_type = rt::LocateClassType(name);
-                if(class_type) {
-                    return ptr::New<ReflectionType>(class_type, dimensions);
-                }
-            }
-            return nullptr;
-        }
-
         Ptr<ReflectionType> CreateTypeByName(const String &name) {
             u32 array_dimensions = 0;
             auto name_copy = name;
@@ -40,20 +22,20 @@ namespace javm::vm::ref {
             // Try to find a primitive type
             const auto primitive_type = GetPrimitiveVariableTypeByName(name_copy);
             if(primitive_type != VariableType::Invalid) {
-                return ptr::New<ReflectionType>(primitive_type, array_dimensions);
+                return GetPrimitiveReflectionType(primitive_type, array_dimensions);
             }
             else {
                 // It might be a descriptor rather than a name
                 const auto primitive_type = GetVariableTypeByDescriptor(name_copy);
                 if(primitive_type != VariableType::Invalid) {
-                    return ptr::New<ReflectionType>(primitive_type, array_dimensions);
+                    return GetPrimitiveReflectionType(primitive_type, array_dimensions);
                 }
                 // Otherwise, search for a class type
                 else {
                     JAVM_LOG("Searching for ref class type '%s' -> '%s'", str::ToUtf8(name).c_str(), str::ToUtf8(name_copy).c_str());
                     auto class_type = rt::LocateClassType(name_copy);
                     if(class_type) {
-                        return ptr::New<ReflectionType>(class_type, array_dimensions);
+                        return GetReflectionType(class_type, array_dimensions);
                     }
                 }
             }
@@ -63,7 +45,7 @@ namespace javm::vm::ref {
 
     }
 
-    String ReflectionType::ComputeTypeName() {
+    String ReflectionType::ComputeTypeName(Ptr<ClassType> class_type) {
         String base_name;
         const auto is_array = this->array_dimensions > 0;
         for(u32 i = 0; i < this->array_dimensions; i++) {
@@ -78,8 +60,8 @@ namespace javm::vm::ref {
                 base_name += GetPrimitiveTypeName(this->type);
             }
         }
-        else if(this->IsClassInstance()) {
-            const auto class_name = MakeDotClassName(this->base_type->GetClassName());
+        else if(class_type) {
+            const auto class_name = MakeDotClassName(class_type->GetClassName());
             if(is_array) {
                 base_name += u"L" + class_name + u";";
             }
@@ -94,17 +76,60 @@ namespace javm::vm::ref {
         return base_name;
     }
 
+    Ptr<ReflectionType> GetReflectionType(Ptr<ClassType> class_type, const u32 array_dimensions) {
+        return class_type->GetReflectionTypeTable().GetOrCreate(array_dimensions, [&]() {
+            return ptr::New<ReflectionType>(class_type, array_dimensions);
+        });
+    }
+
+    Ptr<ReflectionType> GetPrimitiveReflectionType(const VariableType primitive_type, const u32 array_dimensions) {
+        auto &primitive_ref_types = rt::GetCurrentInstance().primitive_ref_types;
+        const auto type_idx = static_cast<size_t>(primitive_type);
+        if(!IsPrimitiveVariableType(primitive_type) || (type_idx >= primitive_ref_types.size())) {
+            return nullptr;
+        }
+        return primitive_ref_types[type_idx].GetOrCreate(array_dimensions, [&]() {
+            return ptr::New<ReflectionType>(primitive_type, array_dimensions);
+        });
+    }
+
     Ptr<ReflectionType> FindReflectionTypeByName(const String &name) {
         return CreateTypeByName(name);
     }
 
     Ptr<ReflectionType> FindArrayReflectionType(Ptr<Array> &array) {
         if(array->IsClassInstanceArray()) {
-            return CreateArrayType(array->GetClassType()->GetClassName(), array->GetDimensions());
+            return GetReflectionType(array->GetClassType(), array->GetDimensions());
         }
         else {
-            return ptr::New<ReflectionType>(array->GetVariableType(), array->GetDimensions());
+            return GetPrimitiveReflectionType(array->GetVariableType(), array->GetDimensions());
+        }
+    }
+
+    Ptr<ReflectionType> FindReflectionTypeByClassVariable(Ptr<Variable> class_var) {
+        if(!class_var->CanGetAs<VariableType::ClassInstance>()) {
+            return nullptr;
+        }
+        auto class_obj = class_var->GetAs<type::ClassInstance>();
+
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.class_var_lock);
+        auto it = instance.class_var_ref_types.find(class_obj.get());
+        if(it != instance.class_var_ref_types.end()) {
+            auto ref_type = it->second.lock();
+            // Make sure this isn't a stale entry of some freed class variable which was at the same address
+            auto ref_class_var = ref_type ? ref_type->GetClassVariable() : nullptr;
+            if(ref_class_var && IsSameObject(ref_class_var, class_var)) {
+                return ref_type;
+            }
         }
+        return nullptr;
+    }
+
+    void RegisterClassVariable(Ptr<ReflectionType> ref_type, Ptr<Variable> class_var) {
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.class_var_lock);
+        instance.class_var_ref_types[class_var->GetAs<type::ClassInstance>().get()] = ref_type;
     }
 
 }
\ No newline at end of file
@@ -6,35 +6,28 @@ namespace javm::vm {
         return NewDefaultVariable(this->type);
     }
 
-    Ptr<ClassInstance> Array::CreateInnerObject() {
-        auto obj_class_type = rt::LocateClassType(u"java/lang/Object");
-        return ptr::New<ClassInstance>(obj_class_type);
-    }
-
     bool Array::CanCastTo(const String &class_name) {
         if(this->class_type) {
-            if(EqualClassNames(class_name, this->class_type->GetClassName())) {
-                return true;
-            }
-            auto super_class = this->class_type->GetSuperClassType();
-            while(super_class) {
-                if(EqualClassNames(class_name, super_class->GetClassName())) {
-                    return true;
-                }
-                auto sc = super_class->GetSuperClassType();
-                super_class = sc;
-            }
+            return this->class_type->CanCastTo(class_name);
         }
         return false;
     }
 
     Ptr<Variable> Array::GetAt(const u32 idx) {
         if(idx < this->length) {
-            auto arr_v = this->inner_array[idx];
+            if(this->IsPrimitiveArray()) {
+                Ptr<Variable> elem_v;
+                VisitPrimitiveArrayData(this->type, this->GetElementAddressAt(idx), [&](auto *elem) {
+                    elem_v = NewArrayElementVariable(*elem);
+                });
+                return elem_v;
+            }
+
+            auto arr_v = this->inner_array[idx].var;
             // If value not set, make a default one and return it
             if(!arr_v) {
                 arr_v = this->MakeDefaultVariable();
-                this->inner_array[idx] = arr_v;
+                StoreHeapSlot(this->inner_array[idx], arr_v);
             }
             return arr_v;
         }
@@ -51,23 +44,47 @@ namespace javm::vm {
             return false;
         }
 
+        if(this->IsPrimitiveArray()) {
+            const auto is_bool = this->type == VariableType::Boolean;
+            VisitPrimitiveArrayData(this->type, this->GetElementAddressAt(idx), [&](auto *elem) {
+                using E = std::remove_pointer_t<decltype(elem)>;
+                auto val = GetArrayElementValue<E>(var);
+                if constexpr(std::is_same_v<E, i8>) {
+                    // Like BASTORE does for boolean arrays, only keep the lowest bit
+                    if(is_bool) {
+                        val &= 1;
+                    }
+                }
+                *elem = val;
+            });
+            return true;
+        }
+
         if(this->IsClassInstanceArray()) {
             if(var_type == VariableType::ClassInstance) {
                 auto var_class_type = var->GetAs<type::ClassInstance>()->GetClassType();
-                if(!var_class_type->CanCastTo(this->class_type->GetClassName())) {
+                if(!var_class_type->IsSubtypeOf(*this->class_type)) {
                     return false;
                 }
             }
             else if(var_type == VariableType::Array) {
-                // Arrays can only be casted to Object!
-                if(MakeSlashClassName(this->class_type->GetClassName()) != u"java/lang/Object") {
+                // Elements of multi-dimensional arrays are arrays themselves, otherwise arrays can only be casted to Object!
+                if(!this->IsMultiArray() && (MakeSlashClassName(this->class_type->GetClassName()) != u"java/lang/Object")) {
                     return false;
                 }
             }
         }
 
-        this->inner_array[idx] = var;
+        StoreHeapSlot(this->inner_array[idx], var);
         return true;
     }
 
+    ExecutionResult Array::CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const VariableSpan &param_vars) {
+        auto obj_class_type = rt::LocateObjectClassType();
+        if(!obj_class_type) {
+            return ExecutionResult::InvalidState();
+        }
+        return obj_class_type->CallInstanceMethod(name, descriptor, this_as_var, param_vars);
+    }
+
 }
\ No newline at end of file
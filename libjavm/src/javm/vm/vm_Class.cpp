@@ -2,15 +2,116 @@
 
 namespace javm::vm {
 
-    ClassType::ClassType(const String &name, const String &super_name, const String &source_file, const std::vector<String> &interface_names, const std::vector<ClassBaseField> &fields, const std::vector<ClassBaseField> &invokables, const u16 flags, ConstantPool pool) : MonitoredItem(), class_name(name), super_class_name(super_name), source_file(source_file), interface_class_names(interface_names), fields(fields), invokables(invokables), static_block_called(false), static_block_enabled(true), pool(pool) {
+    Ptr<Variable> ClassField::GetVariable() {
+        if(this->IsVolatile()) {
+            return AtomicLoadSlot(this->var, this->var_type);
+        }
+        if(!this->var.var) {
+            auto default_var = NewDefaultVariable(this->var_type);
+            StoreHeapSlot(this->var, default_var);
+            return default_var;
+        }
+        return this->var.var;
+    }
+
+    void ClassField::SetVariable(Ptr<Variable> new_var) {
+        if(this->IsVolatile()) {
+            AtomicStoreSlot(this->var, new_var);
+        }
+        else {
+            StoreHeapSlot(this->var, new_var);
+        }
+    }
+
+    ClassType::ClassType(const String &name, const String &super_name, const String &source_file, const std::vector<String> &interface_names, const std::vector<ClassBaseField> &fields, const std::vector<ClassBaseField> &invokables, const u16 flags, ConstantPool pool) : class_name(name), super_class_name(super_name), source_file(source_file), interface_class_names(interface_names), fields(fields), invokables(invokables), native_bindings(std::make_unique<native::NativeBinding[]>(invokables.size())), init_state(ClassInitializationState::NotInitialized), init_thread_id(0), static_block_enabled(true), pool(pool), instance_size(0), ref_types(ptr::New<ref::ReflectionTypeTable>()), hierarchy_display(nullptr) {
         this->SetAccessFlags(flags);
         for(const auto &field: this->fields) {
             if(field.HasFlag<AccessFlags::Static>()) {
-                // Push a copy, this kind of field can be got/set
-                // Since static fields are used from the class and not the instance, the type needs to hold 'editable' static fields
-                this->static_fields.emplace_back(field.GetNameAndType(), field.GetAccessFlags(), field.GetAttributes(), this->pool);
+                // Preparation (JVMS 5.4.2): every static field starts with its default value
+                const auto type = GetVariableTypeByDescriptor(field.GetDescriptor());
+                this->static_fields.push_back(field);
+                this->static_types.push_back(type);
+                this->static_slots.push_back({ NewDefaultVariable(type) });
             }
         }
+
+        // Class metadata counts against the heap limit too
+        RegisterHeapMetadata(sizeof(ClassType) + (this->fields.size() + this->invokables.size()) * sizeof(ClassBaseField) + this->static_fields.size() * (sizeof(ClassBaseField) + sizeof(VariableType) + sizeof(VariableSlot)));
+    }
+
+    u64 ClassType::GetInstanceSize() {
+        // Computed once, racing threads would just compute the same value
+        auto size = this->instance_size.load(std::memory_order_relaxed);
+        if(size == 0) {
+            size = sizeof(ClassInstance);
+            for(const auto &field: this->fields) {
+                if(!field.HasFlag<AccessFlags::Static>()) {
+                    size += sizeof(ClassField);
+                }
+            }
+            for(const auto &fn: this->invokables) {
+                if(!fn.HasFlag<AccessFlags::Static>()) {
+                    size += sizeof(ClassInvokable);
+                }
+            }
+
+            auto super_class_type = this->GetSuperClassType();
+            if(super_class_type) {
+                size += super_class_type->GetInstanceSize();
+            }
+            for(const auto &intf_name: this->interface_class_names) {
+                auto intf_type = rt::LocateClassType(intf_name);
+                if(intf_type) {
+                    size += intf_type->GetInstanceSize();
+                }
+            }
+            this->instance_size.store(size, std::memory_order_relaxed);
+        }
+        return size;
+    }
+
+    ClassType::~ClassType() {
+        delete this->hierarchy_display.load();
+    }
+
+    ClassHierarchyDisplay *ClassType::ComputeHierarchyDisplay() {
+        auto display = new ClassHierarchyDisplay();
+        display->depth = 0;
+
+        const auto add_secondary_super = [&](Ptr<ClassType> super_type) {
+            for(const auto &secondary_super: display->secondary_supers) {
+                if(secondary_super == super_type) {
+                    return;
+                }
+            }
+            display->secondary_supers.push_back(super_type);
+        };
+
+        auto super_class = this->GetSuperClassType();
+        if(super_class) {
+            auto &super_display = super_class->GetHierarchyDisplay();
+            display->depth = super_display.depth + 1;
+            display->primary_supers = super_display.primary_supers;
+            display->primary_supers.push_back(super_class);
+            display->secondary_supers = super_display.secondary_supers;
+        }
+        for(const auto &intf_name: this->interface_class_names) {
+            auto intf_type = rt::LocateClassType(intf_name);
+            if(intf_type) {
+                add_secondary_super(intf_type);
+                for(const auto &intf_super: intf_type->GetHierarchyDisplay().secondary_supers) {
+                    add_secondary_super(intf_super);
+                }
+            }
+        }
+
+        // Racing threads compute the same display, only the first one gets kept
+        ClassHierarchyDisplay *cur_display = nullptr;
+        if(this->hierarchy_display.compare_exchange_strong(cur_display, display, std::memory_order_acq_rel)) {
+            return display;
+        }
+        delete display;
+        return cur_display;
     }
 
     Ptr<ClassType> ClassType::FindSelf() {
@@ -52,53 +153,128 @@ namespace javm::vm {
         return false;
     }
 
-    ExecutionResult ClassType::EnsureStaticInitializerCalled() {
-        // First, call it on our super class (if we have it)
+    namespace {
+
+        // Exceptions thrown by static initializers which aren't errors get wrapped (JVMS 5.5, step 11)
+        ExecutionResult WrapInitializerThrowable(const ExecutionResult &ret) {
+            if(!ret.Is<ExecutionStatus::Thrown>() || !ret.catchable_throw || !ret.var) {
+                return ret;
+            }
+
+            auto throwable_obj = ret.var->GetAs<type::ClassInstance>();
+            if(throwable_obj->GetClassType()->CanCastTo(u"java/lang/Error")) {
+                return ret;
+            }
+
+            auto wrap_class_type = rt::LocateClassType(u"java/lang/ExceptionInInitializerError");
+            if(!wrap_class_type) {
+                return ret;
+            }
+            auto wrap_v = NewClassVariable(wrap_class_type);
+            auto wrap_obj = wrap_v->GetAs<type::ClassInstance>();
+            const auto wrap_ret = wrap_obj->CallConstructor(wrap_v, u"(Ljava/lang/Throwable;)V", ret.var);
+            if(wrap_ret.IsInvalidOrThrown()) {
+                return ret;
+            }
+            return ThrowExisting(wrap_v);
+        }
+
+    }
+
+    ExecutionResult ClassType::Initialize() {
+        // Disabled initializers leave the class uninitialized, in case they get enabled later
+        if(!this->static_block_enabled) {
+            if(this->HasSuperClass()) {
+                auto super_class = this->GetSuperClassType();
+                if(super_class) {
+                    return super_class->EnsureStaticInitializerCalled();
+                }
+            }
+            return ExecutionResult::Void();
+        }
+
+        const auto self_id = GetCurrentLockOwnerId();
+        auto state = ClassInitializationState::NotInitialized;
+        {
+            // The thread running the initializer might be the one trying to stop the world
+            ScopedBlockedState blocked(GetCurrentThread());
+            ScopedMonitorLock lk(this->init_lock);
+            while(true) {
+                state = this->init_state.load(std::memory_order_acquire);
+                if((state == ClassInitializationState::BeingInitialized) && (this->init_thread_id != self_id)) {
+                    this->init_lock.Wait();
+                    continue;
+                }
+                if(state == ClassInitializationState::NotInitialized) {
+                    this->init_thread_id = self_id;
+                    this->init_state.store(ClassInitializationState::BeingInitialized, std::memory_order_release);
+                }
+                break;
+            }
+        }
+
+        switch(state) {
+            case ClassInitializationState::BeingInitialized:
+                // Recursive request by ourselves (the initializer itself, or a cycle between classes): the class is usable as it is now
+            case ClassInitializationState::Initialized:
+                return ExecutionResult::Void();
+            case ClassInitializationState::Erroneous:
+                return Throw(u"java/lang/NoClassDefFoundError", u"Could not initialize class " + MakeDotClassName(this->class_name));
+            default:
+                break;
+        }
+
+        const auto finish = [&](const ClassInitializationState state) {
+            ScopedMonitorLock lk(this->init_lock);
+            this->init_thread_id = 0;
+            this->init_state.store(state, std::memory_order_release);
+            this->init_lock.NotifyAll();
+        };
+
+        // First, initialize our super class (if we have it)
         if(this->HasSuperClass()) {
             auto super_class = this->GetSuperClassType();
             if(super_class) {
                 const auto ret = super_class->EnsureStaticInitializerCalled();
                 if(ret.IsInvalidOrThrown()) {
+                    finish(ClassInitializationState::Erroneous);
                     return ret;
                 }
             }
         }
 
-        // Check if we can call the static initializer
-        if(this->static_block_enabled) {
-            // Call the static initializer if it hasn't been called yet
-            if(!this->static_block_called) {
-                this->static_block_called = true;
-
-                constexpr auto StaticInitializerMethodName = u"<clinit>";
-                constexpr auto StaticInitializerMethodDescriptor = u"()V";
-                if(!this->HasClassMethod(StaticInitializerMethodName, StaticInitializerMethodDescriptor)) {
-                    return ExecutionResult::Void();
-                }
-
-                JAVM_LOG("[clinit] Calling static init of '%s'...", str::ToUtf8(this->class_name).c_str());
-                const auto ret = this->CallClassMethod(StaticInitializerMethodName, StaticInitializerMethodDescriptor);
-                JAVM_LOG("[clinit] Done '%s'...", str::ToUtf8(this->class_name).c_str());
-                return ret;
+        constexpr auto StaticInitializerMethodName = u"<clinit>";
+        constexpr auto StaticInitializerMethodDescriptor = u"()V";
+        if(this->HasClassMethod(StaticInitializerMethodName, StaticInitializerMethodDescriptor)) {
+            JAVM_LOG("[clinit] Calling static init of '%s'...", str::ToUtf8(this->class_name).c_str());
+            const auto ret = this->CallClassMethod(StaticInitializerMethodName, StaticInitializerMethodDescriptor);
+            JAVM_LOG("[clinit] Done '%s'...", str::ToUtf8(this->class_name).c_str());
+            if(ret.IsInvalidOrThrown()) {
+                finish(ClassInitializationState::Erroneous);
+                return WrapInitializerThrowable(ret);
             }
         }
+
+        finish(ClassInitializationState::Initialized);
         return ExecutionResult::Void();
     }
 
-    ExecutionResult ClassType::CallClassMethod(const String &name, const String &descriptor, const std::vector<Ptr<Variable>> &param_vars) {
+    ExecutionResult ClassType::CallClassMethod(const String &name, const String &descriptor, const VariableSpan &param_vars) {
         // Ensure static initializer is or has been called
         const auto ret = this->EnsureStaticInitializerCalled();
         if(ret.IsInvalidOrThrown()) {
             return ret;
         }
-        for(const auto &fn: this->invokables) {
+        for(u32 i = 0; i < this->invokables.size(); i++) {
+            const auto &fn = this->invokables[i];
             if(fn.HasFlag<AccessFlags::Static>() && (fn.GetName() == name) && (fn.GetDescriptor() == descriptor)) {
-                if(native::HasNativeClassMethod(this->class_name, name, descriptor)) {
-                    auto native_fn = native::FindNativeClassMethod(this->class_name, name, descriptor);
+                // Natives can also replace methods with Java code
+                auto native_fn = native::GetBoundNativeClassMethod(this->native_bindings[i], this->class_name, name, descriptor);
+                if(native_fn != nullptr) {
                     return native_fn(param_vars);
                 }
                 else if(fn.HasFlag<AccessFlags::Native>()) {
-                    return Throw(u"java/lang/UnsatisfiedLinkError", MakeDotClassName(this->class_name) + u"." + name + descriptor);
+                    return native::CallJNIClassMethod(this->FindSelf(), this->native_bindings[i], name, descriptor, param_vars);
                 }
                 for(const auto &attr: fn.GetAttributes()) {
                     if(attr.GetName() == AttributeName::Code) {
@@ -108,11 +284,11 @@ namespace javm::vm {
                         const bool is_sync = fn.HasFlag<AccessFlags::Synchronized>();
                         ExecutionScopeGuard guard(self_type, name, descriptor);
                         if(is_sync) {
-                            this->monitor->Enter();
+                            EnterObjectLock(this->lock);
                         }
-                        const auto ret = ExecuteStaticCode(code_attr.GetCode(), code_attr.GetMaxLocals(), code_attr.GetExceptionTable(), this->pool, param_vars);
+                        const auto ret = ExecuteStaticCode(code_attr.GetCode(), code_attr.GetMaxLocals(), code_attr.GetMaxStack(), code_attr.GetExceptionTable(), this->pool, param_vars);
                         if(is_sync) {
-                            this->monitor->Leave();
+                            this->lock.Leave();
                         }
                         if(ret.Is<ExecutionStatus::Thrown>()) {
                             guard.NotifyThrown();
@@ -131,6 +307,47 @@ namespace javm::vm {
         return ExecutionResult::InvalidState();
     }
 
+    ExecutionResult ClassType::CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const VariableSpan &param_vars) {
+        for(u32 i = 0; i < this->invokables.size(); i++) {
+            const auto &fn = this->invokables[i];
+            if(!fn.HasFlag<AccessFlags::Static>() && (fn.GetName() == name) && (fn.GetDescriptor() == descriptor)) {
+                auto native_fn = native::GetBoundNativeInstanceMethod(this->native_bindings[i], this->class_name, name, descriptor);
+                if(native_fn != nullptr) {
+                    return native_fn(this_as_var, param_vars);
+                }
+                else if(fn.HasFlag<AccessFlags::Native>()) {
+                    return native::CallJNIInstanceMethod(this->FindSelf(), this->native_bindings[i], name, descriptor, this_as_var, param_vars);
+                }
+                for(const auto &attr: fn.GetAttributes()) {
+                    if(attr.GetName() == AttributeName::Code) {
+                        auto reader = attr.OpenRead();
+                        CodeAttributeData code_attr(reader, this->pool);
+                        auto sync_lock = fn.HasFlag<AccessFlags::Synchronized>() ? GetObjectLock(this_as_var) : nullptr;
+                        ExecutionScopeGuard guard(this->FindSelf(), name, descriptor);
+                        if(sync_lock != nullptr) {
+                            EnterObjectLock(*sync_lock);
+                        }
+                        const auto ret = ExecuteCode(code_attr.GetCode(), code_attr.GetMaxLocals(), code_attr.GetMaxStack(), code_attr.GetExceptionTable(), this_as_var, this->pool, param_vars);
+                        if(sync_lock != nullptr) {
+                            sync_lock->Leave();
+                        }
+                        if(ret.Is<ExecutionStatus::Thrown>()) {
+                            guard.NotifyThrown();
+                        }
+                        return ret;
+                    }
+                }
+            }
+        }
+        if(this->HasSuperClass()) {
+            auto super_class = this->GetSuperClassType();
+            if(super_class) {
+                return super_class->CallInstanceMethod(name, descriptor, this_as_var, param_vars);
+            }
+        }
+        return ExecutionResult::InvalidState();
+    }
+
     bool ClassType::HasClassMethod(const String &name, const String &descriptor) {
         for(const auto &fn: this->invokables) {
             if(fn.HasFlag<AccessFlags::Static>() && (fn.GetName() == name) && (fn.GetDescriptor() == descriptor)) {
@@ -141,23 +358,29 @@ namespace javm::vm {
         return false;
     }
 
-    Ptr<Variable> ClassType::GetStaticField(const String &name, const String &descriptor) {
-        // Just in case, call the static initializer if it hasn't been called yet
-        const auto ret = this->EnsureStaticInitializerCalled();
-        if(ret.IsInvalidOrThrown()) {
-            return nullptr;
+    i32 ClassType::FindStaticFieldSlot(const String &name, const String &descriptor) {
+        for(u32 i = 0; i < this->static_fields.size(); i++) {
+            const auto &field = this->static_fields[i];
+            if((field.GetName() == name) && (field.GetDescriptor() == descriptor)) {
+                return static_cast<i32>(i);
+            }
         }
+        return -1;
+    }
 
-        for(auto &field: this->static_fields) {
-            if((field.GetName() == name) && (field.GetDescriptor() == descriptor)) {
-                if(field.HasVariable()) {
-                    return field.GetVariable();
-                }
-                else {
-                    const auto field_v_type = GetVariableTypeByDescriptor(descriptor);
-                    auto default_var = NewDefaultVariable(field_v_type);
-                    field.SetVariable(default_var);
-                    return default_var;
+    Ptr<ClassType> ClassType::ResolveStaticField(const String &name, const String &descriptor, u32 &out_slot) {
+        const auto slot = this->FindStaticFieldSlot(name, descriptor);
+        if(slot >= 0) {
+            out_slot = static_cast<u32>(slot);
+            return this->FindSelf();
+        }
+
+        for(const auto &intf_name: this->interface_class_names) {
+            auto intf_type = rt::LocateClassType(intf_name);
+            if(intf_type) {
+                auto decl_type = intf_type->ResolveStaticField(name, descriptor, out_slot);
+                if(decl_type) {
+                    return decl_type;
                 }
             }
         }
@@ -165,58 +388,91 @@ namespace javm::vm {
         if(this->HasSuperClass()) {
             auto super_class_type = this->GetSuperClassType();
             if(super_class_type) {
-                return super_class_type->GetStaticField(name, descriptor);
+                return super_class_type->ResolveStaticField(name, descriptor, out_slot);
             }
         }
 
         return nullptr;
     }
 
-    void ClassType::SetStaticField(const String &name, const String &descriptor, Ptr<Variable> var) {
+    Ptr<Variable> ClassType::GetStaticFieldAt(const u32 slot) {
+        auto &var_slot = this->static_slots[slot];
+        if(this->static_fields[slot].HasFlag<AccessFlags::Volatile>()) {
+            return AtomicLoadSlot(var_slot, this->static_types[slot]);
+        }
+        return var_slot.var;
+    }
+
+    void ClassType::SetStaticFieldAt(const u32 slot, Ptr<Variable> var) {
+        if(this->static_fields[slot].HasFlag<AccessFlags::Volatile>()) {
+            AtomicStoreSlot(this->static_slots[slot], var);
+        }
+        else {
+            StoreHeapSlot(this->static_slots[slot], var);
+        }
+    }
+
+    Ptr<Variable> ClassType::GetStaticField(const String &name, const String &descriptor) {
         // Just in case, call the static initializer if it hasn't been called yet
         const auto ret = this->EnsureStaticInitializerCalled();
         if(ret.IsInvalidOrThrown()) {
-            return;
+            return nullptr;
         }
 
-        for(auto &field: this->static_fields) {
-            if((field.GetName() == name) && (field.GetDescriptor() == descriptor)) {
-                field.SetVariable(var);
+        u32 slot = 0;
+        auto decl_type = this->ResolveStaticField(name, descriptor, slot);
+        if(decl_type) {
+            // Inherited fields belong to (and are initialized by) the class declaring them
+            const auto decl_ret = decl_type->EnsureStaticInitializerCalled();
+            if(decl_ret.IsInvalidOrThrown()) {
+                return nullptr;
             }
+            return decl_type->GetStaticFieldAt(slot);
         }
+
+        return nullptr;
     }
 
-    bool ClassType::HasStaticField(const String &name, const String &descriptor) {
-        for(const auto &field: this->static_fields) {
-            if((field.GetName() == name) && (field.GetDescriptor() == descriptor)) {
-                return true;
-            }
+    void ClassType::SetStaticField(const String &name, const String &descriptor, Ptr<Variable> var) {
+        // Just in case, call the static initializer if it hasn't been called yet
+        const auto ret = this->EnsureStaticInitializerCalled();
+        if(ret.IsInvalidOrThrown()) {
+            return;
         }
 
-        if(this->HasSuperClass()) {
-            auto super_class_type = this->GetSuperClassType();
-            if(super_class_type) {
-                return super_class_type->HasStaticField(name, descriptor);
+        u32 slot = 0;
+        auto decl_type = this->ResolveStaticField(name, descriptor, slot);
+        if(decl_type) {
+            const auto decl_ret = decl_type->EnsureStaticInitializerCalled();
+            if(decl_ret.IsInvalidOrThrown()) {
+                return;
             }
+            decl_type->SetStaticFieldAt(slot, var);
         }
+    }
 
-        return false;
+    bool ClassType::HasStaticField(const String &name, const String &descriptor) {
+        u32 slot = 0;
+        return this->ResolveStaticField(name, descriptor, slot) != nullptr;
     }
 
-    Ptr<Variable> ClassType::GetStaticFieldByUnsafeOffset(const type::Integer offset) {
-        if(offset < this->static_fields.size()) {
-            const auto &field = this->static_fields.at(offset);
-            return this->GetStaticField(field.GetName(), field.GetDescriptor());
+    bool ClassType::IsSubtypeOf(ClassType &other) {
+        if(&other == this) {
+            return true;
         }
 
-        return nullptr;
-    }
+        auto &display = this->GetHierarchyDisplay();
+        if(!other.IsInterface()) {
+            const auto other_depth = other.GetHierarchyDisplay().depth;
+            return (other_depth < display.depth) && (display.primary_supers[other_depth].get() == &other);
+        }
 
-    void ClassType::SetStaticFieldByUnsafeOffset(const type::Integer offset, Ptr<Variable> var) {
-        if(offset < this->static_fields.size()) {
-            const auto &field = this->static_fields.at(offset);
-            this->SetStaticField(field.GetName(), field.GetDescriptor(), var);
+        for(const auto &secondary_super: display.secondary_supers) {
+            if(secondary_super.get() == &other) {
+                return true;
+            }
         }
+        return false;
     }
 
     bool ClassType::CanCastTo(const String &class_name) {
@@ -224,6 +480,11 @@ namespace javm::vm {
             return true;
         }
 
+        auto other_type = rt::LocateClassType(class_name);
+        if(other_type) {
+            return this->IsSubtypeOf(*other_type);
+        }
+
         for(const auto &intf: this->interface_class_names) {
             if(EqualClassNames(class_name, intf)) {
                 return true;
@@ -231,7 +492,10 @@ namespace javm::vm {
         }
 
         if(this->HasSuperClass()) {
-            return this->GetSuperClassType()->CanCastTo(class_name);
+            auto super_class = this->GetSuperClassType();
+            if(super_class) {
+                return super_class->CanCastTo(class_name);
+            }
         }
 
         return false;
@@ -286,6 +550,14 @@ namespace javm::vm {
         }
     }
 
+    void ClassInstance::ClearReferences() {
+        for(auto &field: this->member_fields) {
+            field.GetVariableSlot().var.reset();
+        }
+        this->super_class_instance.reset();
+        this->interface_instances.clear();
+    }
+
     Ptr<ClassInstance> ClassInstance::GetInstanceByClassType(Ptr<ClassInstance> this_as_obj, const String &class_name) {
         if(EqualClassNames(class_name, this->class_type->GetClassName())) {
             return this_as_obj;
@@ -353,15 +625,7 @@ namespace javm::vm {
     Ptr<Variable> ClassInstance::GetField(const String &name, const String &descriptor) {
         for(auto &field: this->member_fields) {
             if((field.GetName() == name) && (field.GetDescriptor() == descriptor)) {
-                if(field.HasVariable()) {
-                    return field.GetVariable();
-                }
-                else {
-                    const auto field_v_type = GetVariableTypeByDescriptor(descriptor);
-                    auto default_var = NewDefaultVariable(field_v_type);
-                    field.SetVariable(default_var);
-                    return default_var;
-                }
+                return field.GetVariable();
             }
         }
         if(this->HasSuperClass()) {
@@ -397,45 +661,40 @@ namespace javm::vm {
         return false;
     }
 
-    Ptr<Variable> ClassInstance::GetFieldByUnsafeOffset(const type::Integer offset) {
-        if(offset < this->member_fields.size()) {
-            const auto &field = this->member_fields.at(offset);
-            return this->GetField(field.GetName(), field.GetDescriptor());
+    ClassField *ClassInstance::GetFieldByUnsafeOffset(const type::Integer offset) {
+        if((offset >= 0) && (static_cast<size_t>(offset) < this->member_fields.size())) {
+            return &this->member_fields.at(offset);
         }
 
         return nullptr;
     }
 
-    void ClassInstance::SetFieldByUnsafeOffset(const type::Integer offset, Ptr<Variable> var) {
-        if(offset < this->member_fields.size()) {
-            const auto &field = this->member_fields.at(offset);
-            this->SetField(field.GetName(), field.GetDescriptor(), var);
-        }
-    }
-
-    ExecutionResult ClassInstance::CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const std::vector<Ptr<Variable>> &param_vars) {
-        for(const auto &fn: this->methods) {
-            if((fn.GetName() == name) && (fn.GetDescriptor() == descriptor)) {
-                const auto class_name = this->class_type->GetClassName();
-                if(native::HasNativeInstanceMethod(class_name, name, descriptor)) {
-                    auto native_fn = native::FindNativeInstanceMethod(class_name, name, descriptor);
+    ExecutionResult ClassInstance::CallInstanceMethod(const String &name, const String &descriptor, Ptr<Variable> this_as_var, const VariableSpan &param_vars) {
+        // Go through the class type's methods, which hold the native bindings
+        auto &invokables = this->class_type->GetRawInvokables();
+        for(u32 i = 0; i < invokables.size(); i++) {
+            const auto &fn = invokables[i];
+            if(!fn.HasFlag<AccessFlags::Static>() && (fn.GetName() == name) && (fn.GetDescriptor() == descriptor)) {
+                auto native_fn = native::GetBoundNativeInstanceMethod(this->class_type->GetNativeBinding(i), this->class_type->GetClassName(), name, descriptor);
+                if(native_fn != nullptr) {
                     return native_fn(this_as_var, param_vars);
                 }
                 else if(fn.HasFlag<AccessFlags::Native>()) {
-                    return Throw(u"java/lang/UnsatisfiedLinkError", MakeDotClassName(this->class_type->GetClassName()) + u"." + name + descriptor);
+                    return native::CallJNIInstanceMethod(this->class_type, this->class_type->GetNativeBinding(i), name, descriptor, this_as_var, param_vars);
                 }
                 for(const auto &attr: fn.GetAttributes()) {
                     if(attr.GetName() == AttributeName::Code) {
                         auto reader = attr.OpenRead();
                         CodeAttributeData code_attr(reader, this->class_type->GetConstantPool());
-                        const bool is_sync = fn.HasFlag<AccessFlags::Synchronized>();
+                        // Lock the actual object, not this (maybe super class) sub-instance
+                        auto sync_lock = fn.HasFlag<AccessFlags::Synchronized>() ? GetObjectLock(this_as_var) : nullptr;
                         ExecutionScopeGuard guard(this->class_type, name, descriptor);
-                        if(is_sync) {
-                            this->monitor->Enter();
+                        if(sync_lock != nullptr) {
+                            EnterObjectLock(*sync_lock);
                         }
-                        const auto ret = ExecuteCode(code_attr.GetCode(), code_attr.GetMaxLocals(), code_attr.GetExceptionTable(), this_as_var, this->class_type->GetConstantPool(), param_vars);
-                        if(is_sync) {
-                            this->monitor->Leave();
+                        const auto ret = ExecuteCode(code_attr.GetCode(), code_attr.GetMaxLocals(), code_attr.GetMaxStack(), code_attr.GetExceptionTable(), this_as_var, this->class_type->GetConstantPool(), param_vars);
+                        if(sync_lock != nullptr) {
+                            sync_lock->Leave();
                         }
                         if(ret.Is<ExecutionStatus::Thrown>()) {
                             guard.NotifyThrown();
@@ -2,7 +2,7 @@
 
 namespace javm::vm {
 
-    ConstantPoolItem::ConstantPoolItem(MemoryReader &reader) : tag(ConstantPoolTag::Invalid), empty(true) {
+    ConstantPoolItem::ConstantPoolItem(MemoryReader &reader) : tag(ConstantPoolTag::Invalid), empty(true), resolved_var_claimed(false), resolved_var(nullptr), resolved_class_type(nullptr), last_subtype(nullptr), resolved_field_class_type(nullptr), resolved_field_slot(0) {
         this->tag = static_cast<ConstantPoolTag>(reader.Read<u8>());
         switch(this->tag) {
             case ConstantPoolTag::Utf8: {
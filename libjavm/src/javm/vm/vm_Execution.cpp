@@ -2,61 +2,98 @@
 
 namespace javm::vm {
 
-    void ExecutionFrame::VariableStack::ResetFill(Ptr<Variable> this_var, const u16 length) {
-        if(this->IsGrowable()) {
-            return;
+    namespace {
+
+        thread_local VariableArena g_ThreadVariableArena;
+
+    }
+
+    Ptr<Variable> *VariableArena::Allocate(const size_t count) {
+        if(!this->chunks.empty()) {
+            auto &chunk = this->chunks[this->cur_chunk_idx];
+            if((chunk.capacity - chunk.used) >= count) {
+                auto block = chunk.slots.get() + chunk.used;
+                chunk.used += count;
+                return block;
+            }
         }
 
-        auto len = length;
-        if(this_var) {
-            len++;
+        // Move on to the next chunk (empty, since allocations are LIFO), creating it if it's missing or too small
+        const auto next_chunk_idx = this->chunks.empty() ? 0 : (this->cur_chunk_idx + 1);
+        const auto capacity = std::max(ChunkSlotCount, count);
+        if(next_chunk_idx == this->chunks.size()) {
+            this->chunks.push_back({ std::make_unique<Ptr<Variable>[]>(capacity), capacity, 0 });
         }
-        this->inner_list.clear();
-        this->inner_list.reserve(len);
-        for(u16 i = 0; i < len; i++) {
-            this->inner_list.push_back(nullptr);
+        else if(this->chunks[next_chunk_idx].capacity < count) {
+            this->chunks[next_chunk_idx] = { std::make_unique<Ptr<Variable>[]>(capacity), capacity, 0 };
         }
+
+        this->cur_chunk_idx = next_chunk_idx;
+        auto &chunk = this->chunks[next_chunk_idx];
+        chunk.used = count;
+        return chunk.slots.get();
     }
 
-    Ptr<Variable> ExecutionFrame::VariableStack::GetAt(const u32 idx) {
-        if(this->IsGrowable()) {
-            return nullptr;
+    bool VariableArena::TryExtend(Ptr<Variable> *block_end, const size_t count) {
+        if(this->chunks.empty()) {
+            return false;
         }
 
-        if(idx < this->inner_list.size()) {
-            return this->inner_list[idx];
+        auto &chunk = this->chunks[this->cur_chunk_idx];
+        if(((chunk.slots.get() + chunk.used) == block_end) && ((chunk.capacity - chunk.used) >= count)) {
+            chunk.used += count;
+            return true;
         }
-        return nullptr;
+        return false;
     }
 
-    void ExecutionFrame::VariableStack::SetAt(const u32 idx, Ptr<Variable> var) {
-        if(this->IsGrowable()) {
+    void VariableArena::Release(const Mark &mark) {
+        if(this->chunks.empty()) {
             return;
         }
-        if(idx < this->inner_list.size()) {
-            this->inner_list[idx] = var;
+
+        // Released slots are cleared right away, so that they don't keep anything alive
+        while(true) {
+            auto &chunk = this->chunks[this->cur_chunk_idx];
+            const auto release_start = (this->cur_chunk_idx == mark.chunk_idx) ? mark.used : 0;
+            for(auto i = release_start; i < chunk.used; i++) {
+                chunk.slots[i].reset();
+            }
+            chunk.used = release_start;
+
+            if(this->cur_chunk_idx == mark.chunk_idx) {
+                break;
+            }
+            this->cur_chunk_idx--;
         }
     }
 
-    Ptr<Variable> ExecutionFrame::VariableStack::Pop() {
-        if(this->IsFixedSize()) {
-            return nullptr;
-        }
+    VariableArena &GetCurrentThreadVariableArena() {
+        return g_ThreadVariableArena;
+    }
 
-        if(this->inner_list.empty()) {
-            return nullptr;
-        }
-        auto back_var = this->inner_list.back();
-        this->inner_list.pop_back();
-        return back_var;
+    ExecutionFrame::ExecutionFrame(const u8 *raw_code, const u32 locals_count, const u16 max_stack, const std::vector<ExceptionTableEntry> &exc_table, ConstantPool &pool) : arena(GetCurrentThreadVariableArena()), locals_count(locals_count), stack_size(0), stack_capacity(max_stack), exec_pool(pool), exc_table(exc_table), code_ptr(raw_code), code_offset(0) {
+        this->arena_mark = this->arena.GetMark();
+        // Locals and operand stack are a single allocation
+        this->locals = this->arena.Allocate(locals_count + max_stack);
+        this->stack = this->locals + locals_count;
     }
 
-    void ExecutionFrame::VariableStack::Push(Ptr<Variable> var) {
-        if(this->IsFixedSize()) {
+    void ExecutionFrame::GrowStack() {
+        // Verified code never goes over max_stack, but just in case: this frame is the innermost one, so its stack is the last allocation
+        const auto extra_count = std::max(this->stack_capacity, 4u);
+        if(this->arena.TryExtend(this->stack + this->stack_capacity, extra_count)) {
+            this->stack_capacity += extra_count;
             return;
         }
 
-        this->inner_list.push_back(var);
+        // Move it to a bigger block, the old one is released along with the frame
+        auto new_stack = this->arena.Allocate(this->stack_capacity + extra_count);
+        for(u32 i = 0; i < this->stack_size; i++) {
+            new_stack[i] = std::move(this->stack[i]);
+        }
+        this->stack = new_stack;
+        this->stack_capacity += extra_count;
     }
 
     std::vector<ExceptionTableEntry> ExecutionFrame::GetAvailableExceptionTableEntries(const u32 base_code_offset) {
@@ -6,12 +6,13 @@ namespace javm::vm {
     namespace {
 
         u32 GetFunctionDescriptorParameterCount(const String &descriptor) {
-            auto tmp = descriptor.substr(descriptor.find_first_of(u'(') + 1);
-            tmp = tmp.substr(0, tmp.find_last_of(u')'));
+            const auto params_start = descriptor.find_first_of(u'(') + 1;
+            const auto params_end = descriptor.find_last_of(u')');
 
             bool parsing_class = false;
             u32 count = 0;
-            for(const auto &ch: tmp) {
+            for(auto i = params_start; i < params_end; i++) {
+                const auto ch = descriptor[i];
                 if(ch == u'[') {
                     // Array, so not a new parameter
                     continue;
@@ -32,72 +33,219 @@ namespace javm::vm {
             return count;
         }
 
-        std::vector<Ptr<Variable>> LoadClassMethodParameters(ExecutionFrame &frame, const String &descriptor) {
-            std::vector<Ptr<Variable>> params;
-            const u32 param_count = GetFunctionDescriptorParameterCount(descriptor);
-            for(u32 i = 0; i < param_count; i++) {
-                auto param_var = frame.PopStack();
-                params.push_back(param_var);
-            }
-            // Params are read in inverse order!
-            std::reverse(params.begin(), params.end());
-            return params;
+        // Parameters are already in order at the top of the operand stack, so they are passed from there (and dropped once the call returns)
+
+        inline VariableSpan PeekClassMethodParameters(ExecutionFrame &frame, const u32 param_count) {
+            return frame.PeekStack(param_count);
         }
 
-        std::pair<Ptr<Variable>, std::vector<Ptr<Variable>>> LoadInstanceMethodParameters(ExecutionFrame &frame, const String &descriptor) {
-            std::vector<Ptr<Variable>> params;
-            const u32 param_count = GetFunctionDescriptorParameterCount(descriptor);
-            for(u32 i = 0; i < param_count; i++) {
-                auto param_var = frame.PopStack();
-                params.push_back(param_var);
+        inline std::pair<Ptr<Variable>, VariableSpan> PeekInstanceMethodParameters(ExecutionFrame &frame, const u32 param_count) {
+            return { frame.PeekStackAt(param_count), frame.PeekStack(param_count) };
+        }
+
+        // Saturates instead of overflowing, anything that big won't fit in the heap anyway
+        // Only the innermost arrays of the array type hold elements of the given type, the rest hold arrays
+        u64 GetMultidimensionalArraySize(const std::vector<u32> &lengths, const u32 type_dimensions, const VariableType type) {
+            constexpr u64 MaxSize = UINT64_MAX;
+            u64 total_size = 0;
+            u64 array_count = 1;
+            for(u32 i = 0; i < lengths.size(); i++) {
+                const auto length = lengths[i];
+                const auto array_size = Array::GetAllocationSize(length, Array::GetElementSize(type, type_dimensions - i));
+                const auto dimension_size = (array_count > (MaxSize / array_size)) ? MaxSize : (array_count * array_size);
+                total_size = (total_size > (MaxSize - dimension_size)) ? MaxSize : (total_size + dimension_size);
+                if(length == 0) {
+                    break;
+                }
+                array_count = (array_count > (MaxSize / length)) ? MaxSize : (array_count * length);
             }
-            auto this_var = frame.PopStack();
-            // Params are read in inverse order!
-            std::reverse(params.begin(), params.end());
-            return { this_var, params };
+            return total_size;
         }
 
-        void CreatePopulateMultidimensionalArray(const u32 dimensions, const std::vector<u32> &lengths, Ptr<ClassType> class_type, const VariableType type, Ptr<Variable> &cur_array, const u32 cur_dimension_idx = 0) {
-            const auto dim_len = lengths.at(cur_dimension_idx);
-            if(cur_dimension_idx == 0) {
-                if(class_type) {
-                    cur_array = NewArrayVariable(dim_len, class_type, dimensions - cur_dimension_idx);
+        // Only done once per constant pool item, the result gets cached in it
+        Ptr<Variable> ResolveLoadableConstant(ConstantPoolItem &const_item) {
+            switch(const_item.GetTag()) {
+                case ConstantPoolTag::Integer: {
+                    const auto value = const_item.GetIntegerData().integer;
+                    JAVM_LOG("[ldc-base] Int value: '%d'", value);
+                    return NewPrimitiveVariable<type::Integer>(value);
+                }
+                case ConstantPoolTag::Float: {
+                    const auto value = const_item.GetFloatData().flt;
+                    JAVM_LOG("[ldc-base] Float value: '%f'", value);
+                    return NewPrimitiveVariable<type::Float>(value);
+                }
+                case ConstantPoolTag::Long: {
+                    const auto value = const_item.GetLongData().lng;
+                    JAVM_LOG("[ldc-base] Long value: '%ld'", value);
+                    return NewPrimitiveVariable<type::Long>(value);
+                }
+                case ConstantPoolTag::Double: {
+                    const auto value = const_item.GetDoubleData().dbl;
+                    JAVM_LOG("[ldc-base] Double value: '%f'", value);
+                    return NewPrimitiveVariable<type::Double>(value);
+                }
+                case ConstantPoolTag::String: {
+                    // The constant pool keeps the (interned) literal alive as long as its class is loaded
+                    const auto str = const_item.GetStringData().processed_string;
+                    JAVM_LOG("[ldc-base] String value: '%s'", str::ToUtf8(str).c_str());
+                    return jutil::InternString(str);
+                }
+                case ConstantPoolTag::Class: {
+                    const auto type_name = const_item.GetClassData().processed_name;
+                    JAVM_LOG("[ldc-base] Type name: '%s'", str::ToUtf8(type_name).c_str());
+                    auto ref_type = ref::FindReflectionTypeByName(type_name);
+                    if(ref_type) {
+                        return NewClassTypeVariable(ref_type);
+                    }
+                    return nullptr;
                 }
-                else {
-                    cur_array = NewArrayVariable(dim_len, type, dimensions - cur_dimension_idx);
-                }
-                CreatePopulateMultidimensionalArray(dimensions, lengths, class_type, type, cur_array, cur_dimension_idx + 1);
+                default:
+                    return nullptr;
+            }
+        }
+
+        // Static field references get resolved once to the class declaring the field and its slot there, cached in the constant pool item
+        ExecutionResult ResolveStaticFieldRef(ConstantPool &const_pool, const u16 index, ClassType *&out_class_type, u32 &out_slot) {
+            auto const_field_item = const_pool.GetItemAt(index, ConstantPoolTag::FieldRef);
+            if(!const_field_item) {
+                return ThrowInternal(u"Invalid const pool item FieldRef...?");
+            }
+
+            out_class_type = const_field_item->GetResolvedFieldClassType(out_slot);
+            if(out_class_type != nullptr) {
+                return ExecutionResult::Void();
+            }
+
+            auto const_field_data = const_field_item->GetFieldMethodRefData();
+            auto const_class_item = const_pool.GetItemAt(const_field_data.class_index, ConstantPoolTag::Class);
+            if(!const_class_item) {
+                return ThrowInternal(u"Invalid const pool item Class...?");
+            }
+            auto field_nat_item = const_pool.GetItemAt(const_field_data.name_and_type_index, ConstantPoolTag::NameAndType);
+            if(!field_nat_item) {
+                return ThrowInternal(u"Invalid const pool item NAT...?");
             }
-            else if(cur_dimension_idx < (dimensions - 1)) {
-                auto cur_array_obj = cur_array->GetAs<type::Array>();
-                for(u32 i = 0; i < cur_array_obj->GetLength(); i++) {
-                    Ptr<Variable> array;
-                    if(class_type) {
-                        array = NewArrayVariable(dim_len, class_type, dimensions - cur_dimension_idx);
-                    }
-                    else {
-                        array = NewArrayVariable(dim_len, type, dimensions - cur_dimension_idx);
-                    }
 
-                    CreatePopulateMultidimensionalArray(dimensions, lengths, class_type, type, array, cur_dimension_idx + 1);
-                    cur_array_obj->SetAt(i, array);
+            const auto class_name = const_class_item->GetClassData().processed_name;
+            const auto field_nat_data = field_nat_item->GetNameAndTypeData();
+            JAVM_LOG("[static-field] Resolving static field '%s' ('%s') of '%s'...", str::ToUtf8(field_nat_data.processed_name).c_str(), str::ToUtf8(field_nat_data.processed_desc).c_str(), str::ToUtf8(class_name).c_str());
+
+            auto class_type = rt::LocateClassType(class_name);
+            if(!class_type) {
+                return ThrowInternal(str::Format("Invalid class name: '%s'", str::ToUtf8(class_name).c_str()));
+            }
+            out_class_type = class_type->ResolveStaticField(field_nat_data.processed_name, field_nat_data.processed_desc, out_slot).get();
+            if(out_class_type == nullptr) {
+                return Throw(u"java/lang/NoSuchFieldError", field_nat_data.processed_name);
+            }
+
+            const_field_item->SetResolvedField(out_class_type, out_slot);
+            return ExecutionResult::Void();
+        }
+
+        // The class constant gets resolved once, and the last class type which passed the check is remembered, so repeated checks of the same type are a single compare
+        bool IsSubtypeOfClassConstant(ConstantPoolItem &const_class_item, Ptr<ClassType> class_type) {
+            if(const_class_item.GetLastSubtype() == class_type.get()) {
+                return true;
+            }
+
+            auto other_type = const_class_item.GetResolvedClassType();
+            if(other_type == nullptr) {
+                const auto &class_name = const_class_item.GetClassData().processed_name;
+                auto located_type = rt::LocateClassType(class_name);
+                if(!located_type) {
+                    return class_type->CanCastTo(class_name);
                 }
+                other_type = located_type.get();
+                const_class_item.SetResolvedClassType(other_type);
             }
-            else {
-                // Last dimension to populate
-                auto cur_array_obj = cur_array->GetAs<type::Array>();
-                for(u32 i = 0; i < cur_array_obj->GetLength(); i++) {
-                    Ptr<Variable> array;
-                    if(class_type) {
-                        array = NewArrayVariable(dim_len, class_type);
-                    }
-                    else {
-                        array = NewArrayVariable(dim_len, type);
-                    }
 
-                    cur_array_obj->SetAt(i, array);
+            if(class_type->IsSubtypeOf(*other_type)) {
+                const_class_item.SetLastSubtype(class_type.get());
+                return true;
+            }
+            return false;
+        }
+
+        inline bool IsArrayInterfaceName(const String &class_name) {
+            const auto slash_class_name = MakeSlashClassName(class_name);
+            return (slash_class_name == u"java/lang/Object") || (slash_class_name == u"java/lang/Cloneable") || (slash_class_name == u"java/io/Serializable");
+        }
+
+        // Arrays are instances of Object/Cloneable/Serializable (or arrays of them, with less dimensions), or of arrays with the same dimensions and a compatible element type
+        bool IsArrayInstanceOf(Ptr<Array> array, const String &class_name) {
+            auto target_ref_type = ref::FindReflectionTypeByName(class_name);
+            if(!target_ref_type) {
+                return false;
+            }
+
+            const auto array_dims = array->GetDimensions();
+            const auto target_dims = target_ref_type->GetArrayDimensions();
+            auto target_class_type = target_ref_type->GetClassType();
+            if(target_dims < array_dims) {
+                return !target_ref_type->IsPrimitiveType() && target_class_type && IsArrayInterfaceName(target_class_type->GetClassName());
+            }
+            else if(target_dims > array_dims) {
+                return false;
+            }
+
+            if(array->IsClassInstanceArray()) {
+                return !target_ref_type->IsPrimitiveType() && target_class_type && array->GetClassType()->IsSubtypeOf(*target_class_type);
+            }
+            return target_ref_type->GetPrimitiveType() == array->GetVariableType();
+        }
+
+        inline ExecutionResult ThrowOutOfMemory() {
+            return Throw(u"java/lang/OutOfMemoryError", u"Java heap space");
+        }
+
+        // Rectangular arrays get built level by level, with the component type resolved once (by the caller)
+        // The innermost primitive arrays are all placed in a single zeroed storage block, instead of getting allocated one by one
+        // The array type might have more dimensions than the ones given lengths, in which case the innermost arrays hold nulls
+        Ptr<Variable> NewMultidimensionalArray(const std::vector<u32> &lengths, const u32 type_dimensions, Ptr<ClassType> class_type, const VariableType type) {
+            const auto new_array = [&](const u32 length, const u32 dimensions) {
+                if(class_type) {
+                    return NewArrayVariable(length, class_type, dimensions);
                 }
+                else {
+                    return NewArrayVariable(length, type, dimensions);
+                }
+            };
+
+            auto base_array = new_array(lengths.front(), type_dimensions);
+            std::vector<Ptr<Array>> cur_arrays = { base_array->GetAs<type::Array>() };
+            for(u32 i = 1; i < lengths.size(); i++) {
+                const auto dim_len = lengths[i];
+                const auto dimensions = type_dimensions - i;
+                const auto array_count = cur_arrays.size() * static_cast<size_t>(lengths[i - 1]);
+
+                const auto use_block = !class_type && (dimensions == 1) && IsPrimitiveVariableType(type);
+                const auto leaf_size = static_cast<size_t>(dim_len) * Array::GetElementSize(type);
+                std::shared_ptr<u8[]> block;
+                if(use_block) {
+                    block = Array::NewPrimitiveBlock(array_count * leaf_size);
+                }
+
+                std::vector<Ptr<Array>> next_arrays;
+                next_arrays.reserve(array_count);
+                for(auto &cur_array: cur_arrays) {
+                    for(u32 j = 0; j < cur_array->GetLength(); j++) {
+                        Ptr<Variable> array;
+                        if(use_block) {
+                            array = ptr::New<Variable>(NewArrayObject(type, dim_len, block, block.get() + next_arrays.size() * leaf_size));
+                        }
+                        else {
+                            array = new_array(dim_len, dimensions);
+                        }
+                        // Freshly created, so no type checks are needed
+                        StoreHeapSlot(cur_array->GetSlotAt(j), array);
+                        next_arrays.push_back(array->GetAs<type::Array>());
+                    }
+                }
+                cur_arrays = std::move(next_arrays);
             }
+            return base_array;
         }
 
     }
@@ -142,61 +290,18 @@ namespace javm::vm {
                 auto const_item = const_pool.GetItemAt(idx); \
                 if(const_item) { \
                     JAVM_LOG("[ldc-base] Tag: %d", static_cast<u32>(const_item->GetTag())); \
-                    switch(const_item->GetTag()) { \
-                        case ConstantPoolTag::Integer: { \
-                            const auto value = const_item->GetIntegerData().integer; \
-                            JAVM_LOG("[ldc-base] Int value: '%d'", value); \
-                            auto var = NewPrimitiveVariable<type::Integer>(value); \
-                            frame.PushStack(var); \
-                            break; \
-                        } \
-                        case ConstantPoolTag::Float: { \
-                            const auto value = const_item->GetFloatData().flt; \
-                            JAVM_LOG("[ldc-base] Float value: '%f'", value); \
-                            auto var = NewPrimitiveVariable<type::Float>(value); \
-                            frame.PushStack(var); \
-                            break; \
+                    auto const_var = const_item->GetResolvedVariable(); \
+                    if(!const_var) { \
+                        const_var = ResolveLoadableConstant(*const_item); \
+                        if(!const_var) { \
+                            return ThrowInternal(u"Invalid or unsupported constant pool item 1"); \
                         } \
-                        case ConstantPoolTag::Long: { \
-                            const auto value = const_item->GetLongData().lng; \
-                            JAVM_LOG("[ldc-base] Long value: '%ld'", value); \
-                            auto var = NewPrimitiveVariable<type::Long>(value); \
-                            frame.PushStack(var); \
-                            break; \
-                        } \
-                        case ConstantPoolTag::Double: { \
-                            const auto value = const_item->GetDoubleData().dbl; \
-                            JAVM_LOG("[ldc-base] Double value: '%f'", value); \
-                            auto var = NewPrimitiveVariable<type::Double>(value); \
-                            frame.PushStack(var); \
-                            break; \
-                        } \
-                        case ConstantPoolTag::String: { \
-                            const auto str = const_item->GetStringData().processed_string; \
-                            JAVM_LOG("[ldc-base] String value: '%s'", str::ToUtf8(str).c_str()); \
-                            auto str_var = jutil::NewString(str); \
-                            frame.PushStack(str_var); \
-                            break; \
-                        } \
-                        case ConstantPoolTag::Class: { \
-                            const auto type_name = const_item->GetClassData().processed_name; \
-                            JAVM_LOG("[ldc-base] Type name: '%s'", str::ToUtf8(type_name).c_str()); \
-                            auto ref_type = ref::FindReflectionTypeByName(type_name); \
-                            if(ref_type) { \
-                                auto class_v = NewClassTypeVariable(ref_type); \
-                                frame.PushStack(class_v); \
-                            } \
-                            else { \
-                                ThrowInternal(u"Invalid or unsupported constant pool item 1"); \
-                            } \
-                            break; \
-                        } \
-                        default: \
-                            break; \
+                        const_item->SetResolvedVariable(const_var); \
                     } \
+                    frame.PushStack(const_var); \
                 } \
                 else { \
-                    ThrowInternal(u"Invalid or unsupported constant pool item 2"); \
+                    return ThrowInternal(u"Invalid or unsupported constant pool item 2"); \
                 } \
             }
 
@@ -894,7 +999,7 @@ namespace javm::vm {
                     auto var1 = frame.PopStack();
                     JAVM_LOG("[acmpeq] %s == %s", str::ToUtf8(FormatVariable(var1)).c_str(), str::ToUtf8(FormatVariable(var2)).c_str());
                     const auto rel_code_offset = BE(frame.ReadCode<i16>());
-                    if(ptr::Equal(var1, var2)) {
+                    if(IsSameObject(var1, var2)) {
                         cur_offset = base_code_offset;
                         cur_offset += rel_code_offset;
                     }
@@ -905,7 +1010,7 @@ namespace javm::vm {
                     auto var1 = frame.PopStack();
                     JAVM_LOG("[acmpne] %s != %s", str::ToUtf8(FormatVariable(var1)).c_str(), str::ToUtf8(FormatVariable(var2)).c_str());
                     const auto rel_code_offset = BE(frame.ReadCode<i16>());
-                    if(!ptr::Equal(var1, var2)) {
+                    if(!IsSameObject(var1, var2)) {
                         cur_offset = base_code_offset;
                         cur_offset += rel_code_offset;
                     }
@@ -994,87 +1099,40 @@ namespace javm::vm {
                 case Instruction::GETSTATIC: {
                     const auto index = BE(frame.ReadCode<u16>());
 
-                    auto &const_pool = frame.GetThisConstantPool();
-                    auto const_field_item = const_pool.GetItemAt(index, ConstantPoolTag::FieldRef);
-                    if(const_field_item) {
-                        auto const_field_data = const_field_item->GetFieldMethodRefData();
-                        auto const_class_item = const_pool.GetItemAt(const_field_data.class_index, ConstantPoolTag::Class);
-                        if(const_class_item) {
-                            auto const_class_data = const_class_item->GetClassData();
-                            const auto class_name = const_class_data.processed_name;
-                            auto field_nat_item = const_pool.GetItemAt(const_field_data.name_and_type_index, ConstantPoolTag::NameAndType);
-                            if(field_nat_item) {
-                                auto field_nat_data = field_nat_item->GetNameAndTypeData();
-                                const auto field_name = field_nat_data.processed_name;
-                                const auto field_desc = field_nat_data.processed_desc;
-
-                                JAVM_LOG("[getstatic] Get static field '%s' ('%s') of '%s'...", str::ToUtf8(field_name).c_str(), str::ToUtf8(field_desc).c_str(), str::ToUtf8(class_name).c_str());
-
-                                auto class_type = rt::LocateClassType(class_name);
-                                if(class_type) {
-                                    auto var = class_type->GetStaticField(field_name, field_desc);
-                                    JAVM_LOG("[getstatic] Static field: '%s'...", str::ToUtf8(FormatVariableType(var)).c_str());
-                                    frame.PushStack(var);
-                                }
-                                else {
-                                    return ThrowInternal(str::Format("Invalid class name: '%s'", str::ToUtf8(class_name).c_str()));
-                                }
-                            }
-                            else {
-                                return ThrowInternal(u"Invalid const pool item NAT...?");
-                            }
-                        }
-                        else {
-                            return ThrowInternal(u"Invalid const pool item Class...?");
-                        }
+                    ClassType *class_type = nullptr;
+                    u32 slot = 0;
+                    const auto res = ResolveStaticFieldRef(frame.GetThisConstantPool(), index, class_type, slot);
+                    if(res.IsInvalidOrThrown()) {
+                        return res;
                     }
-                    else {
-                        return ThrowInternal(u"Invalid const pool item FieldRef...?");
+                    // The class declaring the field is the one to initialize
+                    const auto init_res = class_type->EnsureStaticInitializerCalled();
+                    if(init_res.IsInvalidOrThrown()) {
+                        return init_res;
                     }
 
+                    auto var = class_type->GetStaticFieldAt(slot);
+                    JAVM_LOG("[getstatic] Static field: '%s'...", str::ToUtf8(FormatVariableType(var)).c_str());
+                    frame.PushStack(var);
                     break;
                 }
                 case Instruction::PUTSTATIC: {
                     const auto index = BE(frame.ReadCode<u16>());
                     auto var = frame.PopStack();
-                    
-                    auto &const_pool = frame.GetThisConstantPool();
-                    auto const_field_item = const_pool.GetItemAt(index, ConstantPoolTag::FieldRef);
-                    if(const_field_item) {
-                        auto const_field_data = const_field_item->GetFieldMethodRefData();
-                        auto const_class_item = const_pool.GetItemAt(const_field_data.class_index, ConstantPoolTag::Class);
-                        if(const_class_item) {
-                            auto const_class_data = const_class_item->GetClassData();
-                            const auto class_name = const_class_data.processed_name;
-                            auto field_nat_item = const_pool.GetItemAt(const_field_data.name_and_type_index, ConstantPoolTag::NameAndType);
-                            if(field_nat_item) {
-                                auto field_nat_data = field_nat_item->GetNameAndTypeData();
-                                const auto field_name = field_nat_data.processed_name;
-                                const auto field_desc = field_nat_data.processed_desc;
-
-                                JAVM_LOG("[putstatic] Set static field '%s' ('%s') of '%s'...", str::ToUtf8(field_name).c_str(), str::ToUtf8(field_desc).c_str(), str::ToUtf8(class_name).c_str());
-                                JAVM_LOG("[putstatic] Static field: '%s'...", str::ToUtf8(FormatVariableType(var)).c_str());
 
-                                auto class_type = rt::LocateClassType(class_name);
-                                if(class_type) {
-                                    class_type->SetStaticField(field_name, field_desc, var);
-                                }
-                                else {
-                                    return ThrowInternal(str::Format("Invalid class name: '%s'", str::ToUtf8(class_name).c_str()));
-                                }
-                            }
-                            else {
-                                return ThrowInternal(u"Invalid const pool item NAT...?");
-                            }
-                        }
-                        else {
-                            return ThrowInternal(u"Invalid const pool item Class...?");
-                        }
+                    ClassType *class_type = nullptr;
+                    u32 slot = 0;
+                    const auto res = ResolveStaticFieldRef(frame.GetThisConstantPool(), index, class_type, slot);
+                    if(res.IsInvalidOrThrown()) {
+                        return res;
                     }
-                    else {
-                        return ThrowInternal(u"Invalid const pool item FieldRef...?");
+                    const auto init_res = class_type->EnsureStaticInitializerCalled();
+                    if(init_res.IsInvalidOrThrown()) {
+                        return init_res;
                     }
 
+                    JAVM_LOG("[putstatic] Static field: '%s'...", str::ToUtf8(FormatVariableType(var)).c_str());
+                    class_type->SetStaticFieldAt(slot, var);
                     break;
                 }
                 case Instruction::GETFIELD: {
@@ -1222,7 +1280,8 @@ namespace javm::vm {
 
                                 JAVM_LOG("[invoke] Executing '%s'::'%s'::'%s'...", str::ToUtf8(class_name).c_str(), str::ToUtf8(fn_name).c_str(), str::ToUtf8(fn_desc).c_str());
 
-                                auto [this_var, param_vars] = LoadInstanceMethodParameters(frame, fn_desc);
+                                const auto param_count = GetFunctionDescriptorParameterCount(fn_desc);
+                                const auto [this_var, param_vars] = PeekInstanceMethodParameters(frame, param_count);
                                 JAVM_LOG("[invoke] Parameter count: %ld + this...", param_vars.size());
                                 JAVM_LOG("[invoke] T this variable: %s", str::ToUtf8(FormatVariableType(this_var)).c_str());
                                 if(this_var->CanGetAs<VariableType::ClassInstance>()) {
@@ -1238,6 +1297,7 @@ namespace javm::vm {
                                     JAVM_LOG("[invoke] Detected instance type: '%s'...", str::ToUtf8(this_var_obj_c->GetClassType()->GetClassName()).c_str());
                                     if(this_var_obj_c) {
                                         const auto res = this_var_obj_c->CallInstanceMethod(fn_name, fn_desc, this_var, param_vars);
+                                        frame.DropStack(param_count + 1);
                                         if(res.IsInvalidOrThrown()) {
                                             JAVM_LOG("Invalid/thrown execution of '%s'::'%s'::'%s'...", str::ToUtf8(class_name).c_str(), str::ToUtf8(fn_name).c_str(), str::ToUtf8(fn_desc).c_str());
                                             return res;
@@ -1261,6 +1321,7 @@ namespace javm::vm {
 
                                     JAVM_LOG("[invoke] This array type: '%s'...", str::ToUtf8(FormatVariableType(this_var)).c_str());
                                     const auto res = this_array->CallInstanceMethod(fn_name, fn_desc, this_var, param_vars);
+                                    frame.DropStack(param_count + 1);
                                     if(res.IsInvalidOrThrown()) {
                                         JAVM_LOG("Invalid/thrown execution of '%s'::'%s'::'%s'...", str::ToUtf8(class_name).c_str(), str::ToUtf8(fn_name).c_str(), str::ToUtf8(fn_desc).c_str());
                                         return res;
@@ -1315,9 +1376,11 @@ namespace javm::vm {
 
                                 auto class_type = rt::LocateClassType(class_name);
                                 if(class_type) {
-                                    auto param_vars = LoadClassMethodParameters(frame, fn_desc);
+                                    const auto param_count = GetFunctionDescriptorParameterCount(fn_desc);
+                                    const auto param_vars = PeekClassMethodParameters(frame, param_count);
                                     JAVM_LOG("[invokestatic] Parameter count: %ld...", param_vars.size());
                                     const auto res = class_type->CallClassMethod(fn_name, fn_desc, param_vars);
+                                    frame.DropStack(param_count);
                                     if(res.IsInvalidOrThrown()) {
                                         JAVM_LOG("Invalid/thrown execution of '%s'::'%s'::'%s'...", str::ToUtf8(class_name).c_str(), str::ToUtf8(fn_name).c_str(), str::ToUtf8(fn_desc).c_str());
                                         return res;
@@ -1369,6 +1432,9 @@ namespace javm::vm {
                             if(res.IsInvalidOrThrown()) {
                                 return res;
                             }
+                            if(!EnsureHeapSpace(class_type->GetInstanceSize())) {
+                                return ThrowOutOfMemory();
+                            }
                             auto class_var = NewClassVariable(class_type);
                             frame.PushStack(class_var);
                         }
@@ -1391,6 +1457,9 @@ namespace javm::vm {
                         if(len_val >= 0) {
                             auto val_type = GetVariableTypeFromNewArrayType(static_cast<NewArrayType>(type));
                             if(val_type != VariableType::Invalid) {
+                                if(!EnsureHeapSpace(Array::GetAllocationSize(len_val, Array::GetElementSize(val_type)))) {
+                                    return ThrowOutOfMemory();
+                                }
                                 auto arr_v = NewArrayVariable(len_val, val_type);
                                 frame.PushStack(arr_v);
                             }
@@ -1430,6 +1499,9 @@ namespace javm::vm {
                                 const auto len_val = len_var->GetValue<type::Integer>();
                                 if(len_val >= 0) {
                                     JAVM_LOG("[anewarray] Array length: %d", len_val);
+                                    if(!EnsureHeapSpace(Array::GetAllocationSize(len_val))) {
+                                        return ThrowOutOfMemory();
+                                    }
                                     auto arr_v = NewArrayVariable(len_val, class_type);
                                     JAVM_LOG("[anewarray] Created array! '%s'", str::ToUtf8(FormatVariableType(arr_v)).c_str());
                                     frame.PushStack(arr_v);
@@ -1498,7 +1570,7 @@ namespace javm::vm {
                         if(var->CanGetAs<VariableType::ClassInstance>()) {
                             auto var_obj = var->GetAs<type::ClassInstance>();
                             JAVM_LOG("[checkcast] instance class name: '%s'", str::ToUtf8(var_obj->GetClassType()->GetClassName()).c_str());
-                            if(var_obj->GetClassType()->CanCastTo(class_name)) {
+                            if(IsSubtypeOfClassConstant(*const_class_item, var_obj->GetClassType())) {
                                 frame.PushStack(var);
                             }
                             else {
@@ -1510,19 +1582,11 @@ namespace javm::vm {
                         }
                         else if(var->CanGetAs<VariableType::Array>()) {
                             auto arr_obj = var->GetAs<type::Array>();
-                            auto class_type = arr_obj->GetClassType();
-
-                            auto class_ref_type = ref::FindReflectionTypeByName(class_name);
-                            if(class_ref_type->IsArray()) {
-                                if(class_type->CanCastTo(GetClassNameFromDescriptor(class_name))) {
-                                    frame.PushStack(var);
-                                }
-                                else {
-                                    return ThrowInternal(u"Invalid array cast");
-                                }
+                            if(IsArrayInstanceOf(arr_obj, class_name)) {
+                                frame.PushStack(var);
                             }
                             else {
-                                return ThrowInternal(str::Format("Casting array of '%s' to non-array type '%s'...", str::ToUtf8(class_type->GetClassName()).c_str(), str::ToUtf8(class_name).c_str()));
+                                return Throw(u"java/lang/ClassCastException", str::Format("%s cannot be cast to %s", str::ToUtf8(ref::FindArrayReflectionType(arr_obj)->GetTypeName()).c_str(), str::ToUtf8(MakeDotClassName(class_name)).c_str()));
                             }
                         }
                         else {
@@ -1547,13 +1611,16 @@ namespace javm::vm {
 
                         if(var->CanGetAs<VariableType::ClassInstance>()) {
                             auto var_obj = var->GetAs<type::ClassInstance>();
-                            if(var_obj->GetClassType()->CanCastTo(class_name)) {
+                            if(IsSubtypeOfClassConstant(*const_class_item, var_obj->GetClassType())) {
                                 frame.PushStack(MakeTrue());
                             }
                             else {
                                 frame.PushStack(MakeFalse());
                             }
                         }
+                        else if(var->CanGetAs<VariableType::Array>()) {
+                            frame.PushStack(IsArrayInstanceOf(var->GetAs<type::Array>(), class_name) ? MakeTrue() : MakeFalse());
+                        }
                         else if(var->IsNull()) {
                             frame.PushStack(MakeFalse());
                         }
@@ -1563,33 +1630,29 @@ namespace javm::vm {
                 }
                 case Instruction::MONITORENTER: {
                     auto var = frame.PopStack();
-                    if(var->CanGetAs<VariableType::ClassInstance>()) {
-                        auto var_obj = var->GetAs<type::ClassInstance>();
-                        auto monitor = var_obj->GetMonitor();
-                        monitor->Enter();
-                    }
-                    else if(var->IsNull()) {
+                    if(var->IsNull()) {
                         return Throw(u"java/lang/NullPointerException");
                     }
-                    else {
+                    auto obj_lock = GetObjectLock(var);
+                    if(obj_lock == nullptr) {
                         return ThrowInternal(u"Invalid monitor enter");
                     }
+                    EnterObjectLock(*obj_lock);
 
                     break;
                 }
                 case Instruction::MONITOREXIT: {
                     auto var = frame.PopStack();
-                    if(var->CanGetAs<VariableType::ClassInstance>()) {
-                        auto var_obj = var->GetAs<type::ClassInstance>();
-                        auto monitor = var_obj->GetMonitor();
-                        monitor->Leave();
-                    }
-                    else if(var->IsNull()) {
+                    if(var->IsNull()) {
                         return Throw(u"java/lang/NullPointerException");
                     }
-                    else {
+                    auto obj_lock = GetObjectLock(var);
+                    if(obj_lock == nullptr) {
                         return ThrowInternal(u"Invalid monitor leave");
                     }
+                    if(!obj_lock->Leave()) {
+                        return Throw(u"java/lang/IllegalMonitorStateException");
+                    }
 
                     break;
                 }
@@ -1615,30 +1678,31 @@ namespace javm::vm {
 
                             lens.insert(lens.begin(), len_val);
                         }
-                        Ptr<Variable> base_arr_v;
-
+                        // Resolve the component type once, for every level
+                        auto base_type = VariableType::ClassInstance;
+                        Ptr<ClassType> class_type;
                         if(IsPrimitiveType(base_type_name)) {
-                            const auto type = GetVariableTypeByDescriptor(base_type_name);
-                            JAVM_LOG("[multianewarray] Primitive type name: '%s'", str::ToUtf8(GetPrimitiveTypeName(type)).c_str());
-
-                            CreatePopulateMultidimensionalArray(dimensions, lens, nullptr, type, base_arr_v);
+                            base_type = GetVariableTypeByDescriptor(base_type_name);
+                            JAVM_LOG("[multianewarray] Primitive type name: '%s'", str::ToUtf8(GetPrimitiveTypeName(base_type)).c_str());
                         }
                         else {
                             JAVM_LOG("[multianewarray] Full array type name: '%s'", str::ToUtf8(class_name).c_str());
                             JAVM_LOG("[multianewarray] Class name: '%s'", str::ToUtf8(base_type_name).c_str());
-                            auto class_type = rt::LocateClassType(base_type_name);
-                            if(class_type) {
-                                const auto res = class_type->EnsureStaticInitializerCalled();
-                                if(res.IsInvalidOrThrown()) {
-                                    return res;
-                                }
-
-                                CreatePopulateMultidimensionalArray(dimensions, lens, class_type, VariableType::Invalid, base_arr_v);
-                            }
-                            else {
+                            class_type = rt::LocateClassType(base_type_name);
+                            if(!class_type) {
                                 return ThrowInternal(u"Invalid array class type...");
                             }
+                            const auto res = class_type->EnsureStaticInitializerCalled();
+                            if(res.IsInvalidOrThrown()) {
+                                return res;
+                            }
+                        }
+
+                        const auto type_dimensions = std::max(static_cast<u32>(class_name.find_first_not_of(u'[')), static_cast<u32>(dimensions));
+                        if(!EnsureHeapSpace(GetMultidimensionalArraySize(lens, type_dimensions, base_type))) {
+                            return ThrowOutOfMemory();
                         }
+                        auto base_arr_v = NewMultidimensionalArray(lens, type_dimensions, class_type, base_type);
 
                         JAVM_LOG("[multianewarray] Created multi array! '%s'", str::ToUtf8(FormatVariableType(base_arr_v)).c_str());
                         frame.PushStack(base_arr_v);
@@ -1694,6 +1758,11 @@ namespace javm::vm {
             }
             auto cur_accessor = GetCurrentThread();
 
+            // Safepoints are polled on calls and on back-edges, so every loop eventually reaches one
+            if(cur_accessor) {
+                cur_accessor->PollSafepoint();
+            }
+
             while(true) {
                 const auto orig_code_offset = frame.GetCodeOffset();
                 if(cur_accessor) {
@@ -1701,6 +1770,9 @@ namespace javm::vm {
                 }
 
                 const auto res = HandleInstruction(frame);
+                if(cur_accessor && (frame.GetCodeOffset() <= orig_code_offset)) {
+                    cur_accessor->PollSafepoint();
+                }
                 if(res.Is<ExecutionStatus::Thrown>()) {
                     auto throwable_v = res.var;
                     auto throwable_obj = throwable_v->GetAs<type::ClassInstance>();
@@ -1710,31 +1782,26 @@ namespace javm::vm {
 
                         auto &const_pool = frame.GetThisConstantPool();
                         for(const auto &active_exc: frame.GetAvailableExceptionTableEntries(orig_code_offset)) {
-                            String class_name;
-                            if(active_exc.catch_exc_type_index == 0) {
-                                // Catch any exception
-                                class_name = u"java/lang/Throwable";
-                            }
-                            else {
+                            // Catch-all entries (finally blocks) match any exception
+                            auto catches = true;
+                            if(active_exc.catch_exc_type_index != 0) {
                                 auto const_class_item = const_pool.GetItemAt(active_exc.catch_exc_type_index, ConstantPoolTag::Class);
-                                if(const_class_item) {
-                                    const auto const_class_data = const_class_item->GetClassData();
-                                    class_name = const_class_data.processed_name;
+                                if(!const_class_item) {
+                                    return ThrowInternal(u"Invalid constant pool item CATCH");
                                 }
+                                JAVM_LOG("[VM-THROW] Exception table entry class name: '%s'", str::ToUtf8(const_class_item->GetClassData().processed_name).c_str());
+                                catches = IsSubtypeOfClassConstant(*const_class_item, throwable_obj->GetClassType());
                             }
 
-                            if(!class_name.empty()) {
-                                JAVM_LOG("[VM-THROW] Exception table entry class name: '%s'", str::ToUtf8(class_name).c_str());
-                                if(throwable_obj->GetClassType()->CanCastTo(class_name)) {
-                                    JAVM_LOG("[VM-THROW] Jumping to exception table entry...");
-                                    auto &cur_offset = frame.GetCodeOffset();
-                                    cur_offset = active_exc.handler_code_offset;
-                                    frame.PushStack(throwable_v);
-                                    handled_throwable = true;
-                                }
-                            }
-                            else {
-                                return ThrowInternal(u"Invalid constant pool item CATCH");
+                            if(catches) {
+                                JAVM_LOG("[VM-THROW] Jumping to exception table entry...");
+                                auto &cur_offset = frame.GetCodeOffset();
+                                cur_offset = active_exc.handler_code_offset;
+                                // Handlers start with just the throwable in the operand stack, and the first matching one is the one taken
+                                frame.ClearStack();
+                                frame.PushStack(throwable_v);
+                                handled_throwable = true;
+                                break;
                             }
                         }
 
@@ -1761,7 +1828,7 @@ namespace javm::vm {
             }
         }
 
-        inline void DoSetLocalParameters(ExecutionFrame &frame, const std::vector<Ptr<Variable>> &param_vars, const u32 i_base) {
+        inline void DoSetLocalParameters(ExecutionFrame &frame, const VariableSpan &param_vars, const u32 i_base) {
             auto i = i_base;
             for(const auto &param: param_vars) {
                 frame.SetLocalAt(i, param);
@@ -1772,41 +1839,36 @@ namespace javm::vm {
             }
         }
         
-        inline void SetLocalStaticParameters(ExecutionFrame &frame, const std::vector<Ptr<Variable>> &param_vars) {
+        inline void SetLocalStaticParameters(ExecutionFrame &frame, const VariableSpan &param_vars) {
             DoSetLocalParameters(frame, param_vars, 0);
         }
 
-        inline void SetLocalParameters(ExecutionFrame &frame, Ptr<Variable> this_var, const std::vector<Ptr<Variable>> &param_vars) {
+        inline void SetLocalParameters(ExecutionFrame &frame, Ptr<Variable> this_var, const VariableSpan &param_vars) {
             frame.SetLocalAt(0, this_var);
             DoSetLocalParameters(frame, param_vars, 1);
         }
 
-    }
-
-    ExecutionResult ExecuteStaticCode(const u8 *code_ptr, const u16 max_locals, const std::vector<ExceptionTableEntry> &exc_table, ConstantPool &pool, const std::vector<Ptr<Variable>> &param_vars) {
-        auto max_locals_val = max_locals;
-        for(const auto &param: param_vars) {
-            // Longs and doubles take extra spaces
-            if(param->IsBigComputationalType()) {
-                max_locals_val++;
+        inline u32 GetLocalsCount(const u16 max_locals, const VariableSpan &param_vars) {
+            u32 locals_count = max_locals;
+            for(const auto &param: param_vars) {
+                // Longs and doubles take extra spaces
+                if(param->IsBigComputationalType()) {
+                    locals_count++;
+                }
             }
+            return locals_count;
         }
 
-        ExecutionFrame frame(code_ptr, max_locals_val, exc_table, pool);
+    }
+
+    ExecutionResult ExecuteStaticCode(const u8 *code_ptr, const u16 max_locals, const u16 max_stack, const std::vector<ExceptionTableEntry> &exc_table, ConstantPool &pool, const VariableSpan &param_vars) {
+        ExecutionFrame frame(code_ptr, GetLocalsCount(max_locals, param_vars), max_stack, exc_table, pool);
         SetLocalStaticParameters(frame, param_vars);
         return DoExecuteCode(frame);
     }
 
-    ExecutionResult ExecuteCode(const u8 *code_ptr, const u16 max_locals, const std::vector<ExceptionTableEntry> &exc_table, Ptr<Variable> this_var, ConstantPool &pool, const std::vector<Ptr<Variable>> &param_vars) {
-        auto max_locals_val = max_locals;
-        for(const auto &param: param_vars) {
-            // Longs and doubles take extra spaces
-            if(param->IsBigComputationalType()) {
-                max_locals_val++;
-            }
-        }
-
-        ExecutionFrame frame(code_ptr, max_locals_val, exc_table, pool, this_var);
+    ExecutionResult ExecuteCode(const u8 *code_ptr, const u16 max_locals, const u16 max_stack, const std::vector<ExceptionTableEntry> &exc_table, Ptr<Variable> this_var, ConstantPool &pool, const VariableSpan &param_vars) {
+        ExecutionFrame frame(code_ptr, GetLocalsCount(max_locals, param_vars) + 1, max_stack, exc_table, pool);
         SetLocalParameters(frame, this_var, param_vars);
         return DoExecuteCode(frame);
     }
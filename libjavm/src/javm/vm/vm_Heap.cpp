@@ -0,0 +1,994 @@
+#include <javm/javm_VM.hpp>
+#include <unordered_map>
+#include <chrono>
+
+namespace javm::vm {
+
+    namespace {
+
+        // Backup cycle collection by trial deletion: every Java reference is a shared pointer, so reference counting frees everything except cycles
+        // A node (variable or object) whose reference count is higher than the references other heap nodes hold to it is referenced from outside
+        // the heap (frames, statics, interned strings, native code...) and is therefore a root. Whatever can't be reached from a root is garbage
+        // only kept alive by cycles.
+        // The graph only holds weak references, so that it doesn't change the counts it inspects
+
+        enum class NodeKind : u8 {
+            Variable,
+            ClassInstance,
+            Array
+        };
+
+        struct HeapNode {
+            std::weak_ptr<void> ref;
+            NodeKind kind;
+            u32 internal_ref_count;
+            // Set by (maybe several) marker threads
+            std::atomic_bool reachable;
+            // Referent slot of a discovered java.lang.ref.Reference, which marking doesn't go through
+            VariableSlot *weak_slot;
+        };
+
+        using NodeTable = std::unordered_map<void*, HeapNode>;
+
+        template<typename T>
+        inline constexpr NodeKind GetNodeKind() {
+            if constexpr(std::is_same_v<T, Variable>) {
+                return NodeKind::Variable;
+            }
+            else if constexpr(std::is_same_v<T, ClassInstance>) {
+                return NodeKind::ClassInstance;
+            }
+            else {
+                return NodeKind::Array;
+            }
+        }
+
+        // Parallel marking only pays off for big graphs
+        constexpr size_t ParallelMarkMinNodeCount = 0x10000;
+
+        // Rounds of SATB log draining done concurrently before stopping the world for the final remark
+        constexpr u32 ConcurrentLogDrainRoundCount = 4;
+
+        // Attempts at stopping the world for the final remark (each one waiting up to Heap::SafepointTimeoutMs) before abandoning a concurrent cycle
+        constexpr u32 RemarkAttemptCount = 100;
+
+        // Children are either variable slots (fields, array elements) or references which never change once set (a variable's object, an instance's parts)
+        // Slots are read directly while the world is stopped
+
+        inline Ptr<Variable> &GetChildRef(VariableSlot &slot) {
+            return slot.var;
+        }
+
+        template<typename T>
+        inline Ptr<T> &GetChildRef(Ptr<T> &child_ref) {
+            return child_ref;
+        }
+
+        // While marking concurrently, mutators might be swapping the very slots being visited (see StoreHeapSlot)
+        // The returned key is only used to look up nodes, so it doesn't matter if it dies right after
+        inline void *LoadChildKey(VariableSlot &slot, const bool concurrent) {
+            if(concurrent) {
+                return static_cast<void*>(slot.Load().get());
+            }
+            return static_cast<void*>(slot.var.get());
+        }
+
+        template<typename T>
+        inline void *LoadChildKey(Ptr<T> &child_ref, const bool) {
+            return static_cast<void*>(child_ref.get());
+        }
+
+        // Primitive values and primitive arrays can't be part of a cycle, so they are left out of the graph
+        template<typename T>
+        inline bool CanBeInCycle(const Ptr<T> &ref) {
+            if constexpr(std::is_same_v<T, Variable>) {
+                const auto type = ref->GetType();
+                return (type == VariableType::ClassInstance) || (type == VariableType::Array);
+            }
+            else if constexpr(std::is_same_v<T, Array>) {
+                return !ref->IsPrimitiveArray();
+            }
+            else {
+                return true;
+            }
+        }
+
+        // Nodes are keyed by their raw pointer, which is only valid while they are alive
+        // With the world stopped nothing can die meanwhile, otherwise the node must be locked first (see LockNode)
+        template<typename Fn>
+        void VisitChildren(void *key, HeapNode &node, Fn fn) {
+            switch(node.kind) {
+                case NodeKind::Variable: {
+                    auto var = static_cast<Variable*>(key);
+                    var->VisitObjectReference(fn);
+                    break;
+                }
+                case NodeKind::ClassInstance: {
+                    auto obj = static_cast<ClassInstance*>(key);
+                    obj->VisitReferences(fn, fn);
+                    break;
+                }
+                case NodeKind::Array: {
+                    auto arr = static_cast<Array*>(key);
+                    arr->VisitReferences(fn, fn);
+                    break;
+                }
+            }
+        }
+
+        // Keeps a node alive while marking concurrently, returns whether it's still alive
+        inline bool LockNode(HeapNode &node, const bool concurrent, std::shared_ptr<void> &out_ref) {
+            if(concurrent) {
+                out_ref = node.ref.lock();
+                return static_cast<bool>(out_ref);
+            }
+            return true;
+        }
+
+        template<typename Fn>
+        void VisitStrongChildren(void *key, HeapNode &node, Fn fn) {
+            if(node.weak_slot == nullptr) {
+                VisitChildren(key, node, fn);
+                return;
+            }
+
+            VisitChildren(key, node, [&](auto &child_ref) {
+                if(static_cast<void*>(&child_ref) != static_cast<void*>(node.weak_slot)) {
+                    fn(child_ref);
+                }
+            });
+        }
+
+        // java.lang.ref support: references which aren't strong (final references are, since finalization isn't supported)
+
+        enum class ReferenceKind : u8 {
+            None,
+            Soft,
+            Weak,
+            Phantom
+        };
+
+        struct DiscoveredReference {
+            // The reference object itself and its java.lang.ref.Reference part, holding the fields below
+            void *obj_key;
+            ClassInstance *base;
+            ClassField *referent_field;
+            ClassField *next_field;
+            ReferenceKind kind;
+        };
+
+        inline ClassField *FindMemberField(ClassInstance *obj, const String &name, const String &descriptor) {
+            return obj->GetFieldByUnsafeOffset(obj->GetClassType()->GetRawFieldUnsafeOffset(name, descriptor));
+        }
+
+        inline bool IsNullSlot(ClassField *field) {
+            if(field == nullptr) {
+                return true;
+            }
+
+            auto &slot = field->GetVariableSlot();
+            return !slot.var || slot.var->IsNull();
+        }
+
+        ClassInstance *FindInstancePart(ClassInstance *obj, const String &class_name) {
+            while(obj != nullptr) {
+                if(EqualClassNames(obj->GetClassType()->GetClassName(), class_name)) {
+                    return obj;
+                }
+                obj = obj->GetSuperClassInstance().get();
+            }
+            return nullptr;
+        }
+
+        inline type::Long GetCurrentTimeMillis() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+    }
+
+    // Work-stealing marker: each worker pops from its own stack and steals half of another one's when empty
+    // The node table is no longer modified, so workers only race on the nodes' reachable flags (and on the slots mutators swap if marking concurrently)
+
+    class ParallelMarker {
+        private:
+            struct MarkStack {
+                Monitor lock;
+                std::vector<void*> items;
+            };
+
+            NodeTable &nodes;
+            bool concurrent;
+            std::vector<MarkStack> stacks;
+            std::atomic<u64> pending_count;
+            std::atomic<u32> next_worker_index;
+
+            inline void Push(MarkStack &stack, void *key) {
+                this->pending_count.fetch_add(1);
+                ScopedMonitorLock lk(stack.lock);
+                stack.items.push_back(key);
+            }
+
+            inline bool Pop(MarkStack &stack, void *&out_key) {
+                ScopedMonitorLock lk(stack.lock);
+                if(stack.items.empty()) {
+                    return false;
+                }
+                out_key = stack.items.back();
+                stack.items.pop_back();
+                return true;
+            }
+
+            bool Steal(const u32 index, void *&out_key) {
+                std::vector<void*> stolen;
+                for(u32 i = 1; i < this->stacks.size(); i++) {
+                    auto &victim = this->stacks[(index + i) % this->stacks.size()];
+                    ScopedMonitorLock lk(victim.lock);
+                    if(!victim.items.empty()) {
+                        const auto steal_count = (victim.items.size() + 1) / 2;
+                        stolen.assign(victim.items.begin(), victim.items.begin() + steal_count);
+                        victim.items.erase(victim.items.begin(), victim.items.begin() + steal_count);
+                        break;
+                    }
+                }
+                if(stolen.empty()) {
+                    return false;
+                }
+
+                out_key = stolen.back();
+                stolen.pop_back();
+                if(!stolen.empty()) {
+                    auto &own = this->stacks[index];
+                    ScopedMonitorLock lk(own.lock);
+                    own.items.insert(own.items.end(), stolen.begin(), stolen.end());
+                }
+                return true;
+            }
+
+        public:
+            ParallelMarker(NodeTable &nodes, const bool concurrent, const u32 worker_count) : nodes(nodes), concurrent(concurrent), stacks(worker_count), pending_count(0), next_worker_index(0) {}
+
+            void AddRoots(const std::vector<void*> &root_keys) {
+                for(size_t i = 0; i < root_keys.size(); i++) {
+                    this->Push(this->stacks[i % this->stacks.size()], root_keys[i]);
+                }
+            }
+
+            void RunWorker() {
+                const auto index = this->next_worker_index.fetch_add(1);
+                auto &own = this->stacks[index];
+
+                void *key;
+                while(true) {
+                    if(this->Pop(own, key) || this->Steal(index, key)) {
+                        auto &node = this->nodes.at(key);
+                        std::shared_ptr<void> node_ref;
+                        if(LockNode(node, this->concurrent, node_ref)) {
+                            VisitStrongChildren(key, node, [&](auto &child_ref) {
+                                auto child_key = LoadChildKey(child_ref, this->concurrent);
+                                if(child_key != nullptr) {
+                                    auto it = this->nodes.find(child_key);
+                                    if((it != this->nodes.end()) && !it->second.reachable.exchange(true)) {
+                                        this->Push(own, it->first);
+                                    }
+                                }
+                            });
+                        }
+                        this->pending_count.fetch_sub(1);
+                    }
+                    else if(this->pending_count.load() == 0) {
+                        // Nothing left anywhere, not even being processed (which could push more)
+                        break;
+                    }
+                    else {
+                        native::YieldCurrentThread();
+                    }
+                }
+            }
+    };
+
+    namespace {
+
+        void MarkerWorkerEntrypoint(void *thread_ptr) {
+            auto thread_ref = reinterpret_cast<native::Thread*>(thread_ptr);
+            thread_ref->GetInstance()->heap.GetActiveMarker()->RunWorker();
+        }
+
+        void ConcurrentCollectorEntrypoint(void *thread_ptr) {
+            auto thread_ref = reinterpret_cast<native::Thread*>(thread_ptr);
+            rt::EnterInstance(thread_ref->GetInstance());
+            rt::GetCurrentInstance().heap.RunConcurrentCycle();
+            rt::ExitInstance();
+        }
+
+    }
+
+    // Kept alive by the heap while a concurrent mark runs in the background
+
+    class CycleCollector {
+        private:
+            NodeTable nodes;
+            std::vector<void*> work_list;
+            bool concurrent;
+            type::Long soft_ref_max_age;
+            std::unordered_map<ClassType*, ReferenceKind> ref_kinds;
+            std::vector<DiscoveredReference> discovered_refs;
+            Ptr<ClassType> soft_ref_type;
+            type::Long soft_ref_clock;
+
+            // Whole objects (not their super class/interface parts) are checked for being references
+            template<typename T>
+            HeapNode &AddNode(const Ptr<T> &ref, const bool is_object) {
+                auto [it, inserted] = this->nodes.try_emplace(static_cast<void*>(ref.get()));
+                if(inserted) {
+                    it->second.ref = ref;
+                    it->second.kind = GetNodeKind<T>();
+                    it->second.internal_ref_count = 0;
+                    it->second.reachable = false;
+                    it->second.weak_slot = nullptr;
+                    this->work_list.push_back(it->first);
+                    if constexpr(std::is_same_v<T, ClassInstance>) {
+                        if(is_object) {
+                            this->DiscoverReference(ref.get());
+                        }
+                    }
+                }
+                return it->second;
+            }
+
+            ReferenceKind GetReferenceKind(ClassType *type) {
+                auto it = this->ref_kinds.find(type);
+                if(it != this->ref_kinds.end()) {
+                    return it->second;
+                }
+
+                auto kind = ReferenceKind::None;
+                auto cur_type = type->FindSelf();
+                while(cur_type) {
+                    const auto class_name = cur_type->GetClassName();
+                    if(EqualClassNames(class_name, u"java/lang/ref/SoftReference")) {
+                        kind = ReferenceKind::Soft;
+                        break;
+                    }
+                    else if(EqualClassNames(class_name, u"java/lang/ref/WeakReference")) {
+                        kind = ReferenceKind::Weak;
+                        break;
+                    }
+                    else if(EqualClassNames(class_name, u"java/lang/ref/PhantomReference")) {
+                        kind = ReferenceKind::Phantom;
+                        break;
+                    }
+                    else if(EqualClassNames(class_name, u"java/lang/ref/Reference") || EqualClassNames(class_name, u"java/lang/ref/FinalReference")) {
+                        break;
+                    }
+                    cur_type = cur_type->HasSuperClass() ? cur_type->GetSuperClassType() : nullptr;
+                }
+
+                this->ref_kinds.emplace(type, kind);
+                return kind;
+            }
+
+            // Like HotSpot's LRU policy: soft references are cleared once they haven't been used (see SoftReference.get) for long enough
+            bool ShouldClearSoftReference(ClassInstance *obj) {
+                auto soft_part = FindInstancePart(obj, u"java/lang/ref/SoftReference");
+                if(soft_part == nullptr) {
+                    return false;
+                }
+
+                if(!this->soft_ref_type) {
+                    // The clock is updated after every collection (see Heap::EnqueuePendingReferences)
+                    this->soft_ref_type = soft_part->GetClassType();
+                    auto clock_v = this->soft_ref_type->GetStaticField(u"clock", u"J");
+                    this->soft_ref_clock = clock_v ? clock_v->GetValue<type::Long>() : 0;
+                }
+                if(this->soft_ref_max_age < 0) {
+                    return false;
+                }
+
+                auto timestamp_field = FindMemberField(soft_part, u"timestamp", u"J");
+                const auto timestamp = IsNullSlot(timestamp_field) ? 0 : timestamp_field->GetVariableSlot().var->GetValue<type::Long>();
+                return (this->soft_ref_clock - timestamp) >= this->soft_ref_max_age;
+            }
+
+            void DiscoverReference(ClassInstance *obj) {
+                const auto kind = this->GetReferenceKind(obj->GetClassType().get());
+                if(kind == ReferenceKind::None) {
+                    return;
+                }
+
+                auto base = FindInstancePart(obj, u"java/lang/ref/Reference");
+                if(base == nullptr) {
+                    return;
+                }
+                auto referent_field = FindMemberField(base, u"referent", u"Ljava/lang/Object;");
+                auto next_field = FindMemberField(base, u"next", u"Ljava/lang/ref/Reference;");
+                // Only active references (not cleared, not pending nor enqueued yet) are discovered
+                if(IsNullSlot(referent_field) || (next_field == nullptr) || !IsNullSlot(next_field)) {
+                    return;
+                }
+                // Soft references which are kept are just strong ones
+                if((kind == ReferenceKind::Soft) && !this->ShouldClearSoftReference(obj)) {
+                    return;
+                }
+
+                this->discovered_refs.push_back({ static_cast<void*>(obj), base, referent_field, next_field, kind });
+            }
+
+        public:
+            CycleCollector(const bool concurrent, const type::Long soft_ref_max_age) : concurrent(concurrent), soft_ref_max_age(soft_ref_max_age), soft_ref_clock(0) {}
+
+            inline Ptr<ClassType> GetSoftReferenceType() {
+                return this->soft_ref_type;
+            }
+
+            void AddSeed(const HeapEntry &entry) {
+                auto ref = entry.ref.lock();
+                if(ref) {
+                    if(entry.is_array) {
+                        auto arr = std::static_pointer_cast<Array>(ref);
+                        if(CanBeInCycle(arr)) {
+                            this->AddNode(arr, true);
+                        }
+                    }
+                    else {
+                        this->AddNode(std::static_pointer_cast<ClassInstance>(ref), true);
+                    }
+                }
+            }
+
+            void BuildGraph() {
+                while(!this->work_list.empty()) {
+                    auto key = this->work_list.back();
+                    this->work_list.pop_back();
+
+                    // Node references stay valid while the table grows
+                    // Objects are only referenced as a whole by variables, other objects reference their parts
+                    auto &node = this->nodes.at(key);
+                    const auto is_var = node.kind == NodeKind::Variable;
+                    VisitChildren(key, node, [&](auto &child) {
+                        auto &child_ref = GetChildRef(child);
+                        if(child_ref && CanBeInCycle(child_ref)) {
+                            auto &child_node = this->AddNode(child_ref, is_var);
+                            child_node.internal_ref_count++;
+                        }
+                    });
+                }
+
+                // Referents still count as internal references (they aren't roots because of them), they just aren't marked through
+                for(const auto &ref: this->discovered_refs) {
+                    auto it = this->nodes.find(static_cast<void*>(ref.base));
+                    if(it != this->nodes.end()) {
+                        it->second.weak_slot = &ref.referent_field->GetVariableSlot();
+                    }
+                }
+            }
+
+            // Needs the world to be stopped, like BuildGraph
+            // The seeds' temporary references (see AddSeed) are gone by now, so the counts only hold heap and external references
+            void FindRoots() {
+                for(auto &[key, node] : this->nodes) {
+                    const auto external_ref_count = node.ref.use_count() - static_cast<long>(node.internal_ref_count);
+                    if(external_ref_count > 0) {
+                        node.reachable = true;
+                        this->work_list.push_back(key);
+                    }
+                }
+            }
+
+            void Mark(Heap &heap) {
+                const auto worker_count = heap.GetMarkerWorkerCount();
+                if((worker_count > 1) && (this->nodes.size() >= ParallelMarkMinNodeCount)) {
+                    this->MarkParallel(heap, worker_count);
+                    return;
+                }
+
+                while(!this->work_list.empty()) {
+                    auto key = this->work_list.back();
+                    this->work_list.pop_back();
+
+                    auto &node = this->nodes.at(key);
+                    std::shared_ptr<void> node_ref;
+                    if(!LockNode(node, this->concurrent, node_ref)) {
+                        continue;
+                    }
+                    VisitStrongChildren(key, node, [&](auto &child_ref) {
+                        auto child_key = LoadChildKey(child_ref, this->concurrent);
+                        if(child_key != nullptr) {
+                            auto it = this->nodes.find(child_key);
+                            if((it != this->nodes.end()) && !it->second.reachable) {
+                                it->second.reachable = true;
+                                this->work_list.push_back(it->first);
+                            }
+                        }
+                    });
+                }
+            }
+
+            void MarkParallel(Heap &heap, const u32 worker_count) {
+                ParallelMarker marker(this->nodes, this->concurrent, worker_count);
+                marker.AddRoots(this->work_list);
+                this->work_list.clear();
+
+                // The collecting thread is worker 0, the rest get their own threads
+                std::vector<Ptr<native::Thread>> workers;
+                heap.SetActiveMarker(&marker);
+                for(u32 i = 1; i < worker_count; i++) {
+                    auto worker = native::CreateThread();
+                    worker->SetInstance(rt::GetCurrentInstancePtr());
+                    worker->Start(&MarkerWorkerEntrypoint);
+                    workers.push_back(worker);
+                }
+                marker.RunWorker();
+                for(auto &worker: workers) {
+                    worker->Join();
+                }
+                heap.SetActiveMarker(nullptr);
+            }
+
+            // Values the mutators overwrote (see StoreHeapSlot) were reachable when marking started, so they (and whatever they reach) must be kept
+            // Returns whether anything had been logged
+            bool MarkLogged(Heap &heap, const std::vector<void*> &logged_keys) {
+                for(const auto key: logged_keys) {
+                    auto it = this->nodes.find(key);
+                    if((it != this->nodes.end()) && !it->second.reachable) {
+                        it->second.reachable = true;
+                        this->work_list.push_back(key);
+                    }
+                }
+                this->Mark(heap);
+                return !logged_keys.empty();
+            }
+
+            // Needs the world to be stopped, after marking is done
+            // Clears the references whose referents weren't marked, returning the ones to enqueue (as variables)
+            std::vector<Ptr<Variable>> ProcessReferences() {
+                std::vector<Ptr<Variable>> pending_refs;
+                for(const auto &ref: this->discovered_refs) {
+                    // Unreachable references are garbage themselves, and reachable ones might have died while marking concurrently
+                    auto &obj_node = this->nodes.at(ref.obj_key);
+                    if(!obj_node.reachable) {
+                        continue;
+                    }
+                    auto obj_ref = obj_node.ref.lock();
+                    if(!obj_ref || IsNullSlot(ref.referent_field) || !IsNullSlot(ref.next_field)) {
+                        continue;
+                    }
+
+                    void *referent_key = nullptr;
+                    auto &referent_slot = ref.referent_field->GetVariableSlot();
+                    referent_slot.var->VisitObjectReference([&](auto &obj_ref) {
+                        referent_key = static_cast<void*>(obj_ref.get());
+                    });
+                    // Referents outside the graph (not registered yet, or allocated during a concurrent mark) aren't collected by this cycle
+                    auto it = this->nodes.find(referent_key);
+                    if((it == this->nodes.end()) || it->second.reachable) {
+                        continue;
+                    }
+
+                    // Like Java 8, phantom referents are kept until the reference gets cleared or collected
+                    if(ref.kind != ReferenceKind::Phantom) {
+                        StoreHeapSlot(referent_slot, MakeNull());
+                    }
+
+                    // Pending references point to themselves (see java.lang.ref.Reference)
+                    auto ref_v = ptr::New<Variable>(std::static_pointer_cast<ClassInstance>(obj_ref));
+                    ref.next_field->SetVariable(ref_v);
+                    pending_refs.push_back(ref_v);
+                }
+
+                this->discovered_refs.clear();
+                return pending_refs;
+            }
+
+            u64 BreakUnreachableCycles() {
+                // Every cycle goes through an object, so clearing unreachable objects' references is enough
+                // Clearing one might free others right away, which are then skipped
+                u64 collected_count = 0;
+                for(auto &[key, node] : this->nodes) {
+                    if(!node.reachable && (node.kind != NodeKind::Variable)) {
+                        auto ref = node.ref.lock();
+                        if(!ref) {
+                            continue;
+                        }
+                        if(node.kind == NodeKind::ClassInstance) {
+                            static_cast<ClassInstance*>(ref.get())->ClearReferences();
+                        }
+                        else {
+                            static_cast<Array*>(ref.get())->ClearReferences();
+                        }
+                        collected_count++;
+                    }
+                }
+
+                this->nodes.clear();
+                return collected_count;
+            }
+    };
+
+    namespace {
+
+        // Per-thread registration buffer: registering an allocation is just an append, the heap lock is only taken once it fills up
+
+        constexpr size_t ThreadHeapBufferCapacity = 0x100;
+
+        thread_local std::vector<HeapEntry> g_ThreadHeapBuffer;
+        // Bytes recorded in the buffer, not yet accounted by the heap
+        thread_local u64 g_ThreadHeapBufferSize = 0;
+
+        // Returns the size of the pruned entries
+        inline u64 PruneExpired(std::vector<HeapEntry> &entries) {
+            u64 pruned_size = 0;
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const HeapEntry &entry) -> bool {
+                if(entry.ref.expired()) {
+                    pruned_size += entry.size;
+                    return true;
+                }
+                return false;
+            }), entries.end());
+            return pruned_size;
+        }
+
+        inline bool FlushThreadHeapBufferInto(Heap &heap) {
+            g_ThreadHeapBufferSize = 0;
+            return heap.AddEntries(g_ThreadHeapBuffer);
+        }
+
+        void RecordAllocation(HeapEntry &&entry) {
+            g_ThreadHeapBufferSize += entry.size;
+            g_ThreadHeapBuffer.push_back(std::move(entry));
+            if(g_ThreadHeapBuffer.size() >= ThreadHeapBufferCapacity) {
+                auto &heap = rt::GetCurrentInstance().heap;
+                if(FlushThreadHeapBufferInto(heap)) {
+                    heap.Collect();
+                }
+            }
+        }
+
+    }
+
+    bool Heap::AddEntries(std::vector<HeapEntry> &thread_entries) {
+        ScopedMonitorLock lk(this->lock);
+
+        u64 entries_size = 0;
+        for(const auto &entry: thread_entries) {
+            entries_size += entry.size;
+        }
+        this->used_size.fetch_add(entries_size, std::memory_order_relaxed);
+        this->entries.insert(this->entries.end(), std::make_move_iterator(thread_entries.begin()), std::make_move_iterator(thread_entries.end()));
+        thread_entries.clear();
+        return this->entries.size() >= this->collection_threshold;
+    }
+
+    void Heap::PruneExpiredEntries() {
+        const auto pruned_size = PruneExpired(this->entries);
+        this->used_size.fetch_sub(pruned_size, std::memory_order_relaxed);
+    }
+
+    bool Heap::DoCollect(const bool concurrent, const bool clear_soft_refs) {
+        if(&rt::GetCurrentInstance().heap == this) {
+            FlushThreadHeapBufferInto(*this);
+        }
+
+        // A single collection at a time: allocations don't wait for (nor retry during) a concurrent one
+        if(this->collecting.exchange(true)) {
+            return false;
+        }
+        // The previous concurrent collection (if any) is done, but its thread still needs to be joined
+        this->JoinConcurrentCycle();
+
+        // Expired entries still hold their (already destroyed) object's memory, so prune them even if we can't collect right now
+        {
+            ScopedMonitorLock lk(this->lock);
+            this->PruneExpiredEntries();
+        }
+
+        // Reference counts (which tell roots apart) are only consistent while no other thread runs Java code
+        if(!StopOtherThreads(SafepointTimeoutMs)) {
+            // Don't retry on every registration buffer flush
+            {
+                ScopedMonitorLock lk(this->lock);
+                this->collection_threshold *= 2;
+            }
+            this->collecting.store(false);
+            return false;
+        }
+
+        auto collector = ptr::New<CycleCollector>(concurrent, this->GetSoftReferenceMaxAge(clear_soft_refs));
+        {
+            ScopedMonitorLock lk(this->lock);
+            for(const auto &entry: this->entries) {
+                collector->AddSeed(entry);
+            }
+        }
+
+        collector->BuildGraph();
+        collector->FindRoots();
+
+        if(concurrent) {
+            // From now on the mutators log every reference they overwrite, so whatever is reachable right now will get marked
+            // Objects allocated meanwhile aren't part of the graph, thus they are never collected by this cycle
+            // Leftovers from an abandoned cycle (see RunConcurrentCycle) are dropped first
+            this->TakeSATBLog();
+            this->satb_active.store(true);
+            this->concurrent_collector = collector;
+            ResumeOtherThreads();
+
+            auto thread = native::CreateThread();
+            thread->SetInstance(rt::GetCurrentInstancePtr());
+            {
+                ScopedMonitorLock lk(this->lock);
+                this->concurrent_thread = thread;
+            }
+            thread->Start(&ConcurrentCollectorEntrypoint);
+            return true;
+        }
+
+        collector->Mark(*this);
+        auto pending_refs = collector->ProcessReferences();
+        const auto collected_count = collector->BreakUnreachableCycles();
+        ResumeOtherThreads();
+
+        this->EnqueuePendingReferences(*collector, pending_refs);
+        this->FinishCollection(collected_count);
+        this->collecting.store(false);
+        return true;
+    }
+
+    void Heap::RunConcurrentCycle() {
+        auto collector = this->concurrent_collector;
+        collector->Mark(*this);
+
+        // Drain most of what was logged meanwhile before stopping the world, so that the final pause stays short
+        for(u32 i = 0; i < ConcurrentLogDrainRoundCount; i++) {
+            if(!collector->MarkLogged(*this, this->TakeSATBLog())) {
+                break;
+            }
+        }
+
+        // Final remark: with every mutator stopped, nothing else can get logged
+        // Keep marking whatever gets logged until the world can be stopped, but give up on the whole cycle (collecting nothing) if it never can
+        auto stopped = false;
+        for(u32 i = 0; i < RemarkAttemptCount; i++) {
+            if(StopOtherThreads(SafepointTimeoutMs)) {
+                stopped = true;
+                break;
+            }
+            collector->MarkLogged(*this, this->TakeSATBLog());
+        }
+        if(!stopped) {
+            // Whatever still gets logged is dropped when the next concurrent cycle starts
+            this->satb_active.store(false);
+            this->concurrent_collector = nullptr;
+            {
+                ScopedMonitorLock lk(this->lock);
+                this->PruneExpiredEntries();
+                // Don't retry on every registration buffer flush
+                this->collection_threshold *= 2;
+            }
+            this->collecting.store(false);
+            return;
+        }
+        collector->MarkLogged(*this, this->TakeSATBLog());
+        this->satb_active.store(false);
+        // Referents must be cleared before anyone can load them again (see Reference.get)
+        auto pending_refs = collector->ProcessReferences();
+        // Unreachable objects might still be revived through weak holders outside the graph (interned strings, JNI weak globals...), so cycles are broken before anyone can
+        const auto collected_count = collector->BreakUnreachableCycles();
+        ResumeOtherThreads();
+
+        this->concurrent_collector = nullptr;
+        this->EnqueuePendingReferences(*collector, pending_refs);
+        this->FinishCollection(collected_count);
+        this->collecting.store(false);
+    }
+
+    type::Long Heap::GetSoftReferenceMaxAge(const bool clear_soft_refs) {
+        if(clear_soft_refs) {
+            return 0;
+        }
+        // Without a limit there's no memory pressure, thus soft references are only cleared before throwing OutOfMemoryError
+        if(this->max_size == 0) {
+            return -1;
+        }
+
+        const auto used_size = this->GetUsedSize();
+        const auto free_size = (used_size < this->max_size) ? (this->max_size - used_size) : 0;
+        return static_cast<type::Long>(free_size / 0x100000) * SoftReferenceMsPerFreeMB;
+    }
+
+    void Heap::EnqueuePendingReferences(CycleCollector &collector, std::vector<Ptr<Variable>> &pending_refs) {
+        auto soft_ref_type = collector.GetSoftReferenceType();
+        if(soft_ref_type) {
+            soft_ref_type->SetStaticField(u"clock", u"J", NewPrimitiveVariable<type::Long>(GetCurrentTimeMillis()));
+        }
+        if(pending_refs.empty()) {
+            return;
+        }
+
+        // The Reference Handler thread (started by java.lang.ref.Reference) takes them from the pending list and enqueues them in their queues
+        // This needs the Java lock, so the world can't be stopped here
+        auto ref_type = rt::LocateClassType(u"java/lang/ref/Reference");
+        auto lock_v = ref_type ? ref_type->GetStaticField(u"lock", u"Ljava/lang/ref/Reference$Lock;") : nullptr;
+        auto lock = lock_v ? GetObjectLock(lock_v) : nullptr;
+        if(lock == nullptr) {
+            return;
+        }
+
+        EnterObjectLock(*lock);
+        auto pending_v = ref_type->GetStaticField(u"pending", u"Ljava/lang/ref/Reference;");
+        for(auto &ref_v: pending_refs) {
+            auto ref_obj = ref_v->GetAs<type::ClassInstance>();
+            ref_obj->SetField(u"discovered", u"Ljava/lang/ref/Reference;", pending_v);
+            pending_v = ref_v;
+        }
+        ref_type->SetStaticField(u"pending", u"Ljava/lang/ref/Reference;", pending_v);
+        lock->NotifyAll();
+        lock->Leave();
+    }
+
+    void Heap::FinishCollection(const u64 collected_count) {
+        ScopedMonitorLock lk(this->lock);
+        this->PruneExpiredEntries();
+
+        this->collection_count++;
+        this->collected_object_count += collected_count;
+        // Collect again once the heap has doubled
+        this->collection_threshold = std::max(MinCollectionThreshold, static_cast<u64>(this->entries.size() * 2));
+    }
+
+    void Heap::JoinConcurrentCycle() {
+        Ptr<native::Thread> thread;
+        {
+            ScopedMonitorLock lk(this->lock);
+            thread = this->concurrent_thread;
+            this->concurrent_thread = nullptr;
+        }
+
+        if(thread) {
+            // The background collector stops the world before finishing, which we must not hold back
+            ScopedBlockedState blocked(GetCurrentThread());
+            thread->Join();
+        }
+    }
+
+    std::vector<void*> Heap::TakeSATBLog() {
+        ScopedMonitorLock lk(this->satb_lock);
+
+        std::vector<void*> logged_keys;
+        logged_keys.swap(this->satb_log);
+        return logged_keys;
+    }
+
+    void Heap::LogOverwrittenReference(const Ptr<Variable> &old_var) {
+        // The variable might not be part of the graph while the object it references is
+        ScopedMonitorLock lk(this->satb_lock);
+        this->satb_log.push_back(old_var.get());
+        old_var->VisitObjectReference([&](auto &obj_ref) {
+            if(obj_ref) {
+                this->satb_log.push_back(static_cast<void*>(obj_ref.get()));
+            }
+        });
+    }
+
+    bool Heap::Collect() {
+        return this->DoCollect(this->concurrent_mark, false);
+    }
+
+    bool Heap::CollectBlocking(const bool clear_soft_refs) {
+        this->JoinConcurrentCycle();
+        return this->DoCollect(false, clear_soft_refs);
+    }
+
+    void Heap::Reset() {
+        this->JoinConcurrentCycle();
+        ScopedMonitorLock lk(this->lock);
+
+        this->entries.clear();
+        this->used_size.store(0);
+        this->metadata_size.store(0);
+        this->collection_threshold = MinCollectionThreshold;
+    }
+
+    bool Heap::EnsureAvailable(const u64 size) {
+        if(this->max_size == 0) {
+            return true;
+        }
+
+        // Written this way to avoid overflowing with huge sizes
+        const auto fits = [&](const u64 pending_size) -> bool {
+            const auto used_size = this->GetUsedSize();
+            return (used_size <= this->max_size) && (pending_size <= (this->max_size - used_size)) && (size <= (this->max_size - used_size - pending_size));
+        };
+        const auto pending_size = (&rt::GetCurrentInstance().heap == this) ? g_ThreadHeapBufferSize : 0;
+        if(fits(pending_size)) {
+            return true;
+        }
+
+        // Objects already freed by reference counting still count until their entries are pruned
+        if(pending_size > 0) {
+            FlushThreadHeapBufferInto(*this);
+        }
+        {
+            ScopedMonitorLock lk(this->lock);
+            this->PruneExpiredEntries();
+        }
+        if(fits(0)) {
+            return true;
+        }
+
+        // Then, whatever is only kept alive by cycles
+        // The collection might be skipped (some thread can't be stopped in time, or a concurrent one is running), so try a few times
+        // Soft references are all cleared before giving up, like Java guarantees
+        for(u32 i = 0; i < OutOfMemoryCollectionAttemptCount; i++) {
+            if(this->CollectBlocking(i > 0) && fits(0)) {
+                return true;
+            }
+        }
+        return fits(0);
+    }
+
+    u64 Heap::GetObjectCount() {
+        if(&rt::GetCurrentInstance().heap == this) {
+            FlushThreadHeapBufferInto(*this);
+        }
+
+        ScopedMonitorLock lk(this->lock);
+        this->PruneExpiredEntries();
+        return this->entries.size();
+    }
+
+    void RegisterHeapObject(Ptr<ClassInstance> obj) {
+        RecordAllocation({ obj, obj->GetClassType()->GetInstanceSize(), false });
+    }
+
+    void RegisterHeapObject(Ptr<Array> arr) {
+        RecordAllocation({ arr, arr->GetAllocationSize(), true });
+    }
+
+    void FlushThreadHeapBuffer() {
+        if(!g_ThreadHeapBuffer.empty()) {
+            FlushThreadHeapBufferInto(rt::GetCurrentInstance().heap);
+        }
+    }
+
+    void RegisterHeapMetadata(const u64 size) {
+        rt::GetCurrentInstance().heap.AddMetadataSize(size);
+    }
+
+    bool EnsureHeapSpace(const u64 size) {
+        return rt::GetCurrentInstance().heap.EnsureAvailable(size);
+    }
+
+    void VariableSlot::WaitUnlocked() {
+        // Slots are only locked for a copy or a swap, so the holder is rarely kept long (unless preempted)
+        while(__atomic_load_n(&this->lock_flag, __ATOMIC_RELAXED)) {
+            native::YieldCurrentThread();
+        }
+    }
+
+    void StoreHeapSlot(VariableSlot &slot, Ptr<Variable> var) {
+        auto &heap = rt::GetCurrentInstance().heap;
+        if(heap.IsSATBActive()) {
+            auto old_var = slot.Exchange(var);
+            if(old_var) {
+                heap.LogOverwrittenReference(old_var);
+            }
+        }
+        else {
+            slot.var = var;
+        }
+    }
+
+    void LogOverwrittenHeapSlot(const Ptr<Variable> &old_var) {
+        if(old_var) {
+            auto &heap = rt::GetCurrentInstance().heap;
+            if(heap.IsSATBActive()) {
+                heap.LogOverwrittenReference(old_var);
+            }
+        }
+    }
+
+    bool CollectGarbage() {
+        return rt::GetCurrentInstance().heap.CollectBlocking();
+    }
+
+}
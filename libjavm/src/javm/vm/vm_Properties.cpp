@@ -2,24 +2,19 @@
 
 namespace javm::vm {
 
-    namespace {
-
-        PropertyTable g_InitialSystemPropertyTable;
-
-    }
-
     PropertyTable &GetInitialSystemPropertyTable() {
-        return g_InitialSystemPropertyTable;
+        return rt::GetCurrentInstance().initial_system_props;
     }
 
     void SetInitialSystemProperty(const String &key, const String &value) {
         // Remove if already set, aka allow redefining initial properties
-        auto it = g_InitialSystemPropertyTable.find(key);
-        if(it != g_InitialSystemPropertyTable.end()) {
-            g_InitialSystemPropertyTable.erase(it);
+        auto &props = GetInitialSystemPropertyTable();
+        auto it = props.find(key);
+        if(it != props.end()) {
+            props.erase(it);
         }
 
-        g_InitialSystemPropertyTable.insert(std::make_pair(key, value));
+        props.insert(std::make_pair(key, value));
     }
 
 }
\ No newline at end of file
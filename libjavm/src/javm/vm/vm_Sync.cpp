@@ -0,0 +1,276 @@
+#include <javm/javm_VM.hpp>
+
+namespace javm::vm {
+
+    namespace {
+
+        std::atomic<u32> g_NextLockOwnerId(1);
+        thread_local u32 g_CurrentLockOwnerId = 0;
+
+        constexpr u32 MaxThinRecursionCount = 0x7FFFFFFF;
+
+    }
+
+    u32 GetCurrentLockOwnerId() {
+        if(g_CurrentLockOwnerId == 0) {
+            g_CurrentLockOwnerId = g_NextLockOwnerId.fetch_add(1, std::memory_order_relaxed);
+        }
+        return g_CurrentLockOwnerId;
+    }
+
+    void MonitorWaiter::SetMonitor(ObjectMonitor *monitor) {
+        this->lock->Lock();
+        this->monitor = monitor;
+        this->lock->Unlock();
+    }
+
+    void MonitorWaiter::Interrupt() {
+        this->interrupted.store(true);
+
+        // The waiter keeps the object (and thus its monitor) alive until it unregisters the monitor, which can't happen meanwhile
+        this->lock->Lock();
+        if(this->monitor != nullptr) {
+            this->monitor->WakeWaiters();
+        }
+        this->lock->Unlock();
+    }
+
+    void ObjectMonitor::Enter(const u32 self_id) {
+        this->lock->Lock();
+        if(this->owner_id == self_id) {
+            this->recursion_count++;
+        }
+        else {
+            while(this->owner_id != 0) {
+                this->entry_cond_var->Wait(this->lock);
+            }
+            this->owner_id = self_id;
+            this->recursion_count = 1;
+        }
+        this->lock->Unlock();
+    }
+
+    bool ObjectMonitor::Leave(const u32 self_id) {
+        this->lock->Lock();
+        if(this->owner_id != self_id) {
+            this->lock->Unlock();
+            return false;
+        }
+        this->recursion_count--;
+        if(this->recursion_count == 0) {
+            this->owner_id = 0;
+            this->entry_cond_var->Notify();
+        }
+        this->lock->Unlock();
+        return true;
+    }
+
+    bool ObjectMonitor::Wait(const u32 self_id, const type::Long ms, MonitorWaiter *waiter) {
+        // Registered before checking the interrupt flag under the lock, so that an interrupt is either seen here or wakes us up
+        if(waiter != nullptr) {
+            waiter->SetMonitor(this);
+        }
+
+        this->lock->Lock();
+        if(this->owner_id != self_id) {
+            this->lock->Unlock();
+            if(waiter != nullptr) {
+                waiter->SetMonitor(nullptr);
+            }
+            return false;
+        }
+
+        // Fully release the monitor while waiting, then take it back with the same recursion count
+        const auto saved_count = this->recursion_count;
+        this->owner_id = 0;
+        this->recursion_count = 0;
+        this->entry_cond_var->Notify();
+        if((waiter == nullptr) || !waiter->IsInterrupted()) {
+            if(ms > 0) {
+                this->wait_cond_var->WaitFor(this->lock, ms);
+            }
+            else {
+                this->wait_cond_var->Wait(this->lock);
+            }
+        }
+        while(this->owner_id != 0) {
+            this->entry_cond_var->Wait(this->lock);
+        }
+        this->owner_id = self_id;
+        this->recursion_count = saved_count;
+        this->lock->Unlock();
+
+        if(waiter != nullptr) {
+            waiter->SetMonitor(nullptr);
+        }
+        return true;
+    }
+
+    bool ObjectMonitor::Notify(const u32 self_id) {
+        this->lock->Lock();
+        const auto is_owner = this->owner_id == self_id;
+        if(is_owner) {
+            this->wait_cond_var->Notify();
+        }
+        this->lock->Unlock();
+        return is_owner;
+    }
+
+    bool ObjectMonitor::NotifyAll(const u32 self_id) {
+        this->lock->Lock();
+        const auto is_owner = this->owner_id == self_id;
+        if(is_owner) {
+            this->wait_cond_var->NotifyAll();
+        }
+        this->lock->Unlock();
+        return is_owner;
+    }
+
+    void ObjectMonitor::WakeWaiters() {
+        this->lock->Lock();
+        this->wait_cond_var->NotifyAll();
+        this->lock->Unlock();
+    }
+
+    bool ObjectMonitor::IsOwnedBy(const u32 self_id) {
+        this->lock->Lock();
+        const auto is_owner = this->owner_id == self_id;
+        this->lock->Unlock();
+        return is_owner;
+    }
+
+    ObjectLock::~ObjectLock() {
+        const auto word = this->lock_word.load(std::memory_order_acquire);
+        if(IsInflatedWord(word)) {
+            delete GetWordMonitor(word);
+        }
+    }
+
+    ObjectMonitor *ObjectLock::Inflate() {
+        auto word = this->lock_word.load(std::memory_order_acquire);
+        while(true) {
+            if(IsInflatedWord(word)) {
+                return GetWordMonitor(word);
+            }
+
+            // The monitor takes over the current thin lock state, whoever owns it
+            auto monitor = new ObjectMonitor(GetThinOwnerId(word), GetThinCount(word));
+            const auto inflated_word = static_cast<u64>(reinterpret_cast<uintptr_t>(monitor)) | InflatedBit;
+            if(this->lock_word.compare_exchange_strong(word, inflated_word, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return monitor;
+            }
+            delete monitor;
+        }
+    }
+
+    void ObjectLock::Enter() {
+        const auto self_id = GetCurrentLockOwnerId();
+        auto word = this->lock_word.load(std::memory_order_relaxed);
+        while(true) {
+            if(word == 0) {
+                if(this->lock_word.compare_exchange_weak(word, MakeThinWord(self_id, 1), std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+            else if(IsInflatedWord(word)) {
+                GetWordMonitor(word)->Enter(self_id);
+                return;
+            }
+            else if((GetThinOwnerId(word) == self_id) && (GetThinCount(word) < MaxThinRecursionCount)) {
+                // Still a CAS, since a contending thread might be inflating the word at the same time
+                if(this->lock_word.compare_exchange_weak(word, word + ThinCountUnit, std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+            else {
+                // Contended (or recursion overflow), block on a full monitor
+                this->Inflate()->Enter(self_id);
+                return;
+            }
+        }
+    }
+
+    bool ObjectLock::TryEnter() {
+        const auto self_id = GetCurrentLockOwnerId();
+        auto word = this->lock_word.load(std::memory_order_relaxed);
+        while(true) {
+            if(word == 0) {
+                if(this->lock_word.compare_exchange_weak(word, MakeThinWord(self_id, 1), std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            else if(!IsInflatedWord(word) && (GetThinOwnerId(word) == self_id) && (GetThinCount(word) < MaxThinRecursionCount)) {
+                if(this->lock_word.compare_exchange_weak(word, word + ThinCountUnit, std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            else {
+                return false;
+            }
+        }
+    }
+
+    bool ObjectLock::Leave() {
+        const auto self_id = GetCurrentLockOwnerId();
+        auto word = this->lock_word.load(std::memory_order_relaxed);
+        while(true) {
+            if(IsInflatedWord(word)) {
+                return GetWordMonitor(word)->Leave(self_id);
+            }
+            if((word == 0) || (GetThinOwnerId(word) != self_id)) {
+                return false;
+            }
+
+            const auto new_word = (GetThinCount(word) > 1) ? (word - ThinCountUnit) : 0;
+            if(this->lock_word.compare_exchange_weak(word, new_word, std::memory_order_release, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    bool ObjectLock::Wait(const type::Long ms, MonitorWaiter *waiter) {
+        const auto self_id = GetCurrentLockOwnerId();
+        const auto word = this->lock_word.load(std::memory_order_acquire);
+        if(IsInflatedWord(word)) {
+            return GetWordMonitor(word)->Wait(self_id, ms, waiter);
+        }
+        if((word == 0) || (GetThinOwnerId(word) != self_id)) {
+            return false;
+        }
+
+        // Waiting always requires a full monitor
+        return this->Inflate()->Wait(self_id, ms, waiter);
+    }
+
+    bool ObjectLock::Notify() {
+        const auto self_id = GetCurrentLockOwnerId();
+        const auto word = this->lock_word.load(std::memory_order_acquire);
+        if(IsInflatedWord(word)) {
+            return GetWordMonitor(word)->Notify(self_id);
+        }
+
+        // Nobody can be waiting on a thin lock, so there is nothing to wake
+        return (word != 0) && (GetThinOwnerId(word) == self_id);
+    }
+
+    bool ObjectLock::NotifyAll() {
+        const auto self_id = GetCurrentLockOwnerId();
+        const auto word = this->lock_word.load(std::memory_order_acquire);
+        if(IsInflatedWord(word)) {
+            return GetWordMonitor(word)->NotifyAll(self_id);
+        }
+
+        return (word != 0) && (GetThinOwnerId(word) == self_id);
+    }
+
+    bool ObjectLock::IsHeldByCurrentThread() {
+        const auto self_id = GetCurrentLockOwnerId();
+        const auto word = this->lock_word.load(std::memory_order_acquire);
+        if(IsInflatedWord(word)) {
+            return GetWordMonitor(word)->IsOwnedBy(self_id);
+        }
+
+        return (word != 0) && (GetThinOwnerId(word) == self_id);
+    }
+
+}
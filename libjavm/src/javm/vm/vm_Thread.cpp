@@ -1,19 +1,37 @@
 #include <javm/javm_VM.hpp>
+#include <chrono>
 
 namespace javm::vm {
 
     namespace {
 
-        std::vector<Ptr<ThreadAccessor>> g_ThreadList;
-        Monitor g_ThreadListLock;
+        // Accessor of the current thread, valid while its instance's thread list stays unchanged
+        struct CurrentThreadCache {
+            rt::VMInstance *instance;
+            u64 thread_list_version;
+            Ptr<ThreadAccessor> accessor;
+        };
 
-        Ptr<ThreadAccessor> g_ThrownThread;
-        Ptr<Variable> g_ThrownThrowable;
-        Monitor g_ThrownLock;
-        bool g_ThrownNotified = true;
+        thread_local CurrentThreadCache g_CurrentThreadCache = {};
+
+        // Versions are unique across instances, so that a cache never matches another instance allocated at the same address
+        std::atomic<u64> g_NextThreadListVersion(1);
+
+        // Must be called with the thread list locked
+        inline void NotifyThreadListChanged(rt::VMInstance &instance) {
+            instance.thread_list_version.store(g_NextThreadListVersion.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+        }
 
         void ThreadEntrypoint(void *thread_ptr) {
             auto thread_ref = reinterpret_cast<native::Thread*>(thread_ptr);
+            rt::EnterInstance(thread_ref->GetInstance());
+
+            // Registered as blocked by the creator thread, now it starts running Java code (this also caches the accessor)
+            auto self_accessor = GetCurrentThread();
+            if(self_accessor) {
+                self_accessor->LeaveBlockedState();
+            }
+
             auto thread_v = thread_ref->GetThreadVariable();
             auto thread_obj = thread_v->GetAs<type::ClassInstance>();
 
@@ -27,11 +45,50 @@ namespace javm::vm {
                 RegisterThrown(res.var);
             }
             
+            // Don't hold back safepoints while leaving
+            if(self_accessor) {
+                self_accessor->EnterBlockedState();
+            }
             UnregisterSelf();
+            rt::ExitInstance();
         }
 
     }
 
+    void ThreadAccessor::StopAtSafepoint() {
+        ScopedMonitorLock lk(this->safepoint.monitor);
+
+        this->state.store(ThreadState::Stopped);
+        this->safepoint.monitor.NotifyAll();
+        while(this->safepoint.requested.load()) {
+            this->safepoint.monitor.Wait();
+        }
+        this->state.store(ThreadState::Running);
+    }
+
+    void ThreadAccessor::EnterBlockedState() {
+        this->state.store(ThreadState::Blocked);
+        if(this->safepoint.requested.load()) {
+            // Let the stopping thread know right away
+            ScopedMonitorLock lk(this->safepoint.monitor);
+            this->safepoint.monitor.NotifyAll();
+        }
+    }
+
+    void ThreadAccessor::LeaveBlockedState() {
+        // Stores and loads are sequentially consistent: either we see the request here, or the stopping thread sees us running
+        this->state.store(ThreadState::Running);
+        if(this->safepoint.requested.load()) {
+            this->StopAtSafepoint();
+        }
+    }
+
+    void ThreadAccessor::Interrupt() {
+        this->waiter.Interrupt();
+        this->parker->Unpark();
+        this->sleep_parker->Unpark();
+    }
+
     String ThreadAccessor::GetThreadName() {
         auto thread_v = this->thread_obj->GetThreadVariable();
         auto thread_obj = thread_v->GetAs<type::ClassInstance>();
@@ -86,36 +143,78 @@ namespace javm::vm {
         }
     }
 
-    Ptr<ThreadAccessor> RegisterThread(Ptr<native::Thread> thread_obj) {
-        ScopedMonitorLock lk(g_ThreadListLock);
+    Ptr<ThreadAccessor> RegisterThread(Ptr<native::Thread> thread_obj, const ThreadState initial_state) {
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
 
-        auto accessor = ptr::New<ThreadAccessor>(thread_obj);
-        g_ThreadList.push_back(accessor);
+        auto accessor = ptr::New<ThreadAccessor>(thread_obj, instance.safepoint, initial_state);
+        instance.thread_list.push_back(accessor);
+        NotifyThreadListChanged(instance);
+
+        // Threads registering themselves get it cached right away, others do once they start running (see ThreadEntrypoint)
+        if(thread_obj->GetHandle() == native::GetCurrentThreadHandle()) {
+            g_CurrentThreadCache = { &instance, instance.thread_list_version.load(std::memory_order_relaxed), accessor };
+        }
         return accessor;
     }
 
     void UnregisterThread(Ptr<native::Thread> thread_obj) {
-        ScopedMonitorLock lk(g_ThreadListLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
 
-        g_ThreadList.erase(std::remove_if(g_ThreadList.begin(), g_ThreadList.end(), [&](const Ptr<ThreadAccessor> &accessor) -> bool {
+        instance.thread_list.erase(std::remove_if(instance.thread_list.begin(), instance.thread_list.end(), [&](const Ptr<ThreadAccessor> &accessor) -> bool {
             return accessor->GetThreadHandle() == thread_obj->GetHandle();
-        }), g_ThreadList.end());
+        }), instance.thread_list.end());
+        NotifyThreadListChanged(instance);
     }
 
     void UnregisterSelf() {
-        ScopedMonitorLock lk(g_ThreadListLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
 
         const auto cur_handle = native::GetCurrentThreadHandle();
-        g_ThreadList.erase(std::remove_if(g_ThreadList.begin(), g_ThreadList.end(), [&](const Ptr<ThreadAccessor> &accessor) -> bool {
+        instance.thread_list.erase(std::remove_if(instance.thread_list.begin(), instance.thread_list.end(), [&](const Ptr<ThreadAccessor> &accessor) -> bool {
             return accessor->GetThreadHandle() == cur_handle;
-        }), g_ThreadList.end());
+        }), instance.thread_list.end());
+        NotifyThreadListChanged(instance);
+        g_CurrentThreadCache = {};
+    }
+
+    void UnregisterAllThreads() {
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
+
+        instance.thread_list.clear();
+        NotifyThreadListChanged(instance);
+    }
+
+    Ptr<ThreadAccessor> GetCurrentThread() {
+        auto &instance = rt::GetCurrentInstance();
+        auto &cache = g_CurrentThreadCache;
+        if((cache.instance == &instance) && (cache.thread_list_version == instance.thread_list_version.load(std::memory_order_acquire))) {
+            return cache.accessor;
+        }
+
+        ScopedMonitorLock lk(instance.thread_list_lock);
+        const auto cur_handle = native::GetCurrentThreadHandle();
+        Ptr<ThreadAccessor> cur_accessor;
+        for(const auto &accessor: instance.thread_list) {
+            if(accessor->GetThreadHandle() == cur_handle) {
+                cur_accessor = accessor;
+                break;
+            }
+        }
+        // Unregistered threads get cached too (as nullptr)
+        cache = { &instance, instance.thread_list_version.load(std::memory_order_relaxed), cur_accessor };
+        return cur_accessor;
     }
 
     Ptr<Variable> GetCurrentThreadVariable() {
-        ScopedMonitorLock lk(g_ThreadListLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
 
         const auto cur_handle = native::GetCurrentThreadHandle();
-        for(const auto &accessor: g_ThreadList) {
+        for(const auto &accessor: instance.thread_list) {
             if(accessor->GetThreadHandle() == cur_handle) {
                 return accessor->GetThreadVariable();
             }
@@ -124,9 +223,10 @@ namespace javm::vm {
     }
 
     Ptr<ThreadAccessor> GetThreadByHandle(const native::ThreadHandle handle) {
-        ScopedMonitorLock lk(g_ThreadListLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
 
-        for(const auto &accessor: g_ThreadList) {
+        for(const auto &accessor: instance.thread_list) {
             if(accessor->GetThreadHandle() == handle) {
                 return accessor;
             }
@@ -134,74 +234,153 @@ namespace javm::vm {
         return nullptr;
     }
 
+    Ptr<ThreadAccessor> GetThreadByVariable(Ptr<Variable> thread_v) {
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
+
+        // Threads are registered before they start running (and before eetop is set), so look them up by their Thread object
+        for(const auto &accessor: instance.thread_list) {
+            if(IsSameObject(accessor->GetThreadVariable(), thread_v)) {
+                return accessor;
+            }
+        }
+        return nullptr;
+    }
+
     u32 GetThreadCount() {
-        ScopedMonitorLock lk(g_ThreadListLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thread_list_lock);
 
-        return g_ThreadList.size();
+        return instance.thread_list.size();
     }
 
     void RegisterAndStartThread(Ptr<Variable> thread_var) {
         auto thread = native::CreateThread();
         thread->SetThreadVariable(thread_var);
+        thread->SetInstance(rt::GetCurrentInstancePtr());
 
         RegisterThread(thread);
         thread->Start(&ThreadEntrypoint);
     }
 
+    bool StopOtherThreads(const u32 timeout_ms) {
+        auto &instance = rt::GetCurrentInstance();
+        auto &safepoint = instance.safepoint;
+        ScopedMonitorLock lk(safepoint.monitor);
+
+        // Somebody else is already stopping the world (we will stop for them at our next safepoint)
+        bool expected = false;
+        if(!safepoint.requested.compare_exchange_strong(expected, true)) {
+            return false;
+        }
+
+        const auto self_handle = native::GetCurrentThreadHandle();
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while(true) {
+            auto all_stopped = true;
+            {
+                ScopedMonitorLock list_lk(instance.thread_list_lock);
+                for(const auto &accessor: instance.thread_list) {
+                    if((accessor->GetThreadHandle() != self_handle) && (accessor->GetState() == ThreadState::Running)) {
+                        all_stopped = false;
+                        break;
+                    }
+                }
+            }
+            if(all_stopped) {
+                return true;
+            }
+
+            // Threads running native code (or waiting on VM-internal locks) never reach a safepoint, so don't wait for them forever
+            if(std::chrono::steady_clock::now() >= deadline) {
+                safepoint.requested.store(false);
+                safepoint.monitor.NotifyAll();
+                return false;
+            }
+            safepoint.monitor.WaitFor(1);
+        }
+    }
+
+    void ResumeOtherThreads() {
+        auto &safepoint = rt::GetCurrentInstance().safepoint;
+        ScopedMonitorLock lk(safepoint.monitor);
+
+        safepoint.requested.store(false);
+        safepoint.monitor.NotifyAll();
+    }
+
+    void EnterObjectLock(ObjectLock &lock) {
+        if(lock.TryEnter()) {
+            return;
+        }
+
+        // Contended: whoever owns the lock might be the one trying to stop the world
+        ScopedBlockedState blocked(GetCurrentThread());
+        lock.Enter();
+    }
+
     void RegisterThrown(Ptr<Variable> throwable_v) {
-        ScopedMonitorLock lk(g_ThrownLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thrown_lock);
 
-        g_ThrownThread = GetCurrentThread();
-        g_ThrownThrowable = throwable_v;
-        g_ThrownNotified = false;
+        instance.thrown_thread = GetCurrentThread();
+        instance.thrown_throwable = throwable_v;
+        instance.thrown_notified = false;
+        instance.is_thrown.store(ptr::IsValid(instance.thrown_throwable), std::memory_order_release);
     }
 
     Ptr<ThreadAccessor> RetrieveThrownThread() {
-        ScopedMonitorLock lk(g_ThrownLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thrown_lock);
 
-        auto thrown_accessor = g_ThrownThread;
-        g_ThrownThread = nullptr;
+        auto thrown_accessor = instance.thrown_thread;
+        instance.thrown_thread = nullptr;
         return thrown_accessor;
     }
 
     Ptr<Variable> RetrieveThrownThrowable() {
-        ScopedMonitorLock lk(g_ThrownLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thrown_lock);
 
-        auto thrown_throwable_v = g_ThrownThrowable;
-        g_ThrownThrowable = nullptr;
+        auto thrown_throwable_v = instance.thrown_throwable;
+        instance.thrown_throwable = nullptr;
+        instance.is_thrown.store(false, std::memory_order_release);
         return thrown_throwable_v;
     }
 
     void ResetThrown() {
-        ScopedMonitorLock lk(g_ThrownLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thrown_lock);
 
-        g_ThrownThread = nullptr;
-        g_ThrownThrowable = nullptr;
-        g_ThrownNotified = true;
+        instance.thrown_thread = nullptr;
+        instance.thrown_throwable = nullptr;
+        instance.thrown_notified = true;
+        instance.is_thrown.store(false, std::memory_order_release);
     }
 
     bool IsThrown() {
-        ScopedMonitorLock lk(g_ThrownLock);
-
-        return ptr::IsValid(g_ThrownThrowable);
+        return rt::GetCurrentInstance().is_thrown.load(std::memory_order_acquire);
     }
 
     bool IsThrownNotified() {
-        ScopedMonitorLock lk(g_ThrownLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thrown_lock);
 
-        return g_ThrownNotified;
+        return instance.thrown_notified;
     }
 
     void NotifyThrownNotified() {
-        ScopedMonitorLock lk(g_ThrownLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thrown_lock);
 
-        g_ThrownNotified = true;
+        instance.thrown_notified = true;
     }
 
     ExecutionResult ThrowAlreadyThrown() {
-        ScopedMonitorLock lk(g_ThrownLock);
+        auto &instance = rt::GetCurrentInstance();
+        ScopedMonitorLock lk(instance.thrown_lock);
 
-        return ThrowExisting(g_ThrownThrowable, false);
+        return ThrowExisting(instance.thrown_throwable, false);
     }
 
 }
\ No newline at end of file
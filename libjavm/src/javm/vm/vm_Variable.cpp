@@ -2,50 +2,73 @@
 
 namespace javm::vm {
 
-    namespace {
-
-        Ptr<Variable> g_NullObjectVariable;
-        std::vector<Ptr<Variable>> g_CachedClassTypeVariableList;
-
-        Ptr<Variable> TryFindCachedClassTypeVariable(const String &class_name) {
-            for(auto &class_v: g_CachedClassTypeVariableList) {
-                auto class_obj = class_v->GetAs<type::ClassInstance>();
-                auto name_v = class_obj->GetField(u"name", u"Ljava/lang/String;");
-                const auto name = jutil::GetStringValue(name_v);
-                if(class_name == name) {
-                    return class_v;
-                }
-            }
-
-            return nullptr;
-        }
-
-    }
-
     Ptr<Variable> NewClassTypeVariable(Ptr<ref::ReflectionType> ref_type) {
-        const auto class_name = ref_type->GetTypeName();
-        auto cached_class_v = TryFindCachedClassTypeVariable(class_name);
+        // Every type has a single reflection type, which keeps its class variable once created
+        auto cached_class_v = ref_type->GetClassVariable();
         if(cached_class_v) {
             return cached_class_v;
         }
 
+        const auto class_name = ref_type->GetTypeName();
         auto class_class_type = rt::LocateClassType(u"java/lang/Class");
 
         // No need to call ctor, we set classLoader to null manually to avoid having to execute code
         // TODO: actually set a valid classLoader?
-        auto class_v = NewClassVariable(class_class_type);
-        auto class_obj = class_v->GetAs<type::ClassInstance>();
+        auto new_class_v = NewClassVariable(class_class_type);
+        auto class_obj = new_class_v->GetAs<type::ClassInstance>();
 
         class_obj->SetField(u"classLoader", u"Ljava/lang/ClassLoader;", MakeNull());
 
         auto class_name_v = jutil::NewString(class_name);
         class_obj->SetField(u"name", u"Ljava/lang/String;", class_name_v);
 
-        // We've created a new class type variable, cache it
-        g_CachedClassTypeVariableList.push_back(class_v);
+        // Another thread might have created it meanwhile, only one of them is kept
+        auto class_v = ref_type->TrySetClassVariable(new_class_v);
+        if(class_v == new_class_v) {
+            ref::RegisterClassVariable(ref_type, class_v);
+        }
         return class_v;
     }
 
+    Ptr<Variable> AtomicLoadSlot(VariableSlot &slot, const VariableType type) {
+        auto cur_var = slot.Load();
+        if(cur_var) {
+            return cur_var;
+        }
+
+        auto default_var = NewDefaultVariable(type);
+        if(slot.CompareExchange(cur_var, default_var)) {
+            return default_var;
+        }
+        return cur_var;
+    }
+
+    bool IsSameObject(Ptr<Variable> var_a, Ptr<Variable> var_b) {
+        if(ptr::Equal(var_a, var_b)) {
+            return true;
+        }
+        if(var_a->GetType() != var_b->GetType()) {
+            return false;
+        }
+        if(var_a->CanGetAs<VariableType::ClassInstance>()) {
+            return var_a->GetAs<type::ClassInstance>() == var_b->GetAs<type::ClassInstance>();
+        }
+        if(var_a->CanGetAs<VariableType::Array>()) {
+            return var_a->GetAs<type::Array>() == var_b->GetAs<type::Array>();
+        }
+        return var_a->IsNull();
+    }
+
+    ObjectLock *GetObjectLock(Ptr<Variable> var) {
+        if(var->CanGetAs<VariableType::ClassInstance>()) {
+            return &var->GetAs<type::ClassInstance>()->GetLock();
+        }
+        else if(var->CanGetAs<VariableType::Array>()) {
+            return &var->GetAs<type::Array>()->GetLock();
+        }
+        return nullptr;
+    }
+
     String FormatVariableType(Ptr<Variable> var) {
         if(!var) {
             return u"<invalid>";